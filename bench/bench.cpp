@@ -0,0 +1,319 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace bench {
+
+static const double PI = 3.14159265358979323846;
+
+uint64_t Rng::next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double Rng::uniform() {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double Rng::uniform(double lo, double hi) {
+    return lo + (hi - lo) * uniform();
+}
+
+uint64_t Rng::below(uint64_t bound) {
+    return next() % bound;
+}
+
+// Box-Muller 变换
+double Rng::normal() {
+    double u = 1.0 - uniform();
+    double v = uniform();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * v);
+}
+
+const char* distributionName(Distribution distribution) {
+    switch (distribution) {
+        case Uniform: return "uniform";
+        case Clustered: return "clustered";
+        case CollinearHeavy: return "collinear";
+        case OnCircle: return "circle";
+    }
+    return "unknown";
+}
+
+static const double EXTENT = 1e6;  // 点坐标范围 [0, EXTENT)
+
+std::vector<XY> generatePoints(Distribution distribution, size_t n, uint64_t seed) {
+    Rng rng(seed);
+    std::vector<XY> points(n);
+    switch (distribution) {
+        case Uniform:
+            for (size_t i = 0; i < n; i++) points[i] = {rng.uniform(0, EXTENT), rng.uniform(0, EXTENT)};
+            break;
+        case Clustered: {
+            std::vector<XY> centers(32);
+            for (size_t i = 0; i < centers.size(); i++) {
+                centers[i] = {rng.uniform(0, EXTENT), rng.uniform(0, EXTENT)};
+            }
+            for (size_t i = 0; i < n; i++) {
+                const XY& c = centers[rng.below(centers.size())];
+                points[i] = {c.x + rng.normal() * EXTENT / 100, c.y + rng.normal() * EXTENT / 100};
+            }
+            break;
+        }
+        case CollinearHeavy: {
+            // 3/4 的点在 16 条水平线的整数位置上，其余点坐标带小数部分，所有点互不重合
+            size_t onLines = n / 4 * 3;
+            for (size_t i = 0; i < onLines; i++) {
+                points[i] = {static_cast<double>(i / 16), static_cast<double>(i % 16) * (EXTENT / 16)};
+            }
+            double width = std::max(1.0, static_cast<double>(onLines / 16));
+            for (size_t i = onLines; i < n; i++) {
+                points[i] = {rng.uniform(0, width) + 0.25, rng.uniform(0, EXTENT) + 0.25};
+            }
+            // 打乱顺序，避免输入本身有序
+            for (size_t i = n; i > 1; i--) std::swap(points[i - 1], points[rng.below(i)]);
+            break;
+        }
+        case OnCircle:
+            for (size_t i = 0; i < n; i++) {
+                double angle = rng.uniform(0, 2 * PI);
+                points[i] = {EXTENT / 2 + std::cos(angle) * EXTENT / 2, EXTENT / 2 + std::sin(angle) * EXTENT / 2};
+            }
+            break;
+    }
+    return points;
+}
+
+std::vector<XY> generatePolygon(size_t n, uint64_t seed) {
+    Rng rng(seed);
+    std::vector<double> angles(n);
+    for (size_t i = 0; i < n; i++) angles[i] = rng.uniform(0, 2 * PI);
+    std::sort(angles.begin(), angles.end());
+    std::vector<XY> polygon(n);
+    for (size_t i = 0; i < n; i++) {
+        double radius = rng.uniform(0.5, 1.0) * EXTENT / 2;
+        polygon[i] = {EXTENT / 2 + std::cos(angles[i]) * radius, EXTENT / 2 + std::sin(angles[i]) * radius};
+    }
+    return polygon;
+}
+
+std::vector<Box> generateRectangles(size_t n, uint64_t seed) {
+    Rng rng(seed);
+    std::vector<Box> boxes(n);
+    for (size_t i = 0; i < n; i++) {
+        int x = static_cast<int>(rng.below(1u << 30)), y = static_cast<int>(rng.below(1u << 30));
+        int w = 1 + static_cast<int>(rng.below(1u << 20)), h = 1 + static_cast<int>(rng.below(1u << 20));
+        boxes[i] = {x, y, x + w, y + h};
+    }
+    return boxes;
+}
+
+std::vector<SegmentXY> generateSegments(size_t n, uint64_t seed) {
+    Rng rng(seed);
+    std::vector<SegmentXY> segments(n);
+    for (size_t i = 0; i < n; i++) {
+        XY a = {rng.uniform(0, EXTENT), rng.uniform(0, EXTENT)};
+        XY b = {a.x + rng.uniform(-EXTENT / 20, EXTENT / 20), a.y + rng.uniform(-EXTENT / 20, EXTENT / 20)};
+        segments[i] = {a, b};
+    }
+    return segments;
+}
+
+std::vector<LineCoef> generateLines(size_t n, uint64_t seed) {
+    Rng rng(seed);
+    std::vector<LineCoef> lines(n);
+    for (size_t i = 0; i < n; i++) {
+        // 约 1% 的直线与前一条平行
+        if (i % 2 == 1 && rng.below(100) == 0) {
+            double k = rng.uniform(0.5, 2.0);
+            lines[i] = {lines[i - 1].a * k, lines[i - 1].b * k, rng.uniform(-1, 1)};
+        } else {
+            lines[i] = {rng.uniform(-1, 1), rng.uniform(-1, 1), rng.uniform(-1, 1)};
+        }
+    }
+    return lines;
+}
+
+// 重置并读取进程的峰值常驻内存（KB）
+// Linux 上向 /proc/self/clear_refs 写入 5 可以清零 VmHWM，其他平台只能读取整个进程的峰值
+static void resetPeakRss() {
+#ifdef __linux__
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file != nullptr) {
+        fputs("5", file);
+        fclose(file);
+    }
+#endif
+}
+
+static long readPeakRss() {
+#ifdef __linux__
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file != nullptr) {
+        char line[256];
+        long value = -1;
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            if (strncmp(line, "VmHWM:", 6) == 0) value = atol(line + 6);
+        }
+        fclose(file);
+        if (value >= 0) return value;
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+Context::Context() : seed(1), minTime(0.2) {
+    for (size_t n = 1000; n <= 10000000; n *= 10) sizes.push_back(n);
+}
+
+bool Context::enabled(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+uint64_t Context::seedFor(const std::string& name, size_t size) const {
+    uint64_t h = seed;
+    for (size_t i = 0; i < name.size(); i++) h = h * 1099511628211ULL + static_cast<unsigned char>(name[i]);
+    Rng rng(h ^ (size * 0x9e3779b97f4a7c15ULL));
+    return rng.next();
+}
+
+void Context::measure(const std::string& name, const std::string& workload, size_t size, double ops,
+                      const std::function<void()>& setup, const std::function<double()>& run) {
+    typedef std::chrono::steady_clock Clock;
+    std::cerr << name << " " << workload << " n=" << size << std::flush;
+
+    resetPeakRss();
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    double total = 0, checksum = 0;
+    int repetitions = 0;
+    try {
+        do {
+            setup();
+            Clock::time_point start = Clock::now();
+            checksum = run();
+            total += std::chrono::duration<double>(Clock::now() - start).count();
+            repetitions++;
+        } while (total < minTime);
+    } catch (...) {
+        std::cout.rdbuf(saved);
+        throw;
+    }
+    std::cout.rdbuf(saved);
+
+    Result result;
+    result.name = name;
+    result.workload = workload;
+    result.size = size;
+    result.ops = ops;
+    result.repetitions = repetitions;
+    result.seconds = total / repetitions;
+    result.peakRssKb = readPeakRss();
+    result.checksum = checksum;
+    records.push_back(result);
+    std::cerr << "  " << result.seconds * 1e3 << " ms" << std::endl;
+}
+
+} // namespace bench
+
+static void writeJson(std::ostream& out, const bench::Context& context) {
+    out << "{\n  \"seed\": " << context.seed << ",\n  \"results\": [";
+    const std::vector<bench::Result>& results = context.results();
+    char buffer[512];
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench::Result& r = results[i];
+        snprintf(buffer, sizeof(buffer),
+                 "%s\n    {\"name\": \"%s\", \"workload\": \"%s\", \"size\": %zu, \"ops\": %.0f, "
+                 "\"repetitions\": %d, \"seconds\": %.9g, \"ns_per_op\": %.6g, \"throughput\": %.6g, "
+                 "\"peak_rss_kb\": %ld, \"checksum\": %.17g}",
+                 i == 0 ? "" : ",", r.name.c_str(), r.workload.c_str(), r.size, r.ops, r.repetitions, r.seconds,
+                 r.seconds * 1e9 / r.ops, r.ops / r.seconds, r.peakRssKb, r.checksum);
+        out << buffer;
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void usage(const char* program) {
+    std::cerr << "usage: " << program << " [--min-size N] [--max-size N] [--seed S] [--filter NAME]"
+              << " [--min-time SECONDS] [--out FILE]\n"
+              << "  规模从 min-size 到 max-size 每次乘以 10，默认 1000 到 10000000，结果以 JSON 输出\n";
+}
+
+int main(int argc, char* argv[]) {
+    bench::Context context;
+    size_t minSize = 1000, maxSize = 10000000;
+    std::string outPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--min-size") {
+            minSize = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--max-size") {
+            maxSize = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--seed") {
+            context.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--filter") {
+            context.filter = value;
+        } else if (arg == "--min-time") {
+            context.minTime = atof(value.c_str());
+        } else if (arg == "--out") {
+            outPath = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    context.sizes.clear();
+    for (size_t n = std::max<size_t>(minSize, 1); n <= maxSize; n *= 10) context.sizes.push_back(n);
+
+    bench::runConvexHull(context);
+    bench::runDynamicHull(context);
+    bench::runDelaunay(context);
+    bench::runScanLine(context);
+    bench::runSegments(context);
+    bench::runPointInPolygon(context);
+    bench::runPolygonArea(context);
+    bench::runPointLine(context);
+    bench::runRTree(context);
+    bench::runPointLocator(context);
+    bench::runPointCloud(context);
+    bench::runFindIntersection(context);
+
+    if (outPath.empty()) {
+        writeJson(std::cout, context);
+    } else {
+        std::ofstream out(outPath.c_str());
+        if (!out) {
+            std::cerr << "cannot open " << outPath << "\n";
+            return 1;
+        }
+        writeJson(out, context);
+    }
+    return 0;
+}
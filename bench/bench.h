@@ -0,0 +1,114 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 基准测试公共部分：可复现的数据生成器和计时工具
+// 生成器只输出独立的坐标类型，由各测试文件转换为被测接口的输入
+namespace bench {
+
+struct XY {
+    double x, y;
+};
+
+struct Box {
+    int x1, y1, x2, y2;
+};
+
+struct SegmentXY {
+    XY a, b;
+};
+
+// 直线 a * x + b * y = c
+struct LineCoef {
+    double a, b, c;
+};
+
+// splitmix64 随机数生成器，不依赖标准库分布的实现，同一种子在所有平台上生成相同的数据
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state(seed) {}
+
+    uint64_t next();
+    double uniform();                     // [0, 1)
+    double uniform(double lo, double hi); // [lo, hi)
+    uint64_t below(uint64_t bound);       // [0, bound)
+    double normal();                      // 标准正态分布
+
+private:
+    uint64_t state;
+};
+
+enum Distribution {
+    Uniform,         // 正方形内均匀分布
+    Clustered,       // 若干高斯簇
+    CollinearHeavy,  // 大部分点落在少数几条水平线上
+    OnCircle         // 全部在同一个圆上
+};
+
+const char* distributionName(Distribution distribution);
+
+std::vector<XY> generatePoints(Distribution distribution, size_t n, uint64_t seed);
+// 星形的简单多边形，按逆时针排列
+std::vector<XY> generatePolygon(size_t n, uint64_t seed);
+std::vector<Box> generateRectangles(size_t n, uint64_t seed);
+std::vector<SegmentXY> generateSegments(size_t n, uint64_t seed);
+std::vector<LineCoef> generateLines(size_t n, uint64_t seed);
+
+struct Result {
+    std::string name;      // 被测函数
+    std::string workload;  // 数据分布
+    size_t size;           // 输入规模
+    double ops;            // 每次运行处理的元素数
+    int repetitions;
+    double seconds;        // 平均每次运行的时间
+    long peakRssKb;        // 测量期间进程的峰值常驻内存
+    double checksum;       // 结果摘要，防止计算被优化掉，也便于比较不同版本的输出
+};
+
+class Context {
+public:
+    Context();
+
+    std::vector<size_t> sizes;
+    uint64_t seed;
+    std::string filter;  // 只运行名称包含该字符串的测试
+    double minTime;      // 每项测试至少运行的总时间（秒）
+
+    bool enabled(const std::string& name) const;
+
+    // 由测试名称和规模派生数据种子，各项测试的数据互不影响
+    uint64_t seedFor(const std::string& name, size_t size) const;
+
+    // 重复执行 setup 和 run 直到总时间达到 minTime，只统计 run 的时间，run 返回校验值
+    // 测量期间丢弃 std::cout 上的调试输出
+    void measure(const std::string& name, const std::string& workload, size_t size, double ops,
+                 const std::function<void()>& setup, const std::function<double()>& run);
+
+    const std::vector<Result>& results() const { return records; }
+
+private:
+    std::vector<Result> records;
+};
+
+// 各组测试，分别定义在包含对应头文件的源文件中
+void runConvexHull(Context& context);
+void runDynamicHull(Context& context);
+void runDelaunay(Context& context);
+void runScanLine(Context& context);
+void runSegments(Context& context);
+void runPointInPolygon(Context& context);
+void runPolygonArea(Context& context);
+void runPointLine(Context& context);
+void runRTree(Context& context);
+void runPointLocator(Context& context);
+void runPointCloud(Context& context);
+void runFindIntersection(Context& context);
+
+} // namespace bench
+
+#endif // BENCH_H
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "convex_hull.h"
+
+namespace bench {
+
+void runConvexHull(Context& context) {
+    const Distribution distributions[] = {Uniform, Clustered, CollinearHeavy, OnCircle};
+    for (size_t d = 0; d < 4; d++) {
+        for (size_t s = 0; s < context.sizes.size(); s++) {
+            size_t n = context.sizes[s];
+            std::vector<XY> xy = generatePoints(distributions[d], n, context.seedFor("convex_hull", n));
+            std::vector<Point> input(n), work;
+            for (size_t i = 0; i < n; i++) input[i] = {xy[i].x, xy[i].y, 0};
+            std::vector<XY>().swap(xy);
+
+            // grahamScan 每处理一个点都输出当前栈，点全在凸包上时为平方复杂度，只测小规模
+            if (context.enabled("grahamScan") && (distributions[d] != OnCircle || n <= 10000)) {
+                context.measure("grahamScan", distributionName(distributions[d]), n, static_cast<double>(n),
+                                [&]() { work = input; },
+                                [&]() { return static_cast<double>(ConvexHull::grahamScan(work).size()); });
+            }
+            if (context.enabled("ConvexHull::compute")) {
+                ConvexHull::Options options;
+                options.preserveInput = false;
+                context.measure("ConvexHull::compute", distributionName(distributions[d]), n, static_cast<double>(n),
+                                [&]() { work = input; },
+                                [&]() { return static_cast<double>(ConvexHull::compute(work, options).size()); });
+            }
+            // 输出敏感模式：凸包点数超过 ceil(log2 n) 时礼品包装中途放弃，回退到单调链，圆上的点最能体现回退的代价
+            if (context.enabled("ConvexHull::compute(outputSensitive)")) {
+                ConvexHull::Options options;
+                options.preserveInput = false;
+                options.outputSensitive = true;
+                context.measure("ConvexHull::compute(outputSensitive)", distributionName(distributions[d]), n,
+                                static_cast<double>(n), [&]() { work = input; },
+                                [&]() { return static_cast<double>(ConvexHull::compute(work, options).size()); });
+            }
+            if (context.enabled("ConvexHull::rotatingCalipers")) {
+                std::vector<Point> hull = ConvexHull::compute(input);
+                context.measure("ConvexHull::rotatingCalipers", distributionName(distributions[d]), n,
+                                static_cast<double>(hull.size()), []() {},
+                                [&]() {
+                                    ConvexHull::Calipers calipers = ConvexHull::rotatingCalipers(hull);
+                                    return calipers.diameter.distance + calipers.width.width + calipers.minArea.area;
+                                });
+            }
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,66 @@
+#include "bench.h"
+#include "delaunay.h"
+
+namespace bench {
+
+// 在 n 个均匀分布的点上做 n 次最近点查询，以及导出 Voronoi 图
+static void runDelaunayQueries(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        uint64_t seed = context.seedFor("delaunay_queries", n);
+        std::vector<XY> xy = generatePoints(Uniform, n, seed);
+        std::vector<Point> sites(n);
+        for (size_t i = 0; i < n; i++) sites[i] = Point(xy[i].x, xy[i].y, static_cast<int>(i));
+        xy = generatePoints(Uniform, n, seed + 1);
+        PointSet queries;
+        queries.reserve(n);
+        for (size_t i = 0; i < n; i++) queries.push_back(Point(xy[i].x, xy[i].y));
+        std::vector<XY>().swap(xy);
+
+        Delaunay delaunay;
+        delaunay.init(static_cast<int>(n), sites.data());
+        if (context.enabled("Delaunay::nearest")) {
+            std::vector<int> ids(n);
+            context.measure("Delaunay::nearest", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                delaunay.nearest(queries, ids.data());
+                                double sum = 0;
+                                for (size_t i = 0; i < n; i++) sum += ids[i];
+                                return sum;
+                            });
+        }
+        if (context.enabled("Delaunay::getVoronoi")) {
+            Delaunay::Voronoi voronoi;
+            context.measure("Delaunay::getVoronoi", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                delaunay.getVoronoi(voronoi);
+                                return static_cast<double>(voronoi.x.size());
+                            });
+        }
+    }
+}
+
+void runDelaunay(Context& context) {
+    runDelaunayQueries(context);
+    if (!context.enabled("Delaunay::init")) return;
+    const Distribution distributions[] = {Uniform, Clustered, CollinearHeavy, OnCircle};
+    for (size_t d = 0; d < 4; d++) {
+        for (size_t s = 0; s < context.sizes.size(); s++) {
+            size_t n = context.sizes[s];
+            std::vector<XY> xy = generatePoints(distributions[d], n, context.seedFor("delaunay", n));
+            std::vector<Point> input(n), work;
+            for (size_t i = 0; i < n; i++) input[i] = Point(xy[i].x, xy[i].y, static_cast<int>(i));
+            std::vector<XY>().swap(xy);
+
+            Delaunay delaunay;
+            context.measure("Delaunay::init", distributionName(distributions[d]), n, static_cast<double>(n),
+                            [&]() { work = input; },
+                            [&]() {
+                                delaunay.init(static_cast<int>(n), work.data());
+                                return static_cast<double>(delaunay.getEdge().size());
+                            });
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,58 @@
+#include "bench.h"
+#include "DynamicHull.h"
+
+namespace bench {
+
+// 逐点插入 n 个点，再做 n 次极点查询；滑动窗口保留最近 n / 10 个点
+void runDynamicHull(Context& context) {
+    const Distribution distributions[] = {Uniform, Clustered, CollinearHeavy, OnCircle};
+    for (size_t d = 0; d < 4; d++) {
+        for (size_t s = 0; s < context.sizes.size(); s++) {
+            size_t n = context.sizes[s];
+            uint64_t seed = context.seedFor("dynamic_hull", n);
+            std::vector<XY> xy = generatePoints(distributions[d], n, seed);
+            std::vector<Point> input(n);
+            for (size_t i = 0; i < n; i++) input[i] = {xy[i].x, xy[i].y, static_cast<int>(i)};
+            std::vector<XY>().swap(xy);
+
+            if (context.enabled("DynamicHull::insert")) {
+                context.measure("DynamicHull::insert", distributionName(distributions[d]), n, static_cast<double>(n),
+                                []() {},
+                                [&]() {
+                                    DynamicHull hull;
+                                    for (size_t i = 0; i < n; i++) hull.insert(input[i]);
+                                    return static_cast<double>(hull.size());
+                                });
+            }
+            if (context.enabled("DynamicHull::extreme")) {
+                DynamicHull hull;
+                for (size_t i = 0; i < n; i++) hull.insert(input[i]);
+                Rng rng(seed + 1);
+                std::vector<XY> directions(n);
+                for (size_t i = 0; i < n; i++) directions[i] = {rng.normal(), rng.normal()};
+                context.measure("DynamicHull::extreme", distributionName(distributions[d]), n, static_cast<double>(n),
+                                []() {},
+                                [&]() {
+                                    double sum = 0;
+                                    for (size_t i = 0; i < n; i++) sum += hull.extreme(directions[i].x, directions[i].y).id;
+                                    return sum;
+                                });
+            }
+            if (context.enabled("SlidingWindowHull::push")) {
+                context.measure("SlidingWindowHull::push", distributionName(distributions[d]), n, static_cast<double>(n),
+                                []() {},
+                                [&]() {
+                                    SlidingWindowHull window(n / 10 + 1);
+                                    double sum = 0;
+                                    for (size_t i = 0; i < n; i++) {
+                                        window.push(input[i]);
+                                        if (i % 64 == 0) sum += window.extreme(1, 0).id;
+                                    }
+                                    return sum;
+                                });
+            }
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,50 @@
+#include "bench.h"
+#include "findIntersection.h"
+
+namespace bench {
+
+void runFindIntersection(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        std::vector<LineCoef> lines = generateLines(n * 2, context.seedFor("find_intersection", n));
+
+        // 第 i 次调用求第 2i 和第 2i + 1 条直线的交点，平行时 findIntersection 抛出异常
+        if (context.enabled("findIntersection")) {
+            context.measure("findIntersection", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                double sum = 0;
+                                for (size_t i = 0; i < n; i++) {
+                                    const LineCoef& l1 = lines[i * 2];
+                                    const LineCoef& l2 = lines[i * 2 + 1];
+                                    try {
+                                        Point p = findIntersection(l1.a, l1.b, l1.c, l2.a, l2.b, l2.c);
+                                        sum += p.x + p.y;
+                                    } catch (const std::runtime_error&) {
+                                        sum += 1;
+                                    }
+                                }
+                                return sum;
+                            });
+        }
+
+        // 同样的直线对按列存放后批量求交，校验值的计算方式与上面相同
+        if (context.enabled("findIntersections")) {
+            std::vector<double> a1(n), b1(n), c1(n), a2(n), b2(n), c2(n), x(n), y(n);
+            std::vector<uint8_t> status(n);
+            for (size_t i = 0; i < n; i++) {
+                a1[i] = lines[i * 2].a, b1[i] = lines[i * 2].b, c1[i] = lines[i * 2].c;
+                a2[i] = lines[i * 2 + 1].a, b2[i] = lines[i * 2 + 1].b, c2[i] = lines[i * 2 + 1].c;
+            }
+            context.measure("findIntersections", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                findIntersections(a1.data(), b1.data(), c1.data(), a2.data(), b2.data(), c2.data(),
+                                                  n, x.data(), y.data(), status.data());
+                                double sum = 0;
+                                for (size_t i = 0; i < n; i++) sum += status[i] == UniqueIntersection ? x[i] + y[i] : 1;
+                                return sum;
+                            });
+        }
+    }
+}
+
+} // namespace bench
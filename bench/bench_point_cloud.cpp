@@ -0,0 +1,61 @@
+#include "bench.h"
+#include "PointCloud.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace bench {
+
+// 同一组点分别存为文本和二进制点云文件，比较读入后遍历一遍坐标的总时间，ops 为点数
+void runPointCloud(Context& context) {
+    const std::string textPath = "bench_point_cloud.txt";
+    const std::string binaryPath = "bench_point_cloud.bin";
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        std::vector<XY> generated = generatePoints(Uniform, n, context.seedFor("point_cloud", n));
+        PointSet points;
+        points.reserve(n);
+        for (size_t i = 0; i < n; i++) points.push_back(Point(generated[i].x, generated[i].y));
+        std::vector<XY>().swap(generated);
+
+        if (context.enabled("PointCloud::write")) {
+            context.measure("PointCloud::write", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                PointCloud::write(binaryPath, points);
+                                return static_cast<double>(n);
+                            });
+        }
+        if (context.enabled("readText")) {
+            {
+                std::ofstream out(textPath);
+                out << std::setprecision(17);
+                for (size_t i = 0; i < n; i++) out << points.x[i] << ' ' << points.y[i] << '\n';
+            }
+            context.measure("readText", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                FILE* file = fopen(textPath.c_str(), "r");
+                                std::vector<Point> loaded;
+                                double x, y, sum = 0;
+                                while (file != nullptr && fscanf(file, "%lf %lf", &x, &y) == 2) loaded.push_back(Point(x, y));
+                                if (file != nullptr) fclose(file);
+                                for (size_t i = 0; i < loaded.size(); i++) sum += loaded[i].x + loaded[i].y;
+                                return sum;
+                            });
+            remove(textPath.c_str());
+        }
+        if (context.enabled("PointCloud::MappedFile")) {
+            PointCloud::write(binaryPath, points);
+            context.measure("PointCloud::MappedFile", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                PointCloud::MappedFile file(binaryPath);
+                                PointView view = file.view();
+                                double sum = 0;
+                                for (size_t i = 0; i < view.size(); i++) sum += view.x(i) + view.y(i);
+                                return sum;
+                            });
+        }
+        remove(binaryPath.c_str());
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,54 @@
+#include "bench.h"
+#include "PointInPolygon.h"
+#include "convex_hull.h"
+
+namespace bench {
+
+// 每个规模对同一个 n 边形做固定次数的查询，ops 为处理的边数
+static const size_t QUERIES = 64;
+
+void runPointInPolygon(Context& context) {
+    using namespace PointInPolygon;
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        uint64_t seed = context.seedFor("point_in_polygon", n);
+        std::vector<XY> generated = generatePolygon(n, seed);
+        std::vector<PointInPolygon::Point> polygon(n), queries(QUERIES);
+        for (size_t i = 0; i < n; i++) polygon[i] = {generated[i].x, generated[i].y};
+        std::vector<XY> queryXY = generatePoints(Uniform, QUERIES, seed + 1);
+        for (size_t i = 0; i < QUERIES; i++) queries[i] = {queryXY[i].x, queryXY[i].y};
+
+        double ops = static_cast<double>(n) * QUERIES;
+        if (context.enabled("isPointInPolygonRayCasting")) {
+            context.measure("isPointInPolygonRayCasting", "star", n, ops, []() {},
+                            [&]() {
+                                size_t inside = 0;
+                                for (size_t i = 0; i < QUERIES; i++) inside += isPointInPolygonRayCasting(queries[i], polygon);
+                                return static_cast<double>(inside);
+                            });
+        }
+        if (context.enabled("isPointInPolygonWindingNumber")) {
+            context.measure("isPointInPolygonWindingNumber", "star", n, ops, []() {},
+                            [&]() {
+                                size_t inside = 0;
+                                for (size_t i = 0; i < QUERIES; i++) inside += isPointInPolygonWindingNumber(queries[i], polygon);
+                                return static_cast<double>(inside);
+                            });
+        }
+        // 凸多边形取星形多边形的凸包，ops 为查询的点数
+        if (context.enabled("ConvexPolygon::classifyPoints")) {
+            std::vector<PointInPolygon::Point> vertices(polygon);
+            ConvexPolygon convex(ConvexHull::compute(vertices));
+            std::vector<uint8_t> out(QUERIES);
+            context.measure("ConvexPolygon::classifyPoints", "hull", n, static_cast<double>(QUERIES), []() {},
+                            [&]() {
+                                convex.classifyPoints(queries, out.data());
+                                size_t inside = 0;
+                                for (size_t i = 0; i < QUERIES; i++) inside += out[i] != Outside;
+                                return static_cast<double>(inside);
+                            });
+        }
+    }
+}
+
+} // namespace bench
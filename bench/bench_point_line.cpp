@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "point_line.h"
+
+namespace bench {
+
+// 每个规模对 n 个点判断相对于同一条直线的位置，ops 为点数
+void runPointLine(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        std::vector<XY> generated = generatePoints(Uniform, n, context.seedFor("point_line", n));
+        std::vector<double> xs(n), ys(n);
+        for (size_t i = 0; i < n; i++) {
+            xs[i] = generated[i].x;
+            ys[i] = generated[i].y;
+        }
+        std::vector<XY>().swap(generated);
+        Point base(xs[0], ys[0]);
+        Vector direction = {1.0, 0.5};
+
+        if (context.enabled("determinePosition")) {
+            context.measure("determinePosition", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                size_t above = 0;
+                                for (size_t i = 0; i < n; i++) {
+                                    above += determinePosition(base, Point(xs[i], ys[i]), direction)[9] == 'a';
+                                }
+                                return static_cast<double>(above);
+                            });
+        }
+        if (context.enabled("classifyPositions")) {
+            std::vector<int8_t> out(n);
+            context.measure("classifyPositions", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                classifyPositions(xs.data(), ys.data(), n, base, direction, out.data());
+                                long sum = 0;
+                                for (size_t i = 0; i < n; i++) sum += out[i];
+                                return static_cast<double>(sum);
+                            });
+        }
+        if (context.enabled("classifyPositionsMask")) {
+            std::vector<uint64_t> above((n + 63) / 64);
+            context.measure("classifyPositionsMask", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                classifyPositionsMask(xs.data(), ys.data(), n, base, direction, above.data(), nullptr);
+                                size_t count = 0;
+                                for (size_t i = 0; i < above.size(); i++) count += __builtin_popcountll(above[i]);
+                                return static_cast<double>(count);
+                            });
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "PointLocator.h"
+#include <cmath>
+#include <cstdio>
+
+namespace bench {
+
+// 约 n 个四边形组成的网格，格点随机抖动，相邻四边形共用边
+static std::vector<std::vector<Point>> jitteredGrid(size_t n, uint64_t seed) {
+    size_t side = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+    Rng rng(seed);
+    std::vector<Point> lattice((side + 1) * (side + 1));
+    for (size_t i = 0; i < lattice.size(); i++) {
+        lattice[i] = Point(static_cast<double>(i % (side + 1)) + rng.uniform(-0.3, 0.3),
+                           static_cast<double>(i / (side + 1)) + rng.uniform(-0.3, 0.3));
+    }
+    std::vector<std::vector<Point>> polygons;
+    polygons.reserve(side * side);
+    for (size_t y = 0; y < side; y++) {
+        for (size_t x = 0; x < side; x++) {
+            size_t corner = y * (side + 1) + x;
+            polygons.push_back({lattice[corner], lattice[corner + 1], lattice[corner + side + 2], lattice[corner + side + 1]});
+        }
+    }
+    return polygons;
+}
+
+// 在 n 个多边形上建索引，再做 n 次随机点查询；ops 为多边形数或查询数
+void runPointLocator(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        uint64_t seed = context.seedFor("point_locator", n);
+        std::vector<std::vector<Point>> polygons = jitteredGrid(n, seed);
+        double side = std::sqrt(static_cast<double>(polygons.size()));
+
+        if (context.enabled("PointLocator::build")) {
+            context.measure("PointLocator::build", "grid", n, static_cast<double>(polygons.size()), []() {},
+                            [&]() { return static_cast<double>(PointLocator(polygons).nodeCount()); });
+        }
+        if (!context.enabled("PointLocator::locate") && !context.enabled("PointLocator::load")) continue;
+
+        PointLocator locator(polygons);
+        if (context.enabled("PointLocator::locate")) {
+            Rng rng(seed + 1);
+            PointSet queries;
+            queries.reserve(n);
+            for (size_t i = 0; i < n; i++) queries.push_back(Point(rng.uniform(0, side), rng.uniform(0, side)));
+            std::vector<int> out(n);
+            context.measure("PointLocator::locate", "grid", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                locator.locate(queries, out.data());
+                                double sum = 0;
+                                for (size_t i = 0; i < n; i++) sum += out[i];
+                                return sum;
+                            });
+        }
+        if (context.enabled("PointLocator::load")) {
+            const std::string path = "bench_point_locator.bin";
+            locator.save(path);
+            context.measure("PointLocator::load", "grid", n, static_cast<double>(polygons.size()), []() {},
+                            [&]() { return static_cast<double>(PointLocator::load(path).nodeCount()); });
+            remove(path.c_str());
+        }
+    }
+}
+
+} // namespace bench
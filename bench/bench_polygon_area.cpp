@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "polygonArea.h"
+
+namespace bench {
+
+// 批量测试中每个地块多边形的顶点数
+static const size_t PARCEL_VERTICES = 8;
+
+void runPolygonArea(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        if (context.enabled("polygonArea")) {
+            std::vector<XY> generated = generatePolygon(n, context.seedFor("polygon_area", n));
+            std::vector<_Point> polygon;
+            polygon.reserve(n);
+            for (size_t i = 0; i < n; i++) polygon.push_back(_Point(generated[i].x, generated[i].y));
+            std::vector<XY>().swap(generated);
+
+            context.measure("polygonArea", "star", n, static_cast<double>(n), []() {},
+                            [&]() { return polygonArea(polygon); });
+        }
+
+        // n 个顶点组成 n / 8 个小多边形，平移到 10^6 量级的坐标上，按 CSR 存放
+        if (context.enabled("polygonAreas") && n >= PARCEL_VERTICES) {
+            size_t count = n / PARCEL_VERTICES;
+            std::vector<double> xs, ys;
+            std::vector<size_t> offsets(1, 0);
+            xs.reserve(count * PARCEL_VERTICES);
+            ys.reserve(count * PARCEL_VERTICES);
+            uint64_t seed = context.seedFor("polygon_areas", n);
+            Rng rng(seed);
+            for (size_t k = 0; k < count; k++) {
+                std::vector<XY> parcel = generatePolygon(PARCEL_VERTICES, seed + k + 1);
+                double dx = 1e6 + rng.uniform(0, 1e5), dy = 1e6 + rng.uniform(0, 1e5);
+                for (size_t i = 0; i < parcel.size(); i++) {
+                    xs.push_back(dx + parcel[i].x * 1e-3);
+                    ys.push_back(dy + parcel[i].y * 1e-3);
+                }
+                offsets.push_back(xs.size());
+            }
+            std::vector<double> areas(count);
+            context.measure("polygonAreas", "parcels", n, static_cast<double>(xs.size()), []() {},
+                            [&]() {
+                                polygonAreas(xs.data(), ys.data(), offsets.data(), count, areas.data());
+                                double sum = 0;
+                                for (size_t k = 0; k < count; k++) sum += areas[k];
+                                return sum;
+                            });
+        }
+    }
+}
+
+} // namespace bench
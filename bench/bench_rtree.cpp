@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "RTree.h"
+
+namespace bench {
+
+// 对 n 个随机矩形建索引，再做 n 次点查询和最近邻查询
+void runRTree(Context& context) {
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        uint64_t seed = context.seedFor("rtree", n);
+        std::vector<Box> generated = generateRectangles(n, seed);
+        std::vector<Rectangle> rectangles(n);
+        for (size_t i = 0; i < n; i++) {
+            rectangles[i] = {generated[i].x1, generated[i].y1, generated[i].x2, generated[i].y2};
+        }
+        std::vector<Box>().swap(generated);
+
+        if (context.enabled("RTree::build")) {
+            context.measure("RTree::build", "rectangles", n, static_cast<double>(n), []() {},
+                            [&]() { return static_cast<double>(RTree::fromRectangles(rectangles).size()); });
+        }
+        if (!context.enabled("RTree::queryPoints") && !context.enabled("RTree::nearestPoints")) continue;
+
+        RTree tree = RTree::fromRectangles(rectangles);
+        Rng rng(seed + 1);
+        PointSet queries;
+        queries.reserve(n);
+        for (size_t i = 0; i < n; i++) queries.push_back(Point(rng.uniform(0, 1 << 30), rng.uniform(0, 1 << 30)));
+
+        if (context.enabled("RTree::queryPoints")) {
+            std::vector<size_t> offsets;
+            std::vector<int> items;
+            context.measure("RTree::queryPoints", "rectangles", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                tree.queryPoints(queries, offsets, items);
+                                return static_cast<double>(items.size());
+                            });
+        }
+        if (context.enabled("RTree::nearestPoints")) {
+            std::vector<int> nearest;
+            context.measure("RTree::nearestPoints", "rectangles", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                tree.nearestPoints(queries, nearest);
+                                double sum = 0;
+                                for (size_t i = 0; i < n; i++) sum += nearest[i];
+                                return sum;
+                            });
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,30 @@
+#include "bench.h"
+#include "ScaningLineAlgorythm.h"
+
+namespace bench {
+
+void runScanLine(Context& context) {
+    if (!context.enabled("calculateArea") && !context.enabled("calculateCoverage")) return;
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        std::vector<Box> boxes = generateRectangles(n, context.seedFor("scan_line", n));
+        std::vector<Rectangle> rectangles(n);
+        for (size_t i = 0; i < n; i++) rectangles[i] = {boxes[i].x1, boxes[i].y1, boxes[i].x2, boxes[i].y2};
+        std::vector<Box>().swap(boxes);
+
+        if (context.enabled("calculateArea")) {
+            context.measure("calculateArea", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() { return static_cast<double>(calculateArea(rectangles)); });
+        }
+        if (context.enabled("calculateCoverage")) {
+            CoverageOptions options(CoverArea | CoverPerimeter | CoverDepth, 4);
+            context.measure("calculateCoverage", "uniform", n, static_cast<double>(n), []() {},
+                            [&]() {
+                                CoverageResult result = calculateCoverage(rectangles, options);
+                                return static_cast<double>(result.area + result.perimeter + result.depthArea.back());
+                            });
+        }
+    }
+}
+
+} // namespace bench
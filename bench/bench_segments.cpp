@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "LineSegmentIntersection.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bench {
+
+// findAllIntersections 的输入：uniform 把生成的线段按 40 / sqrt(n) 缩短，交点数与 n 同阶；
+// grid 为 sqrt(n) 见方的整数网格上长 1 到 3 的水平和竖直线段，大量共享端点、共线重叠和多条线段交于一点
+static std::vector<LineSegmentIntersection::Segment> sweepSegments(const std::string& workload, size_t n,
+                                                                   uint64_t seed) {
+    std::vector<LineSegmentIntersection::Segment> segments(n);
+    if (workload == "uniform") {
+        std::vector<SegmentXY> generated = generateSegments(n, seed);
+        double scale = std::min(1.0, 40 / std::sqrt(static_cast<double>(n)));
+        for (size_t i = 0; i < n; i++) {
+            const SegmentXY& g = generated[i];
+            segments[i].a = Point(g.a.x, g.a.y);
+            segments[i].b = Point(g.a.x + (g.b.x - g.a.x) * scale, g.a.y + (g.b.y - g.a.y) * scale);
+        }
+        return segments;
+    }
+    Rng rng(seed);
+    uint64_t side = static_cast<uint64_t>(std::sqrt(static_cast<double>(n))) + 1;
+    for (size_t i = 0; i < n; i++) {
+        double x = static_cast<double>(rng.below(side)), y = static_cast<double>(rng.below(side));
+        double length = static_cast<double>(1 + rng.below(3));
+        segments[i].a = Point(x, y);
+        segments[i].b = rng.below(2) == 0 ? Point(x + length, y) : Point(x, y + length);
+    }
+    return segments;
+}
+
+static void runFindAllIntersections(Context& context) {
+    const char* workloads[] = {"uniform", "grid"};
+    for (int w = 0; w < 2; w++) {
+        for (size_t s = 0; s < context.sizes.size(); s++) {
+            size_t n = context.sizes[s];
+            // 扫描线的状态和事件队列都是基于节点的树，千万条线段时内存和时间都过大，只测到百万
+            if (n > 1000000) continue;
+            std::vector<LineSegmentIntersection::Segment> segments =
+                sweepSegments(workloads[w], n, context.seedFor(std::string("findAllIntersections/") + workloads[w], n));
+            context.measure("findAllIntersections", workloads[w], n, static_cast<double>(n), []() {},
+                            [&]() {
+                                return static_cast<double>(LineSegmentIntersection::findAllIntersections(segments).size());
+                            });
+        }
+    }
+}
+
+void runSegments(Context& context) {
+    if (context.enabled("findAllIntersections")) runFindAllIntersections(context);
+    if (!context.enabled("segmentsIntersect")) return;
+    using LineSegmentIntersection::segmentsIntersect;
+    for (size_t s = 0; s < context.sizes.size(); s++) {
+        size_t n = context.sizes[s];
+        std::vector<SegmentXY> generated = generateSegments(n * 2, context.seedFor("segments", n));
+        std::vector<LineSegmentIntersection::Point> points(n * 4);
+        for (size_t i = 0; i < generated.size(); i++) {
+            points[i * 2] = {generated[i].a.x, generated[i].a.y};
+            points[i * 2 + 1] = {generated[i].b.x, generated[i].b.y};
+        }
+        std::vector<SegmentXY>().swap(generated);
+
+        // 第 i 次调用判断第 2i 和第 2i + 1 条线段是否相交
+        context.measure("segmentsIntersect", "uniform", n, static_cast<double>(n), []() {},
+                        [&]() {
+                            size_t hits = 0;
+                            for (size_t i = 0; i < n; i++) {
+                                const LineSegmentIntersection::Point* p = &points[i * 4];
+                                hits += segmentsIntersect(p[0], p[1], p[2], p[3]);
+                            }
+                            return static_cast<double>(hits);
+                        });
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,129 @@
+#ifndef DYNAMIC_HULL_H
+#define DYNAMIC_HULL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+#include "geometry.h"
+
+// 支持逐点插入的凸包，插入均摊 O(log n)
+// 上下两条凸链按 x 坐标存放在有序表中，另按边的斜率建索引，用于 O(log n) 的极点查询
+// 与 ConvexHull::compute 一样不保留共线点，方向判断使用精确谓词
+class DynamicHull {
+public:
+    DynamicHull() : upper(1.0), lower(-1.0) {}
+
+    // 插入一个点，凸包发生变化时返回 true
+    bool insert(const Point& p);
+
+    // 点在凸包内或边界上，O(log n)
+    bool contains(const Point& q) const;
+
+    // 方向 (dx, dy) 上最远的凸包顶点，即 dx * x + dy * y 最大的顶点，有多个时返回其中之一，O(log n)
+    // 凸包为空或方向为零向量时抛出 std::invalid_argument
+    Point extreme(double dx, double dy) const;
+
+    // 凸包顶点，顺序与 ConvexHull::compute 相同：从最低（其次最左）的点开始按逆时针排列
+    std::vector<Point> vertices() const;
+
+    size_t size() const;
+    bool empty() const { return upper.empty(); }
+    void clear();
+
+private:
+    friend class SlidingWindowHull;
+
+    // 上凸链：x 严格递增，相邻两边右转。下凸链以 (x, -y) 存放，也是上凸链
+    class Chain {
+    public:
+        explicit Chain(double sign) : sign(sign), journaling(false) {}
+
+        bool insert(const Point& p);
+        bool below(const Point& q) const;  // q 在链的 x 范围内，并且在链下方或链上
+        Point extreme(double dx, double dy) const;  // 要求 dy * sign > 0
+        void clear();
+
+        bool empty() const { return points.empty(); }
+        size_t size() const { return points.size(); }
+        Point front() const { return toPoint(points.begin()); }
+        Point back() const { return toPoint(std::prev(points.end())); }
+        void append(std::vector<Point>& out, bool reverse) const;
+
+        // 开启后记录每次插入删掉的点，undo 按相反顺序撤销最近一次插入
+        void setJournaling(bool on);
+        void undo();
+
+    private:
+        struct Vertex {
+            double y;  // 已乘 sign
+            int id;
+        };
+        typedef std::map<double, Vertex> Points;
+        typedef Points::iterator Iterator;
+        typedef Points::const_iterator ConstIterator;
+
+        // 一次插入的记录：新点的 x（没有插入时 inserted 为 false），以及被删掉的点在 erased 中的起始位置
+        struct Change {
+            double x;
+            bool inserted;
+            size_t erasedBegin;
+        };
+
+        double sign;
+        Points points;
+        // 边 (左端点, 右端点) 按斜率从大到小排列，值为左端点；斜率相同的边可能因舍入而出现，因此用 multimap
+        std::multimap<double, ConstIterator, std::greater<double>> edges;
+        bool journaling;
+        std::vector<Change> journal;
+        std::vector<std::pair<double, Vertex>> erased;
+
+        Point toPoint(ConstIterator it) const { return Point(it->first, sign * it->second.y, it->second.id); }
+        static double slope(ConstIterator a, ConstIterator b);
+        void addEdge(Iterator left);
+        void removeEdge(Iterator left);
+        void erase(Iterator it);
+        Iterator place(Iterator hint, double x, const Vertex& v);
+    };
+
+    Chain upper, lower;
+
+    void setJournaling(bool on);
+    void undo();
+};
+
+// 滑动窗口凸包：只保留最近加入的点，加入和删除均摊 O(log n)
+// 窗口按两个栈的方式维护：新点插入 back；删除时若 front 为空，把 back 中的点从新到旧插入 front 并记录每次插入的改动，
+// 之后删除最早的点就是撤销 front 最近一次插入。查询合并两部分的结果
+class SlidingWindowHull {
+public:
+    // capacity 为 0 时窗口不限长度，只能通过 popOldest 删除点
+    explicit SlidingWindowHull(size_t capacity = 0) : capacity(capacity), mergedValid(false) {}
+
+    // 加入一个点，窗口已满时先删除最早的点
+    void push(const Point& p);
+    // 删除最早加入的点，窗口为空时不做任何事
+    void popOldest();
+
+    size_t windowSize() const { return older.size() + newer.size(); }
+    const Point& oldest() const { return older.empty() ? newer.front() : older.back(); }
+
+    // 查询窗口中的点的凸包，含义与 DynamicHull 相同
+    // extreme 为 O(log n)；contains、vertices 在窗口变化后第一次调用时合并两部分的凸包，O(h log h)
+    bool contains(const Point& q) const;
+    Point extreme(double dx, double dy) const;
+    std::vector<Point> vertices() const;
+
+private:
+    size_t capacity;
+    std::vector<Point> older;  // front 中的点，最早的在末尾
+    std::deque<Point> newer;   // back 中的点，最早的在开头
+    DynamicHull front, back;
+    mutable DynamicHull merged;
+    mutable bool mergedValid;
+
+    const DynamicHull& mergedHull() const;
+};
+
+#endif // DYNAMIC_HULL_H
@@ -1,11 +1,14 @@
 #ifndef LINE_SEGMENT_INTERSECTION_H
 #define LINE_SEGMENT_INTERSECTION_H
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "geometry.h"
+
 namespace LineSegmentIntersection {
 
-struct Point {
-    double x, y;
-};
+typedef ::Point Point;
 
 // 判断两个点的最大值和最小值
 double min(double a, double b);
@@ -23,6 +26,26 @@ bool crossProductIntersect(const Point& A1, const Point& A2, const Point& B1, co
 // 判断两条线段是否相交
 bool segmentsIntersect(const Point& A1, const Point& A2, const Point& B1, const Point& B2);
 
+// 线段
+struct Segment {
+    Point a, b;
+};
+
+// 批量判断：out[i] 为 segmentsIntersect(first[i].a, first[i].b, second[i].a, second[i].b) 的结果
+// threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+void segmentsIntersect(const Segment* first, const Segment* second, size_t n, uint8_t* out, int threads = 1);
+
+// 一对相交的线段（first < second）及其交点，共线重叠时为重叠部分在扫描顺序中的第一个点，
+// 交点不能精确表示时为舍入后的点
+struct IntersectionPair {
+    int first, second;
+    Point point;
+};
+
+// Bentley-Ottmann 扫描线算法，报告线段集合中所有相交的线段对，复杂度 O((n + k) log n)
+// 结果按 (first, second) 排序，每对线段只报告一次
+std::vector<IntersectionPair> findAllIntersections(const std::vector<Segment>& segments);
+
 } // namespace LineSegmentIntersection
 
 #endif // LINE_SEGMENT_INTERSECTION_H
\ No newline at end of file
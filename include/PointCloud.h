@@ -0,0 +1,96 @@
+#ifndef POINT_CLOUD_H
+#define POINT_CLOUD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "geometry.h"
+
+// 二进制点云文件：文件头之后按列存放 x、y（double）和可选的 id（int32），均为小端序
+// 每列从 4096 字节对齐的位置开始，映射到内存后可以直接作为 PointView 交给各算法，不需要解析和复制
+namespace PointCloud {
+
+const uint32_t FORMAT_VERSION = 1;
+const uint32_t HAS_IDS = 1;  // flags 中的位：文件含 id 列
+
+// 文件头，位于文件开头，共 128 字节
+struct Header {
+    char magic[8];       // "GEOMPTS\0"
+    uint32_t version;    // 格式版本，读取时拒绝比 FORMAT_VERSION 新的文件
+    uint32_t flags;
+    uint64_t count;      // 点数
+    uint64_t xOffset;    // 各列相对文件开头的字节偏移，没有 id 列时 idOffset 为 0
+    uint64_t yOffset;
+    uint64_t idOffset;
+    double minX, minY, maxX, maxY;  // 所有点的包围盒，点集为空时 min > max
+    uint8_t reserved[48];
+};
+
+// 把 points 写入 path，withIds 为 false 时不写 id 列，读取时 id 取下标
+// 出错时抛出 std::runtime_error
+void write(const std::string& path, const PointView& points, bool withIds = true);
+
+// 只读映射一个点云文件，对象销毁时解除映射
+// 不支持 mmap 的平台上整个文件读入内存，接口不变
+class MappedFile {
+public:
+    // 访问模式提示，对应 madvise 的 NORMAL / SEQUENTIAL / RANDOM
+    enum Access { Normal, Sequential, Random };
+
+    MappedFile();
+    // 打开并校验文件，格式不符或文件被截断时抛出 std::runtime_error
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(data); }
+    size_t size() const { return count; }
+    bool hasIds() const { return ids != nullptr; }
+
+    // 各列的指针，直接指向映射的内存，没有 id 列时 idData 为空
+    const double* xData() const { return xs; }
+    const double* yData() const { return ys; }
+    const int32_t* idData() const { return ids; }
+
+    // 整个点集或下标 [first, first + n) 的视图，不复制数据
+    PointView view() const;
+    PointView view(size_t first, size_t n) const;
+
+    // 整个映射的访问模式提示
+    void advise(Access access) const;
+    // 预读下标 [first, first + n) 的点，后台读入页缓存
+    void prefetch(size_t first, size_t n) const;
+    // 下标 [first, first + n) 的点不再使用，允许系统回收其物理页，之后再访问会重新从文件读取
+    void release(size_t first, size_t n) const;
+
+    // 按顺序分块访问：每次回调得到一块的视图和它的起始下标，处理当前块时预读下一块
+    // releaseProcessed 为 true 时处理完的块立即释放，点数远超内存时常驻内存只有两块左右
+    void forEachChunk(size_t chunkPoints, const std::function<void(const PointView& chunk, size_t first)>& visit,
+                      bool releaseProcessed = false) const;
+
+private:
+    const char* data;     // 文件开头
+    size_t length;        // 文件字节数
+    bool mapped;          // data 来自 mmap，否则为 new 分配的内存
+    size_t count;
+    const double* xs;
+    const double* ys;
+    const int32_t* ids;
+
+    // 对各列中下标 [first, first + n) 对应的页调用 madvise
+    void adviseRange(size_t first, size_t n, int advice) const;
+};
+
+} // namespace PointCloud
+
+#endif // POINT_CLOUD_H
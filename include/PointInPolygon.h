@@ -3,19 +3,102 @@
 
 #include <vector>
 #include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include "geometry.h"
 
 namespace PointInPolygon {
 
-struct Point {
-    double x;
-    double y;
-};
+typedef ::Point Point;
 
 //光线投射算法
 bool isPointInPolygonRayCasting(const Point& pt, const std::vector<Point>& polygon);
 //回转数算法
 bool isPointInPolygonWindingNumber(const Point& pt, const std::vector<Point>& polygon);
 
+// 批量分类结果
+enum PointLocation {
+    Outside = 0,
+    Inside = 1,
+    OnBoundary = 2
+};
+
+// 批量光线投射：多边形的边以 SoA 形式存储，按 AVX2、SSE2、标量逐级回退
+// out[i] 为 PointLocation，非 Outside 时与 isPointInPolygonRayCasting 返回 true 一致
+// threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+void classifyPoints(const Point* pts, size_t n, const std::vector<Point>& polygon, uint8_t* out, int threads = 1);
+// 对视图中的点分类，out 的长度为 pts.size()
+void classifyPoints(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out, int threads = 1);
+
+// 批量版本，out[i] 为 1 或 0，与对每个点调用单点版本的结果相同，out 的长度为 pts.size()
+void isPointInPolygonRayCasting(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out,
+                                int threads = 1);
+void isPointInPolygonWindingNumber(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out,
+                                   int threads = 1);
+
+// 预处理多边形：一次构建，多次查询
+// 预先计算每条边的数据，并按 y 坐标把边分桶，查询时只检查与点所在桶相交的边
+// 跨越多个桶的边在每个桶中各存一份；桶数最多为边数，并会减少到使总份数不超过边数的 4 倍，内存为 O(n)
+class PreparedPolygon {
+public:
+    explicit PreparedPolygon(const std::vector<Point>& polygon);
+    explicit PreparedPolygon(const PointView& polygon);
+
+    // 与 isPointInPolygonRayCasting 结果一致
+    bool containsRayCasting(const Point& pt) const;
+    // 与 isPointInPolygonWindingNumber 结果一致
+    bool containsWindingNumber(const Point& pt) const;
+
+    size_t size() const { return edges.size(); }
+
+private:
+    // 边 v1 -> v2
+    struct Edge {
+        double x1, y1, x2, y2;
+    };
+
+    std::vector<Edge> edges;
+    std::vector<size_t> bucketStart;  // 每个桶在 bucketEdges 中的起始位置，共 bucketCount + 1 项
+    std::vector<int> bucketEdges;     // 各桶包含的边的下标
+    double minY, maxY;
+    double bucketScale;               // 桶数 / (maxY - minY)
+    int bucketCount;
+
+    int bucketOf(double y) const;
+    // 按当前桶数，所有边覆盖的桶数之和
+    size_t countEntries() const;
+};
+
+// 凸多边形：一次构建，每次查询 O(log n)
+// 以第一个顶点为中心把多边形分成扇形三角形，二分查找点所在的扇区，再与扇区的外边做一次方向判断
+class ConvexPolygon {
+public:
+    // 顶点按顺时针或逆时针排列均可，允许共线点和相邻的重复点（如 ConvexHull::grahamScan 的结果）
+    // 多边形不凸或自交时抛出 std::invalid_argument；所有顶点共线时退化为线段，只有线段上的点在边界上
+    explicit ConvexPolygon(const std::vector<Point>& polygon);
+    explicit ConvexPolygon(const PointView& polygon);
+
+    // 检查多边形是否凸，条件与构造函数相同
+    static bool isConvex(const PointView& polygon);
+
+    // 边界的判定与 isPointInPolygonRayCasting 一致
+    PointLocation locate(const Point& pt) const;
+    bool contains(const Point& pt) const { return locate(pt) != Outside; }
+
+    // 批量分类，out 的长度为 pts.size()；threads 的含义与 PointInPolygon::classifyPoints 相同
+    void classifyPoints(const PointView& pts, uint8_t* out, int threads = 1) const;
+
+    // 去掉重复点和共线点后按逆时针排列的顶点
+    const std::vector<Point>& vertices() const { return hull; }
+    size_t size() const { return hull.size(); }
+
+private:
+    std::vector<Point> hull;
+
+    // 整理顶点，多边形不凸时返回 false
+    static bool normalize(const PointView& polygon, std::vector<Point>& hull);
+};
+
 } // namespace PointInPolygon
 
 #endif // POINT_IN_POLYGON_H
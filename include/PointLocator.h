@@ -0,0 +1,63 @@
+#ifndef POINT_LOCATOR_H
+#define POINT_LOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "geometry.h"
+
+// 平面细分的点定位：在一组互不重叠的多边形上一次构建，之后每次查询 O(log n)
+// 按所有顶点的 x 坐标把平面分成竖直的条带，条带内的边互不相交，可以按上下次序排列
+// 相邻条带的边序列只差经过分界线的几条边，每个条带的有序表用可持久化 treap 在上一个条带的基础上修改得到
+// 多边形可以按顺时针或逆时针排列，相邻多边形重合的边只存一份；多边形编号为构建时的下标
+class PointLocator {
+public:
+    static const int NONE = -1;
+
+    PointLocator() : numPolygons(0) {}
+    explicit PointLocator(const std::vector<std::vector<Point>>& polygons);
+    // 多边形按 CSR 存放，布局与 polygonAreas 相同
+    PointLocator(const double* xs, const double* ys, const size_t* offsets, size_t count);
+
+    // 包含点 (x, y) 的多边形编号，不在任何多边形内时为 NONE
+    // 边界上的点属于以该边为边界的多边形之一
+    int locate(double x, double y) const;
+    int locate(const Point& p) const { return locate(p.x, p.y); }
+
+    // 批量查询，out 的长度为 points.size()
+    // threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+    void locate(const PointView& points, int* out, int threads = 1) const;
+
+    // 以二进制格式保存和加载，加载后无需重新构建；文件只能在字节序相同的机器之间使用
+    // 文件截断、损坏（数量与长度不符、下标越界、节点含环）或版本不符时 load 抛出 std::runtime_error
+    void save(const std::string& path) const;
+    static PointLocator load(const std::string& path);
+
+    size_t polygonCount() const { return numPolygons; }
+    size_t edgeCount() const { return edges.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    // 非竖直的边，x1 < x2；above、below 为边上方和下方的多边形
+    struct Edge {
+        double x1, y1, x2, y2;
+        int32_t above, below;
+    };
+
+    // treap 节点，优先级由边的编号散列得到，不单独存放
+    struct Node {
+        int32_t edge, left, right;
+    };
+
+    size_t numPolygons;
+    std::vector<double> slabX;    // 条带分界线，第 k 个条带为 [slabX[k], slabX[k + 1]]
+    std::vector<int32_t> roots;   // 每个条带的 treap 根节点，空树为 -1
+    std::vector<Edge> edges;
+    std::vector<Node> nodes;
+
+    void build(const std::vector<Edge>& raw, size_t polygonCount);
+    int locateInSlab(size_t slab, double x, double y) const;
+};
+
+#endif // POINT_LOCATOR_H
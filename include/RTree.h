@@ -0,0 +1,81 @@
+#ifndef RTREE_H
+#define RTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "geometry.h"
+#include "ScaningLineAlgorythm.h"
+#include "LineSegmentIntersection.h"
+
+// 静态打包 R 树：用 STR（Sort-Tile-Recursive）方法一次性构建，之后只读
+// 所有节点按层存放在一个连续数组中，叶子层在前、根节点在最后；元素的包围盒按叶子顺序另存一个数组
+// 元素编号为构建时的下标，查询结果都是这些编号；包围盒为空（min > max 或含 NaN）的元素不进入索引
+class RTree {
+public:
+    // 轴对齐包围盒，边界为闭区间
+    struct Box {
+        double minX, minY, maxX, maxY;
+    };
+
+    RTree() : capacity(16), leafCount(0) {}
+
+    // nodeCapacity 为每个节点的最大子节点数，取值范围 [2, 64]
+    explicit RTree(const std::vector<Box>& boxes, int nodeCapacity = 16);
+
+    // 矩形按其坐标范围建索引
+    static RTree fromRectangles(const std::vector<Rectangle>& rectangles, int nodeCapacity = 16);
+    // 线段按两端点的包围盒建索引
+    static RTree fromSegments(const std::vector<LineSegmentIntersection::Segment>& segments, int nodeCapacity = 16);
+    // 多边形按顶点的包围盒建索引
+    static RTree fromPolygons(const std::vector<std::vector<Point>>& polygons, int nodeCapacity = 16);
+    // 多边形按 CSR 存放，布局与 polygonAreas 相同
+    static RTree fromPolygons(const double* xs, const double* ys, const size_t* offsets, size_t count,
+                              int nodeCapacity = 16);
+
+    size_t size() const { return boxes.size(); }
+    bool empty() const { return boxes.empty(); }
+    const Box& bounds(int id) const { return boxes[id]; }
+
+    // 窗口查询：包围盒与 window 相交的元素，按遍历顺序追加到 out
+    void queryWindow(const Box& window, std::vector<int>& out) const;
+    // 点查询：包围盒包含点 (x, y) 的元素，追加到 out
+    void queryPoint(double x, double y, std::vector<int>& out) const;
+
+    // 到点 (x, y) 最近的 k 个元素，按距离从小到大追加到 out
+    // 默认以点到包围盒的距离为准；distance2 给出点到元素本身的距离平方时按元素距离排序，
+    // 它不能小于点到该元素包围盒的距离平方
+    void nearest(double x, double y, size_t k, std::vector<int>& out,
+                 const std::function<double(int id)>& distance2 = std::function<double(int)>()) const;
+
+    // 批量查询，结果按 CSR 输出：第 i 个查询的结果为 items 中下标 [offsets[i], offsets[i + 1]) 的部分
+    // threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+    void queryWindows(const std::vector<Box>& windows, std::vector<size_t>& offsets, std::vector<int>& items,
+                      int threads = 1) const;
+    void queryPoints(const PointView& points, std::vector<size_t>& offsets, std::vector<int>& items,
+                     int threads = 1) const;
+    // 每个点的最近元素（包围盒距离），out 的长度为 points.size()，树为空时为 -1
+    void nearestPoints(const PointView& points, std::vector<int>& out, int threads = 1) const;
+
+private:
+    // 节点覆盖的子节点（叶子为元素）在下一层数组中的范围 [first, first + count)
+    struct Node {
+        Box box;
+        int first, count;
+    };
+
+    int capacity;
+    size_t leafCount;          // nodes 中前 leafCount 个为叶子
+    std::vector<Node> nodes;   // 按层存放，根节点为最后一个
+    std::vector<Box> entries;  // 按叶子顺序排列的元素包围盒
+    std::vector<int> ids;      // entries[i] 对应的元素编号
+    std::vector<Box> boxes;    // 按元素编号排列的包围盒
+
+    void build(int nodeCapacity);
+
+    // 深度优先遍历，test 判断是否进入节点、是否接受元素，stack 由调用者提供以便批量查询时复用
+    template <typename Test>
+    void search(const Test& test, std::vector<int>& stack, std::vector<int>& out) const;
+};
+
+#endif // RTREE_H
@@ -4,12 +4,9 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <set>
-
-// 定义点结构
-struct Point {
-    int x, y;
-};
+#include <cstddef>
+#include <functional>
+#include <string>
 
 // 定义矩形结构
 struct Rectangle {
@@ -17,6 +14,7 @@ struct Rectangle {
 };
 
 // 定义事件结构，竖线与矩形相交时覆盖范围相关信息
+// x 为矩形竖边的 x 坐标，竖边覆盖 y 范围 [y1, y2)，type 为 1 表示进入矩形，-1 表示离开
 struct Event {
     int x, y1, y2, type;
 };
@@ -24,35 +22,108 @@ struct Event {
 // 比较事件的 x 坐标，按从小到大排序
 bool compareEvents(const Event &a, const Event &b);
 
-// 定义线段树的节点结构
-struct Node {
-    int left, right; // 左右边界
-    int count;       // 被覆盖的次数
-    int length;      // 被覆盖的长度
-
-    Node() : left(0), right(0), count(0), length(0) {}
-};
-
 // 线段树类
+// 非递归实现：叶子个数补齐为 2 的幂，节点 i 的子节点为 2i 和 2i + 1，叶子 j 对应区间 [yCoordinates[j], yCoordinates[j + 1])
+// 覆盖计数只记录在完整覆盖的节点上，不下传
+// 覆盖深度和覆盖段数是可选的附加数据，单独存放，不需要时不分配，也不增加更新的开销
 class SegmentTree {
 private:
+    // 同一节点的数据放在一起，更新时每个节点只访问一次内存
+    struct Node {
+        long long length;  // 区间内被覆盖的长度
+        long long width;   // 区间的总长度
+        int count;         // 被完整覆盖的次数
+    };
+
+    // 区间内被覆盖部分由几段互不相连的区间组成，以及区间的两端是否被覆盖
+    struct Boundary {
+        int segments;
+        bool lowCovered, highCovered;
+    };
+
+    int size;                // 叶子个数
+    int depth;               // 记录覆盖次数不少于 1..depth 的长度，0 表示不记录
     std::vector<Node> tree;
-    std::vector<int> yCoordinates;  // 存储离散化后的 y 坐标，存储矩形上每个点的 y 坐标
+    std::vector<long long> depthLength;  // 节点 i 的第 k 项（k 从 1 开始）在 i * depth + k - 1 处
+    std::vector<Boundary> boundary;      // 不记录覆盖段数时为空
 
 public:
-    SegmentTree(const std::vector<int>& coordinates);
-
-    void build(int node, int start, int end);
+    // coordinates 为排序去重后的 y 坐标
+    // depth 大于 0 时记录被覆盖至少 1..depth 次的长度，trackSegments 为 true 时记录覆盖段数
+    SegmentTree(const std::vector<int>& coordinates, int depth = 0, bool trackSegments = false);
 
-    void update(int node, int start, int end, int value);
+    // 区间 [start, end] 内的叶子覆盖次数加 value
+    void update(int start, int end, int value);
 
-    int getLength();
+    long long getLength() const;
+    // 被覆盖至少 k 次的长度，1 <= k <= depth
+    long long getDepthLength(int k) const;
+    // 被覆盖部分的段数，需要 trackSegments
+    int getSegments() const;
 
 private:
-    int getCoordinate(int index);
+    void pull(int node);
 };
 
 // 计算矩形覆盖的总面积
-int calculateArea(const std::vector<Rectangle> &rectangles);
+// 结果不超过所有矩形包围盒的面积，总能用 64 位无符号整数表示
+// threads 为并行线程数，1 为单线程，0 为使用全局线程池的全部线程；并行时按 x 轴切成若干竖条分别扫描后求和
+unsigned long long calculateArea(const std::vector<Rectangle> &rectangles, int threads = 1);
+
+// calculateCoverage 可统计的指标，可按位组合
+enum CoverageMetric {
+    CoverArea = 1,       // 覆盖的总面积，与 calculateArea 相同
+    CoverPerimeter = 2,  // 覆盖区域的周长，包括内部空洞的边界
+    CoverDepth = 4       // 被至少 k 个矩形覆盖的面积，k = 1..maxDepth
+};
+
+struct CoverageOptions {
+    unsigned metrics;  // CoverageMetric 的组合
+    int maxDepth;      // 统计 CoverDepth 时的最大 k
+
+    explicit CoverageOptions(unsigned metrics = CoverArea, int maxDepth = 0) : metrics(metrics), maxDepth(maxDepth) {}
+};
+
+// 未统计的指标为 0 或空
+struct CoverageResult {
+    unsigned long long area;
+    unsigned long long perimeter;
+    std::vector<unsigned long long> depthArea;  // depthArea[k - 1] 为被至少 k 个矩形覆盖的面积
+
+    CoverageResult() : area(0), perimeter(0) {}
+};
+
+// 一次扫描同时统计所选的指标，只为所选的指标付出代价：
+// 周长在线段树节点上记录覆盖段数，覆盖深度为每个节点记录 maxDepth 个长度，每次更新多 O(maxDepth) 的计算
+// 覆盖深度的表有 叶子数（补齐为 2 的幂）* 2 * maxDepth 个 long long，并行时每个竖条各有一张；
+// maxDepth 超过矩形个数的部分不会被覆盖，实际按 min(maxDepth, 矩形个数) 分配
+// 面积为 0 的矩形被忽略；需要 CoverDepth 而 maxDepth 不大于 0 时抛出 std::invalid_argument
+// threads 的含义与 calculateArea 相同，并行时竖条分界线上的周长单独按区间并集修正，结果与单线程相同
+CoverageResult calculateCoverage(const std::vector<Rectangle> &rectangles, const CoverageOptions &options,
+                                 int threads = 1);
+
+// 流式计算的矩形来源：每次最多向 buffer 写入 capacity 个矩形，返回写入的个数，返回 0 表示结束
+typedef std::function<size_t(Rectangle *buffer, size_t capacity)> RectangleSource;
+
+// 流式计算矩形覆盖的总面积，内存占用与输入规模无关
+// 每读入 chunkRectangles 个矩形就把排好序的事件写入临时文件，扫描时对各段做多路归并
+// 每次最多同时归并 64 段，段数更多时先多轮归并，读缓冲区的总大小与段数无关
+// y 方向使用动态开点线段树，只为当前覆盖的区间分配节点
+unsigned long long calculateAreaStreaming(const RectangleSource &source, size_t chunkRectangles = 1 << 20);
+
+// 从迭代器区间流式读取矩形
+template <typename Iterator>
+unsigned long long calculateAreaStreaming(Iterator first, Iterator last, size_t chunkRectangles = 1 << 20) {
+    RectangleSource source = [&first, &last](Rectangle *buffer, size_t capacity) {
+        size_t count = 0;
+        while (count < capacity && first != last) buffer[count++] = *first++;
+        return count;
+    };
+    return calculateAreaStreaming(source, chunkRectangles);
+}
+
+// 从二进制文件流式读取矩形，文件内容为连续的 x1, y1, x2, y2（32 位整数，本机字节序）
+// 文件长度不是记录长度的整数倍（最后一条记录被截断）或读取出错时抛出 std::runtime_error
+unsigned long long calculateAreaFromFile(const std::string &path, size_t chunkRectangles = 1 << 20);
 
 #endif // SCANNING_LINE_ALGORITHM_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池
+// 每个工作线程有自己的任务队列，从队尾取自己的任务，空闲时从其他队列的队首窃取任务
+class ThreadPool {
+public:
+    // 创建 workers 个工作线程，workers 为 0 时所有任务都由等待的线程自己执行
+    explicit ThreadPool(int workers);
+    ~ThreadPool();
+
+    int size() const { return static_cast<int>(threads.size()); }
+
+    // 提交任务，工作线程提交时放入自己的队列，其他线程提交时轮流放入各队列
+    void submit(std::function<void()> task);
+
+    // 在当前线程执行一个待处理的任务，没有任务时返回 false
+    bool runPendingTask();
+
+private:
+    struct Queue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping;
+    std::atomic<int> pending;     // 队列中尚未被取走的任务数
+    std::atomic<unsigned> nextQueue;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    bool takeTask(int self, std::function<void()>& task);
+    void workerLoop(int index);
+};
+
+// 任务组：向线程池派生任务，wait 时协助执行池中的任务，直到本组任务全部完成
+// 任务抛出的第一个异常会在 wait 中重新抛出
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    ThreadPool& pool;
+    std::atomic<int> pending;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+// 全局线程池，第一次调用时创建，之后所有批量接口共用，不再每次调用各自创建线程
+// 总线程数默认为硬件线程数，其中一个是调用线程本身，因此工作线程比总数少 1
+ThreadPool& globalPool();
+
+// 设置全局线程池的总线程数，不大于 0 时为硬件线程数
+// 必须在全局线程池第一次使用之前调用，否则抛出 std::logic_error
+void setGlobalThreads(int threads);
+
+// 全局线程池的总线程数（含调用线程）
+int globalThreads();
+
+// 把 [0, n) 按 grain 个一块划分，在全局线程池上并行执行 body(begin, end)，返回时所有块都已完成
+// 各线程从共享计数器领取下一块，先完成的线程继续领取，负载不均时自动平衡；body 只写自己下标的输出即可保持顺序
+// grain 为 0 时自动选择，约为每个线程 4 块；threads 为 1 时在调用线程上顺序执行，不大于 0 时使用全局线程池的全部线程
+// body 抛出的第一个异常在所有已开始的块结束后重新抛出，尚未领取的块不再执行
+void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& body, int threads = 0);
+
+#endif // THREAD_POOL_H
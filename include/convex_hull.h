@@ -2,16 +2,70 @@
 #define CONVEX_HULL_H
 
 #include <vector>
-
-struct Point {
-    double x, y, ang;
-
-    Point operator-(const Point& p) const { return {x - p.x, y - p.y, 0}; }
-};
+#include <cstddef>
+#include "geometry.h"
 
 class ConvexHull {
 public:
     static std::vector<Point> grahamScan(std::vector<Point>& points);
+
+    // 凸包计算选项
+    struct Options {
+        bool preserveInput;    // 为 true 时不修改输入，在内部副本上排序
+        bool outputSensitive;  // 为 true 时先用礼品包装法，凸包点数超过 ceil(log2 n) 时回退到单调链
+
+        Options() : preserveInput(true), outputSensitive(false) {}
+    };
+
+    // 单调链求凸包，只使用方向判断，不输出调试信息，O(n log n)
+    // 输出敏感模式下为 O(n * min(h, log n))，适合凸包点数很少的输入：
+    // 凸包顶点数 h <= ceil(log2 n) 时由礼品包装法完成，否则在包装了 ceil(log2 n) 个顶点后回退到单调链
+    // 结果与 grahamScan 相同：从最低（其次最左）的点开始按逆时针排列，不含共线点
+    static std::vector<Point> compute(std::vector<Point>& points, const Options& options = Options());
+    // 常量或临时的输入：总在内部副本上排序，忽略 preserveInput
+    static std::vector<Point> compute(const std::vector<Point>& points, const Options& options = Options());
+
+    // 直接在视图上求凸包，不复制点，返回凸包顶点在视图中的下标，顺序与 compute 相同
+    static std::vector<int> hullIndices(const PointView& points);
+
+    // 旋转卡壳，输入为按逆时针排列的凸多边形（compute 或 grahamScan 的结果），允许共线点和重复点
+    // 各函数均为 O(h)，凸包为空时抛出 std::invalid_argument
+
+    // 距离最远的两个顶点
+    struct FarthestPair {
+        Point a, b;
+        double distance;
+    };
+
+    // 最小宽度：凸包夹在经过 edgeStart、edgeEnd 的直线与经过 opposite 的平行线之间
+    struct Width {
+        double width;
+        Point edgeStart, edgeEnd, opposite;
+    };
+
+    // 外接矩形，corners 按逆时针排列，corners[0] -> corners[1] 与凸包的一条边共线
+    // length 为沿该边方向的边长，height 为垂直方向的边长
+    struct EnclosingRectangle {
+        Point corners[4];
+        double length, height, area, perimeter;
+    };
+
+    struct Calipers {
+        FarthestPair diameter;
+        Width width;
+        EnclosingRectangle minArea, minPerimeter;
+    };
+
+    static FarthestPair diameter(const std::vector<Point>& hull);
+    static Width minWidth(const std::vector<Point>& hull);
+    static EnclosingRectangle minAreaRectangle(const std::vector<Point>& hull);
+    static EnclosingRectangle minPerimeterRectangle(const std::vector<Point>& hull);
+    // 一次遍历同时求出以上四项，需要其中多项时比分别调用快
+    static Calipers rotatingCalipers(const std::vector<Point>& hull);
+
+private:
+    static std::vector<Point> monotoneChain(std::vector<Point>& points);
+    static bool giftWrapping(const std::vector<Point>& points, std::size_t maxHullSize, std::vector<Point>& hull);
 };
 
 #endif // CONVEX_HULL_H
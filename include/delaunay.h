@@ -1,37 +1,130 @@
 #ifndef DELAUNAY_H
 #define DELAUNAY_H
 
+#include <cstddef>
 #include <vector>
-#include <list>
+#include <array>
+#include <atomic>
+#include "geometry.h"
 
-struct Point {
-    double x, y;
-    int id;
-    Point(double a = 0, double b = 0, int c = -1) : x(a), y(b), id(c) {}
-
-    double dist2(const Point& p) const {
-        double dx = x - p.x;
-        double dy = y - p.y;
-        return dx * dx + dy * dy;
-    }
-};
+class ThreadPool;
 
 class Delaunay {
 public:
-    void init(int n, Point p[]);
+    Delaunay() : overflowEdges(nullptr), parallelCutoff(1 << 14), n(0), firstDuplicate(0), duplicateEnd(0),
+                 finiteTriangles(0), hintTri(-1), meshReady(false), walkSeed(1), markStamp(0) {
+        freeEdges.head = freeEdges.tail = -1;
+    }
+
+    // threads 为并行线程数，1 为单线程，0 为使用全局线程池的全部线程
+    // 并行时点数不超过 parallelCutoff 的子问题不再拆分为任务，结果与单线程完全相同
+    void init(int n, Point p[], int threads = 1, int parallelCutoff = 1 << 14);
+    // 从视图读取点，id 为负的点以其在视图中的下标作为 id
+    // 点被复制到对象内部：剖分要按 x 排序，之后还要支持 insert / remove，init 返回后不再引用视图
+    void init(const PointView& points, int threads = 1, int parallelCutoff = 1 << 14);
     std::vector<std::pair<int, int>> getEdge() const;
+    // 所有三角形，顶点为点的 id，按逆时针排列
+    std::vector<std::array<int, 3>> getTriangle() const;
+
+    // 在现有剖分中插入一个点，返回它的 id
+    // point.id 为负时自动分配新的 id；与已有点重合时不插入，返回已有点的 id
+    int insert(const Point& point);
+    // 删除 id 对应的点，id 不存在时返回 false
+    bool remove(int id);
+
+    // 离 q 最近的点的 id，没有点时返回 -1
+    // 从 hint（点的 id）与约 n^(1/3) 个抽样顶点中最近的一个出发，沿 Delaunay 图向更近的邻点移动，停下的点即为最近点
+    // 连续的查询彼此靠近时，以上一次的结果作为 hint 只需移动几步
+    int nearest(const Point& q, int hint = -1) const;
+    // 批量最近点查询，ids[i] 为 queries[i] 最近点的 id
+    // 查询先按 Hilbert 曲线排序，每个查询以前一个的结果为起点；threads 的含义与 init 相同
+    void nearest(const PointView& queries, int* ids, int threads = 1) const;
+
+    // Voronoi 图，数组均为扁平存储
+    struct Voronoi {
+        // Delaunay 三角形的外接圆圆心（Voronoi 顶点），顺序与 getTriangle 相同
+        std::vector<double> centerX, centerY;
+        // 第 i 个单元属于 id 为 site[i] 的点，其顶点为 x、y 中下标 [offsets[i], offsets[i + 1]) 的部分，按逆时针排列
+        // 单元都裁剪到给定的矩形内，凸包上的点的无界单元因此也是多边形；与另一个点重合的点的单元为空
+        std::vector<int> site;
+        std::vector<size_t> offsets;
+        std::vector<double> x, y;
+    };
+    // 单元裁剪到矩形 [minX, maxX] x [minY, maxY]
+    void getVoronoi(Voronoi& out, double minX, double minY, double maxX, double maxY) const;
+    // 单元裁剪到所有点的包围盒向外扩展一倍边长的矩形
+    void getVoronoi(Voronoi& out) const;
 
 private:
-    std::vector<std::list<int>> head;  // 图
+    // 空闲边链表，通过 edgeNext[2k] 串联
+    struct EdgePool {
+        int head, tail;
+    };
+
+    // 图以半边数组存储：半边 2k 与 2k + 1 互为反向边，同一起点的出边组成双向链表
+    // 子问题 [l, r] 只使用编号在 [3l, 3r + 3) 内的边，并行时各子问题互不干扰
+    std::vector<int> edgeTo;    // 半边指向的顶点
+    std::vector<int> edgeNext;  // 同一起点的下一条半边，-1 表示结束
+    std::vector<int> edgePrev;  // 同一起点的上一条半边，-1 表示链表头
+    std::vector<int> head;      // 每个顶点的第一条出边
+    EdgePool freeEdges;         // init 结束后剩余的空闲边
+    std::atomic<int>* overflowEdges;  // init 期间子问题的边用完时从 [3n, 4n) 中分配
+    int parallelCutoff;
     std::vector<Point> p;  // 点
     int n;
     std::vector<int> rename;
+    int firstDuplicate, duplicateEnd;  // init 时与其他点重合的孤立点的下标范围
 
+    // 增量更新使用的三角形网格，首次调用 insert / remove 时由图构建，之后与图同步更新
+    // 凸包外侧每条边对应一个以无穷远点为第三个顶点的虚拟三角形，使凸包内外的插入和删除统一处理
+    struct Triangle {
+        int v[3];   // 逆时针排列的顶点，INF_VERTEX 表示无穷远点，v[0] 为 DEAD_TRIANGLE 表示已删除
+        int nb[3];  // nb[i] 为 v[i] 对面的相邻三角形
+    };
+    static const int INF_VERTEX = -1;
+    static const int DEAD_TRIANGLE = -2;
+
+    std::vector<Triangle> tris;
+    std::vector<int> freeTris;
+    std::vector<int> vertexTri;  // 每个顶点所在的任一三角形
+    std::vector<char> alive;     // 顶点是否存在
+    int finiteTriangles;         // 有限三角形个数，为 0 时网格退化，改为整体重建
+    int hintTri;                 // 上次更新的三角形，作为定位的起点之一
+    bool meshReady;
+    unsigned walkSeed;           // 随机游走使用的种子
+    std::vector<int> triMark;    // 插入时标记空腔中的三角形
+    int markStamp;
+    std::vector<int> startTri;   // 插入时以某顶点为起点的新三角形，下标为顶点编号 + 1
+
+    void build(int threads, int parallelCutoff);
     static int intersection(const Point &a, const Point &b, const Point &c, const Point &d);
-    void addEdge(int u, int v);
-    void divide(int l, int r);
+    int allocEdge(EdgePool& pool);
+    void appendPool(EdgePool& pool, const EdgePool& other);
+    void addEdge(int u, int v, EdgePool& pool);
+    void removeEdge(int h, EdgePool& pool);
+    void divide(int l, int r, EdgePool& pool);
+    void divideParallel(int l, int r, EdgePool& pool, ThreadPool& workers, int threads);
+    void merge(int l, int r, EdgePool& pool);
     static double cross(const Point &o, const Point &a, const Point &b);
     static int inCircle(const Point &a, Point b, Point c, const Point &p);
+
+    void sortAround(int u, std::vector<int>& around) const;
+    int startVertex(const Point& q) const;
+    int walkToNearest(int v, const Point& q) const;
+    void voronoiCell(int u, const std::vector<int>& around, double minX, double minY, double maxX, double maxY,
+                     std::vector<double>& x, std::vector<double>& y) const;
+    static int infiniteIndex(const Triangle& t);
+    bool buildMesh();
+    void rebuild();
+    int addVertex(const Point& point);
+    int newTriangle(int a, int b, int c);
+    void freeTriangle(int t);
+    void relink(int t, int a, int b, int to);
+    int findHalfEdge(int u, int v) const;
+    int locate(const Point& q);
+    bool inConflict(int t, const Point& q) const;
+    bool earIsValid(const std::vector<int>& ring, std::size_t i) const;
+    int randomInt(int bound);
 };
 
 #endif // DELAUNAY_H
@@ -3,13 +3,32 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include "geometry.h"
 
-struct Point {
-    double x, y;
+// 两条直线的位置关系
+enum LineRelation {
+    UniqueIntersection = 0,  // 交于一点
+    ParallelLines = 1,       // 平行，没有交点
+    CoincidentLines = 2      // 重合
 };
 
-// 求两条直线的交点，输入直线方程的系数
+// 求两条直线的交点，输入直线方程的系数，直线方程为 A x + B y = C
+// 行列式 A1 * B2 - A2 * B1 由 predicates::orient2d 精确判断是否为 0，只有真正平行的直线才视为平行，与系数的量级无关
+// 平行或重合时抛出 std::runtime_error
 Point findIntersection(double A1, double B1, double C1, double A2, double B2, double C2);
 
-#endif // FINDINTERSECTION_H
\ No newline at end of file
+// 不抛出异常的版本：返回两条直线的位置关系，交于一点时交点写入 p，否则 p 的坐标为 NaN
+LineRelation intersectLines(double A1, double B1, double C1, double A2, double B2, double C2, Point& p);
+
+// 批量求交：第 i 对直线为 A1[i] x + B1[i] y = C1[i] 与 A2[i] x + B2[i] y = C2[i]
+// 交点写入 x[i]、y[i]，status[i] 为 LineRelation，没有唯一交点时坐标为 NaN
+// 按 AVX2、SSE2、标量逐级回退，结果与 intersectLines 完全一致
+// threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+void findIntersections(const double* A1, const double* B1, const double* C1,
+                       const double* A2, const double* B2, const double* C2,
+                       size_t n, double* x, double* y, uint8_t* status, int threads = 1);
+
+#endif // FINDINTERSECTION_H
@@ -0,0 +1,132 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <cstddef>
+#include <vector>
+
+// 所有算法共用的几何核心类型
+namespace geom {
+
+// 点，id 为调用者指定的编号，-1 表示未指定
+template <typename T>
+struct Point {
+    T x, y;
+    int id;
+
+    Point(T x = T(), T y = T(), int id = -1) : x(x), y(y), id(id) {}
+
+    Point operator-(const Point& p) const { return Point(x - p.x, y - p.y); }
+
+    double dist2(const Point& p) const {
+        double dx = static_cast<double>(x) - p.x;
+        double dy = static_cast<double>(y) - p.y;
+        return dx * dx + dy * dy;
+    }
+};
+
+// 只读的点序列视图，不拥有数据
+// x、y、id 分别按各自的字节步长取值，既可以指向 Point 数组（AoS），也可以指向 PointSet 的各列（SoA）
+template <typename T>
+class PointView {
+public:
+    PointView() : xs(nullptr), ys(nullptr), ids(nullptr), count(0), stride(0), idStride(0), firstId(0) {}
+
+    // stride、idStride 为相邻两个点的字节间隔，ids 为空时 id 取下标
+    PointView(const T* xs, const T* ys, const int* ids, std::size_t count, std::size_t stride, std::size_t idStride)
+        : xs(reinterpret_cast<const char*>(xs)), ys(reinterpret_cast<const char*>(ys)),
+          ids(reinterpret_cast<const char*>(ids)), count(count), stride(stride), idStride(idStride), firstId(0) {}
+
+    // 视图指向 Point 数组
+    PointView(const Point<T>* points, std::size_t count)
+        : xs(reinterpret_cast<const char*>(&points->x)), ys(reinterpret_cast<const char*>(&points->y)),
+          ids(reinterpret_cast<const char*>(&points->id)), count(count),
+          stride(sizeof(Point<T>)), idStride(sizeof(Point<T>)), firstId(0) {}
+
+    PointView(const std::vector<Point<T>>& points)
+        : PointView(points.data(), points.size()) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T x(std::size_t i) const { return *reinterpret_cast<const T*>(xs + i * stride); }
+    T y(std::size_t i) const { return *reinterpret_cast<const T*>(ys + i * stride); }
+    int id(std::size_t i) const {
+        return ids != nullptr ? *reinterpret_cast<const int*>(ids + i * idStride) : static_cast<int>(firstId + i);
+    }
+
+    Point<T> operator[](std::size_t i) const { return Point<T>(x(i), y(i), id(i)); }
+
+    // 下标 [first, first + n) 的子视图，没有 id 列时 id 仍取在原视图中的下标
+    PointView subview(std::size_t first, std::size_t n) const {
+        PointView view(*this);
+        view.xs += first * stride;
+        view.ys += first * stride;
+        if (ids != nullptr) view.ids += first * idStride;
+        else view.firstId += first;
+        view.count = n;
+        return view;
+    }
+
+private:
+    const char* xs;
+    const char* ys;
+    const char* ids;
+    std::size_t count;
+    std::size_t stride;
+    std::size_t idStride;
+    std::size_t firstId;  // ids 为空时第 0 个点的 id
+};
+
+// 按列存储的点集（SoA），x、y、id 各自连续，适合批量和向量化处理
+template <typename T>
+class PointSet {
+public:
+    std::vector<T> x, y;
+    std::vector<int> id;
+
+    PointSet() {}
+
+    PointSet(const PointView<T>& points) {
+        reserve(points.size());
+        for (std::size_t i = 0; i < points.size(); i++) push_back(points[i]);
+    }
+
+    std::size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void reserve(std::size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        id.reserve(n);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        id.clear();
+    }
+
+    // 点的 id 为 -1 时以下标作为 id
+    void push_back(const Point<T>& p) {
+        id.push_back(p.id >= 0 ? p.id : static_cast<int>(x.size()));
+        x.push_back(p.x);
+        y.push_back(p.y);
+    }
+
+    Point<T> operator[](std::size_t i) const { return Point<T>(x[i], y[i], id[i]); }
+
+    PointView<T> view() const {
+        return PointView<T>(x.data(), y.data(), id.data(), x.size(), sizeof(T), sizeof(int));
+    }
+
+    operator PointView<T>() const { return view(); }
+};
+
+} // namespace geom
+
+// 各算法使用的双精度点
+typedef geom::Point<double> Point;
+typedef geom::PointView<double> PointView;
+typedef geom::PointSet<double> PointSet;
+
+#endif // GEOMETRY_H
@@ -5,12 +5,9 @@
 
 #include <string>
 #include <iostream>
-
-// 定义点
-struct Point {
-    double x;
-    double y;
-};
+#include <cstddef>
+#include <cstdint>
+#include "geometry.h"
 
 // 定义向量
 struct Vector {
@@ -18,10 +15,24 @@ struct Vector {
     double y;
 };
 
-// 函数用于计算 PQ 向量与 v 向量的叉积
+// 函数用于计算 PQ 向量与 v 向量的叉积，符号总是正确的（见 predicates::orient2dDirection）
 double crossProduct(const Point& P, const Point& Q, const Vector& v);
 
 // 函数用于判断点 Q 相对于过点 P 的直线的位置关系
 std::string determinePosition(const Point& P, const Point& Q, const Vector& v);
 
+// 批量判断 n 个点（x 坐标 xs[i]，y 坐标 ys[i]）相对于过点 P、方向为 v 的直线的位置
+// out[i] 为 crossProduct(P, Q, v) 的符号：1 对应 determinePosition 的 above，-1 对应 below，0 为在直线上
+// tolerance 为叉积的阈值，|crossProduct| <= tolerance 时视为在直线上；按距离 d 判断时传入 d * |v|
+// 按 AVX2、SSE2、标量逐级回退，向量内核的符号无法确定时改用 crossProduct 重算，结果完全一致
+// threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+void classifyPositions(const double* xs, const double* ys, size_t n, const Point& P, const Vector& v,
+                       int8_t* out, double tolerance = 0, int threads = 1);
+
+// 与 classifyPositions 相同，结果以位掩码输出：第 i 个点对应 mask[i / 64] 的第 i % 64 位
+// above 中置位的点叉积大于 tolerance，below 中置位的点叉积小于 -tolerance，两者都未置位的点在直线上
+// 掩码长度为 (n + 63) / 64，超出 n 的位为 0；不需要的一侧可以传空指针
+void classifyPositionsMask(const double* xs, const double* ys, size_t n, const Point& P, const Vector& v,
+                           uint64_t* above, uint64_t* below, double tolerance = 0, int threads = 1);
+
 #endif // POINT_LINE_H
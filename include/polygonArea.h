@@ -4,13 +4,22 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstddef>
 #include <stdexcept>
+#include "geometry.h"
 
+// 旧名称，与 Point 相同
+typedef Point _Point;
 
-
-struct _Point {
-    _Point(double x, double y) : x(x), y(y) {}
-    double x, y;
-};
 double polygonArea(const std::vector<_Point>& vertices);
+// 视图中的点按顺序构成多边形
+double polygonArea(const PointView& vertices);
+// 多边形的第 i 个顶点为 points[order[i]]，例如 ConvexHull::hullIndices 的结果
+double polygonArea(const PointView& points, const std::vector<int>& order);
+
+// 批量计算多边形的有向面积，逆时针为正，顺时针为负
+// 顶点按 CSR 存放：第 k 个多边形的顶点为 xs、ys 中下标 [offsets[k], offsets[k + 1]) 的部分，offsets 共 count + 1 项
+// 坐标平移到各多边形的第一个顶点后用补偿求和累加，threads 为 1 时单线程，不大于 0 时使用全局线程池的全部线程
+void polygonAreas(const double* xs, const double* ys, const size_t* offsets, size_t count,
+                  double* areas, int threads = 1);
 #endif // POLYGON_AREA_H
\ No newline at end of file
@@ -0,0 +1,134 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cmath>
+#include <limits>
+#include "geometry.h"
+
+// 自适应精度的几何谓词（Shewchuk 方法）
+// 先用浮点数计算并与静态误差界比较，结果的符号无法确定时才用浮点展开式精确计算，返回值的符号总是正确的
+// 要求 IEEE 754 双精度运算，不能使用 -ffast-math 等改变舍入行为的编译选项
+namespace predicates {
+
+const double EPSILON = std::numeric_limits<double>::epsilon() / 2;  // 2^-53
+const double ORIENT2D_ERROR_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+const double INCIRCLE_ERROR_BOUND = (10.0 + 96.0 * EPSILON) * EPSILON;
+
+// 精确计算，由快速路径在结果不确定时调用
+double orient2dExact(double ax, double ay, double bx, double by, double cx, double cy);
+double orient2dDirectionExact(double px, double py, double vx, double vy, double qx, double qy);
+double crossDirectionsExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+double incircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+// a、b、c 逆时针时为正，顺时针时为负，共线时为 0
+inline double orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    double detLeft = (ax - cx) * (by - cy);
+    double detRight = (ay - cy) * (bx - cx);
+    double det = detLeft - detRight;
+
+    // 两项异号或有一项为 0 时相减不会抵消，结果的符号可靠
+    double detSum;
+    if (detLeft > 0) {
+        if (detRight <= 0) return det;
+        detSum = detLeft + detRight;
+    } else if (detLeft < 0) {
+        if (detRight >= 0) return det;
+        detSum = -detLeft - detRight;
+    } else {
+        return det;
+    }
+
+    double bound = ORIENT2D_ERROR_BOUND * detSum;
+    if (det >= bound || -det >= bound) return det;
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+// d 在逆时针三角形 abc 的外接圆内部时为正，外部为负，四点共圆时为 0；abc 顺时针时符号相反
+inline double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double adx = ax - dx, ady = ay - dy;
+    double bdx = bx - dx, bdy = by - dy;
+    double cdx = cx - dx, cdy = cy - dy;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift +
+                       (std::fabs(cdxady) + std::fabs(adxcdy)) * blift +
+                       (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+    double bound = INCIRCLE_ERROR_BOUND * permanent;
+    if (det > bound || -det > bound) return det;
+    return incircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+// (qx - px) * vy - (qy - py) * vx：q 在过 p、方向为 v 的直线右侧时为正，左侧为负，在直线上为 0
+// 与 orient2d(p, p + v, q) 的符号相反，但不需要计算 p + v，方向向量不会因舍入而改变
+// v 的两个分量不经过减法，误差比 orient2d 小，沿用 ORIENT2D_ERROR_BOUND 偏于保守
+inline double orient2dDirection(double px, double py, double vx, double vy, double qx, double qy) {
+    double detLeft = (qx - px) * vy;
+    double detRight = (qy - py) * vx;
+    double det = detLeft - detRight;
+
+    double detSum;
+    if (detLeft > 0) {
+        if (detRight <= 0) return det;
+        detSum = detLeft + detRight;
+    } else if (detLeft < 0) {
+        if (detRight >= 0) return det;
+        detSum = -detLeft - detRight;
+    } else {
+        return det;
+    }
+
+    double bound = ORIENT2D_ERROR_BOUND * detSum;
+    if (det >= bound || -det >= bound) return det;
+    return orient2dDirectionExact(px, py, vx, vy, qx, qy);
+}
+
+// (b - a) x (d - c)：方向 c -> d 在方向 a -> b 的逆时针一侧时为正，顺时针一侧为负，平行时为 0
+// 与 orient2d 一样是两个差的乘积之差，误差界相同
+inline double crossDirections(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double detLeft = (bx - ax) * (dy - cy);
+    double detRight = (by - ay) * (dx - cx);
+    double det = detLeft - detRight;
+
+    double detSum;
+    if (detLeft > 0) {
+        if (detRight <= 0) return det;
+        detSum = detLeft + detRight;
+    } else if (detLeft < 0) {
+        if (detRight >= 0) return det;
+        detSum = -detLeft - detRight;
+    } else {
+        return det;
+    }
+
+    double bound = ORIENT2D_ERROR_BOUND * detSum;
+    if (det >= bound || -det >= bound) return det;
+    return crossDirectionsExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+inline double orient2d(const Point& a, const Point& b, const Point& c) {
+    return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+inline double crossDirections(const Point& a, const Point& b, const Point& c, const Point& d) {
+    return crossDirections(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+inline double incircle(const Point& a, const Point& b, const Point& c, const Point& d) {
+    return incircle(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+// 返回值的符号：1、0 或 -1
+inline int sign(double value) {
+    return (value > 0) - (value < 0);
+}
+
+} // namespace predicates
+
+#endif // PREDICATES_H
@@ -0,0 +1,27 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// x86 上用 GCC/Clang 的 target 属性编译向量化内核，其他平台只有标量实现
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+// 运行时 SIMD 指令集检测，供各批量接口选择向量化内核
+namespace simd {
+
+enum Level {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2
+};
+
+// 当前 CPU 支持并且允许使用的最高指令集
+Level activeLevel();
+
+// 限制可使用的最高指令集，用于测试和性能对比
+void setMaxLevel(Level level);
+
+} // namespace simd
+
+#endif // SIMD_H
@@ -0,0 +1,91 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <string>
+
+// 热点路径的计数器和计时器，用于分析某次计算慢在哪里
+// 只有以 GEOM_ENABLE_STATS 编译时才会记录（CMake 选项 -DGEOM_ENABLE_STATS=ON），默认关闭，关闭时打点宏为空操作
+// 每个线程写自己的计数器，collect 汇总所有线程（包括已退出的线程），线程池中的任务也会计入
+namespace stats {
+
+enum Counter {
+    DelaunayInCircle,            // merge 中的 inCircle 调用
+    DelaunayIntersection,        // merge 中的 intersection 调用
+    DelaunayHullWalkSteps,       // merge 寻找下公切线时沿凸包移动的步数
+    DelaunayMergeSteps,          // merge 自下而上缝合时新增的边数
+    DelaunayEdgeRemovals,        // 邻接链表中删除的边数
+    SegmentTreeUpdates,          // 线段树区间更新次数
+    SegmentTreeNodeVisits,       // 区间更新访问的节点数
+    PointInPolygonQueries,       // 点与多边形判断的次数
+    PointInPolygonEdgesTested,   // 查询中检查过的边数
+    PointInPolygonBoundaryHits,  // 判定为在边界上的次数
+    COUNTER_COUNT
+};
+
+enum Timer {
+    DelaunayBuild,
+    CalculateArea,
+    CalculateAreaStreaming,
+    ClassifyPoints,
+    CalculateCoverage,
+    TIMER_COUNT
+};
+
+const char* counterName(Counter counter);
+const char* timerName(Timer timer);
+
+// 某一时刻的统计快照
+struct Stats {
+    uint64_t counters[COUNTER_COUNT];
+    uint64_t timerCalls[TIMER_COUNT];
+    uint64_t timerNanoseconds[TIMER_COUNT];
+
+    Stats();
+
+    void clear();
+    Stats& operator+=(const Stats& other);
+    // 两个快照之差，用于统计一段代码的开销
+    Stats operator-(const Stats& before) const;
+
+    // {"enabled": ..., "counters": {...}, "timers": {"name": {"calls": ..., "seconds": ...}}}
+    std::string toJson() const;
+};
+
+// 库编译时是否开启了统计
+bool enabled();
+
+// 汇总所有线程的统计
+Stats collect();
+// 清零所有线程的统计，与正在运行的计算同时调用时结果只是近似的
+void reset();
+
+// 当前线程的计数器加 n
+void add(Counter counter, uint64_t n);
+void addTime(Timer timer, uint64_t nanoseconds);
+
+// 作用域计时器，析构时把经过的时间计入 timer
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer timer);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Timer timer;
+    int64_t start;
+};
+
+} // namespace stats
+
+#ifdef GEOM_ENABLE_STATS
+#define GEOM_STATS_ADD(counter, n) ::stats::add(::stats::counter, (n))
+#define GEOM_STATS_TIMER(timer) ::stats::ScopedTimer geomStatsTimer(::stats::timer)
+#else
+#define GEOM_STATS_ADD(counter, n) ((void)0)
+#define GEOM_STATS_TIMER(timer) ((void)0)
+#endif
+
+#endif // STATS_H
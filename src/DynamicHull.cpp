@@ -0,0 +1,276 @@
+#include "DynamicHull.h"
+#include "predicates.h"
+#include <algorithm>
+#include <stdexcept>
+
+// 链上的方向判断，坐标为已乘 sign 的 (x, y)
+static double orient(double ax, double ay, double bx, double by, double cx, double cy) {
+    return predicates::orient2d(ax, ay, bx, by, cx, cy);
+}
+
+double DynamicHull::Chain::slope(ConstIterator a, ConstIterator b) {
+    return (b->second.y - a->second.y) / (b->first - a->first);
+}
+
+void DynamicHull::Chain::addEdge(Iterator left) {
+    Iterator right = std::next(left);
+    if (right == points.end()) return;
+    edges.insert(std::make_pair(slope(left, right), ConstIterator(left)));
+}
+
+void DynamicHull::Chain::removeEdge(Iterator left) {
+    Iterator right = std::next(left);
+    if (right == points.end()) return;
+    double key = slope(left, right);
+    for (auto e = edges.lower_bound(key); e != edges.end() && e->first == key; ++e) {
+        if (e->second == ConstIterator(left)) {
+            edges.erase(e);
+            return;
+        }
+    }
+}
+
+// 删除一个点及其两侧的边，再连接左右两个点
+void DynamicHull::Chain::erase(Iterator it) {
+    if (journaling) erased.push_back(*it);
+    bool hasLeft = it != points.begin();
+    Iterator left = hasLeft ? std::prev(it) : points.end();
+    if (hasLeft) removeEdge(left);
+    removeEdge(it);
+    points.erase(it);
+    if (hasLeft) addEdge(left);
+}
+
+// 在 hint 之前放入一个点，并连接它与两侧的点
+DynamicHull::Chain::Iterator DynamicHull::Chain::place(Iterator hint, double x, const Vertex& v) {
+    if (hint != points.end() && hint != points.begin()) removeEdge(std::prev(hint));
+    Iterator added = points.insert(hint, std::make_pair(x, v));
+    if (added != points.begin()) addEdge(std::prev(added));
+    addEdge(added);
+    return added;
+}
+
+bool DynamicHull::Chain::insert(const Point& p) {
+    double x = p.x, y = sign * p.y;
+    Change change = {x, false, erased.size()};
+    Iterator it = points.lower_bound(x);
+    bool above = true;
+    if (it != points.end() && it->first == x) {
+        // 同一 x 上只保留最高的点
+        above = y > it->second.y;
+        if (above) {
+            Iterator next = std::next(it);
+            erase(it);
+            it = next;
+        }
+    } else if (it != points.end() && it != points.begin()) {
+        // 在左右两个点之间，位于它们的连线下方或线上时不在上凸链上
+        Iterator left = std::prev(it);
+        above = orient(left->first, left->second.y, it->first, it->second.y, x, y) > 0;
+    }
+    if (!above) {
+        if (journaling) journal.push_back(change);
+        return false;
+    }
+
+    Vertex v = {y, p.id};
+    Iterator added = place(it, x, v);
+    change.inserted = true;
+
+    // 删除两侧不再凸的点，共线的点也删除
+    for (;;) {
+        Iterator right = std::next(added);
+        if (right == points.end() || std::next(right) == points.end()) break;
+        Iterator far = std::next(right);
+        if (orient(x, y, right->first, right->second.y, far->first, far->second.y) < 0) break;
+        erase(right);
+    }
+    while (added != points.begin()) {
+        Iterator left = std::prev(added);
+        if (left == points.begin()) break;
+        Iterator far = std::prev(left);
+        if (orient(far->first, far->second.y, left->first, left->second.y, x, y) < 0) break;
+        erase(left);
+    }
+    if (journaling) journal.push_back(change);
+    return true;
+}
+
+void DynamicHull::Chain::setJournaling(bool on) {
+    journaling = on;
+    journal.clear();
+    erased.clear();
+}
+
+// 删掉最近一次插入的点，再放回它删掉的点，链恢复到插入之前的状态
+void DynamicHull::Chain::undo() {
+    Change change = journal.back();
+    journal.pop_back();
+    if (change.inserted) {
+        bool saved = journaling;
+        journaling = false;
+        erase(points.find(change.x));
+        journaling = saved;
+    }
+    for (size_t i = erased.size(); i > change.erasedBegin; i--) {
+        const std::pair<double, Vertex>& e = erased[i - 1];
+        place(points.lower_bound(e.first), e.first, e.second);
+    }
+    erased.resize(change.erasedBegin);
+}
+
+bool DynamicHull::Chain::below(const Point& q) const {
+    double x = q.x, y = sign * q.y;
+    ConstIterator it = points.lower_bound(x);
+    if (it == points.end()) return false;
+    if (it->first == x) return y <= it->second.y;
+    if (it == points.begin()) return false;
+    ConstIterator left = std::prev(it);
+    return orient(left->first, left->second.y, it->first, it->second.y, x, y) <= 0;
+}
+
+// 上凸链上各边的斜率递减，dx * x + dy * y 在第一条斜率不大于 -dx / dy 的边的左端点处取得最大值
+// 斜率是舍入后的值，几乎共线的相邻边顺序可能颠倒，找到后再向两侧做局部检查
+Point DynamicHull::Chain::extreme(double dx, double dy) const {
+    dy *= sign;
+    auto e = edges.lower_bound(-dx / dy);
+    ConstIterator it = e == edges.end() ? std::prev(points.end()) : e->second;
+    auto value = [dx, dy](ConstIterator v) { return dx * v->first + dy * v->second.y; };
+    for (;;) {
+        ConstIterator next = std::next(it);
+        if (next != points.end() && value(next) > value(it)) {
+            it = next;
+        } else if (it != points.begin() && value(std::prev(it)) > value(it)) {
+            it = std::prev(it);
+        } else {
+            return toPoint(it);
+        }
+    }
+}
+
+void DynamicHull::Chain::append(std::vector<Point>& out, bool reverse) const {
+    if (reverse) {
+        for (ConstIterator it = points.end(); it != points.begin();) out.push_back(toPoint(--it));
+    } else {
+        for (ConstIterator it = points.begin(); it != points.end(); ++it) out.push_back(toPoint(it));
+    }
+}
+
+void DynamicHull::Chain::clear() {
+    points.clear();
+    edges.clear();
+    journal.clear();
+    erased.clear();
+}
+
+bool DynamicHull::insert(const Point& p) {
+    bool changed = upper.insert(p);
+    changed = lower.insert(p) || changed;
+    return changed;
+}
+
+bool DynamicHull::contains(const Point& q) const {
+    return !empty() && upper.below(q) && lower.below(q);
+}
+
+Point DynamicHull::extreme(double dx, double dy) const {
+    if (empty()) throw std::invalid_argument("DynamicHull::extreme: hull is empty");
+    if (dy > 0) return upper.extreme(dx, dy);
+    if (dy < 0) return lower.extreme(dx, dy);
+    if (dx > 0) return upper.back();
+    if (dx < 0) return upper.front();
+    throw std::invalid_argument("DynamicHull::extreme: direction is zero");
+}
+
+std::vector<Point> DynamicHull::vertices() const {
+    std::vector<Point> hull;
+    if (empty()) return hull;
+    // 下凸链从左到右，再接上凸链从右到左，两条链共有的端点只保留一次
+    size_t split = lower.size();
+    lower.append(hull, false);
+    upper.append(hull, true);
+    if (hull[split - 1].y == hull[split].y) hull.erase(hull.begin() + split);
+    if (hull.size() > 1 && hull.front().x == hull.back().x && hull.front().y == hull.back().y) hull.pop_back();
+
+    size_t start = 0;
+    for (size_t i = 1; i < hull.size(); i++) {
+        if (hull[i].y < hull[start].y || (hull[i].y == hull[start].y && hull[i].x < hull[start].x)) start = i;
+    }
+    std::rotate(hull.begin(), hull.begin() + start, hull.end());
+    return hull;
+}
+
+size_t DynamicHull::size() const {
+    if (empty()) return 0;
+    // 两条链的左端点、右端点 x 相同，y 也相同时是同一个点
+    size_t n = upper.size() + lower.size();
+    if (upper.front().y == lower.front().y) n--;
+    if (upper.back().y == lower.back().y) n--;
+    return std::max<size_t>(n, 1);
+}
+
+void DynamicHull::clear() {
+    upper.clear();
+    lower.clear();
+}
+
+void DynamicHull::setJournaling(bool on) {
+    upper.setJournaling(on);
+    lower.setJournaling(on);
+}
+
+void DynamicHull::undo() {
+    upper.undo();
+    lower.undo();
+}
+
+void SlidingWindowHull::push(const Point& p) {
+    if (capacity > 0 && windowSize() >= capacity) popOldest();
+    newer.push_back(p);
+    back.insert(p);
+    mergedValid = false;
+}
+
+void SlidingWindowHull::popOldest() {
+    if (windowSize() == 0) return;
+    if (older.empty()) {
+        // back 中的点从新到旧插入 front，最早的点最后插入，最先被撤销
+        front.clear();
+        front.setJournaling(true);
+        older.assign(newer.rbegin(), newer.rend());
+        for (size_t i = 0; i < older.size(); i++) front.insert(older[i]);
+        newer.clear();
+        back.clear();
+    }
+    older.pop_back();
+    front.undo();
+    mergedValid = false;
+}
+
+const DynamicHull& SlidingWindowHull::mergedHull() const {
+    if (!mergedValid) {
+        std::vector<Point> candidates = front.vertices();
+        std::vector<Point> more = back.vertices();
+        candidates.insert(candidates.end(), more.begin(), more.end());
+        merged.clear();
+        for (size_t i = 0; i < candidates.size(); i++) merged.insert(candidates[i]);
+        mergedValid = true;
+    }
+    return merged;
+}
+
+bool SlidingWindowHull::contains(const Point& q) const {
+    if (front.contains(q) || back.contains(q)) return true;
+    return mergedHull().contains(q);
+}
+
+Point SlidingWindowHull::extreme(double dx, double dy) const {
+    if (front.empty()) return back.extreme(dx, dy);
+    if (back.empty()) return front.extreme(dx, dy);
+    Point a = front.extreme(dx, dy), b = back.extreme(dx, dy);
+    return dx * b.x + dy * b.y > dx * a.x + dy * a.y ? b : a;
+}
+
+std::vector<Point> SlidingWindowHull::vertices() const {
+    return mergedHull().vertices();
+}
@@ -1,4 +1,11 @@
 #include "LineSegmentIntersection.h"
+#include "predicates.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <set>
 
 namespace LineSegmentIntersection {
 
@@ -13,7 +20,7 @@ double max(double a, double b) {
 
 // 计算向量 (P1P2) 和向量 (P1P3) 的叉积
 double crossProduct(const Point& P1, const Point& P2, const Point& P3) {
-    return (P2.x - P1.x) * (P3.y - P1.y) - (P2.y - P1.y) * (P3.x - P1.x);
+    return predicates::orient2d(P1, P2, P3);
 }
 
 // 快速排斥实验，判断两线段各自形成的矩形是否有交集，若没有则两线段一定不相交
@@ -30,7 +37,8 @@ bool crossProductIntersect(const Point& A1, const Point& A2, const Point& B1, co
     double d2 = crossProduct(A1, A2, B2);
     double d3 = crossProduct(B1, B2, A1);
     double d4 = crossProduct(B1, B2, A2);
-    return (d1 * d2 <= 0) && (d3 * d4 <= 0);
+    // 只比较符号，避免乘积下溢为 0 造成误判
+    return (predicates::sign(d1) * predicates::sign(d2) <= 0) && (predicates::sign(d3) * predicates::sign(d4) <= 0);
 }
 
 // 判断两条线段是否相交
@@ -41,4 +49,322 @@ bool segmentsIntersect(const Point& A1, const Point& A2, const Point& B1, const
     return crossProductIntersect(A1, A2, B1, B2);
 }
 
+void segmentsIntersect(const Segment* first, const Segment* second, size_t n, uint8_t* out, int threads) {
+    parallelFor(n, 4096, [first, second, out](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            out[i] = segmentsIntersect(first[i].a, first[i].b, second[i].a, second[i].b) ? 1 : 0;
+        }
+    }, threads);
+}
+
+// 事件点顺序：扫描线自上而下移动，同一高度上自左向右
+struct EventLess {
+    bool operator()(const Point& p, const Point& q) const {
+        return p.y > q.y || (p.y == q.y && p.x < q.x);
+    }
+};
+
+class SweepLine;
+
+// 状态结构中线段的顺序：在当前事件点处从左到右，经过事件点的线段按下方的走向排序
+// 状态结构保存槽位编号，相邻两条线段在舍入后的交点处交换时只需交换槽位中的线段
+struct StatusLess {
+    const SweepLine* sweep;
+    bool operator()(int a, int b) const;
+};
+
+// Bentley-Ottmann 扫描线
+// 每个事件点 p 处理三类线段：以 p 为上端点的 U(p)、以 p 为下端点的 L(p)、内部经过 p 的 C(p)
+// 顺序只用精确谓词判断。交点不能精确表示时，舍入后的点不一定在两条线段上，
+// 这样的交点在相邻线段间记录为交换事件；舍入到已扫过位置的交换在当前事件点完成，
+// 若在当前事件点处两条线段还未交叉则推迟到下一个事件点
+class SweepLine {
+public:
+    static const int PROBE = -1;  // 查找时代表当前事件点的虚拟线段
+
+    explicit SweepLine(const std::vector<Segment>& segments);
+    std::vector<IntersectionPair> run();
+
+    // 线段在当前事件点左边为 -1，经过该点为 0，在右边为 1
+    int side(int s) const;
+    // 线段是否在当前事件点附近穿过扫描线
+    bool near(int s) const;
+    // 比较两条线段在扫描线下方的走向，左侧的更小，水平线段在最右
+    int compareDirection(int a, int b) const;
+
+    Point current;            // 当前事件点
+    std::vector<int> segment;  // 槽位中的线段
+
+private:
+    typedef std::set<int, StatusLess> Status;
+
+    // 事件点：以其为上端点的线段，以及预计在此交换的相邻线段
+    struct Event {
+        std::vector<int> upper;
+        std::vector<std::pair<int, int> > swaps;
+    };
+
+    std::vector<Point> upper, lower;
+    std::map<Point, Event, EventLess> queue;
+    Status status;
+    std::vector<int> slot;                   // 线段所在的槽位
+    std::vector<Status::iterator> handle;    // 槽位在状态结构中的位置
+    std::vector<char> active;                // 线段是否在状态结构中
+    std::vector<IntersectionPair> found;
+
+    void handleEvent(const Point& p, const Event& event);
+    void findNewEvent(int a, int b, const Point& p);
+    void swapAdjacent(int a, int b, const Point& p);
+    void checkNeighbors(int s, const Point& p);
+};
+
+const int SweepLine::PROBE;
+
+bool StatusLess::operator()(int a, int b) const {
+    if (a == b) return false;
+    if (b == SweepLine::PROBE) return sweep->side(sweep->segment[a]) < 0;
+    if (a == SweepLine::PROBE) return sweep->side(sweep->segment[b]) >= 0;
+
+    int sa = sweep->segment[a], sb = sweep->segment[b];
+    int pa = sweep->side(sa), pb = sweep->side(sb);
+    if (pa != pb) return pa < pb;
+
+    // 两条线段都经过当前事件点（或在同一侧，只在舍入的交点附近出现），按下方的走向排序，共线时按编号排序
+    int c = sweep->compareDirection(sa, sb);
+    if (c != 0) return c < 0;
+    return sa < sb;
+}
+
+SweepLine::SweepLine(const std::vector<Segment>& segments)
+    : current(), status(StatusLess{this}) {
+    size_t n = segments.size();
+    upper.resize(n);
+    lower.resize(n);
+    segment.resize(n);
+    slot.resize(n);
+    handle.resize(n);
+    active.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        // 上端点：y 较大，y 相同时 x 较小
+        const Point& a = segments[i].a;
+        const Point& b = segments[i].b;
+        bool aFirst = EventLess()(a, b) || (a.x == b.x && a.y == b.y);
+        upper[i] = aFirst ? a : b;
+        lower[i] = aFirst ? b : a;
+        segment[i] = slot[i] = static_cast<int>(i);
+    }
+}
+
+int SweepLine::side(int s) const {
+    const Point& u = upper[s];
+    const Point& l = lower[s];
+    // 状态结构中的水平线段总在当前高度上且覆盖当前事件点
+    if (u.y == l.y) return l.x < current.x ? -1 : (u.x > current.x ? 1 : 0);
+    // 线段自上而下，走向的逆时针一侧是 x 增大的一侧，事件点在这一侧时线段在它左边
+    double o = predicates::orient2d(u, l, current);
+    return o > 0 ? -1 : (o < 0 ? 1 : 0);
+}
+
+bool SweepLine::near(int s) const {
+    const Point& u = upper[s];
+    const Point& l = lower[s];
+    if (u.y == l.y) return true;
+    double x = u.x + (current.y - u.y) * (l.x - u.x) / (l.y - u.y);
+    return std::fabs(x - current.x) <= 1e-9 * (1.0 + std::fabs(current.x));
+}
+
+int SweepLine::compareDirection(int a, int b) const {
+    bool aFlat = (upper[a].y == lower[a].y), bFlat = (upper[b].y == lower[b].y);
+    if (aFlat || bFlat) return aFlat == bFlat ? 0 : (aFlat ? 1 : -1);
+    // 两者都向下，b 的方向在 a 的逆时针一侧时 a 在左
+    double c = predicates::crossDirections(upper[a], lower[a], upper[b], lower[b]);
+    if (c > 0) return -1;
+    if (c < 0) return 1;
+    return 0;
+}
+
+// 求两条不共线的相交线段的交点，端点落在另一条线段上时直接取该端点
+static bool intersectionPoint(const Point& A1, const Point& A2, const Point& B1, const Point& B2, Point& q) {
+    double d = (A2.x - A1.x) * (B2.y - B1.y) - (A2.y - A1.y) * (B2.x - B1.x);
+    if (d == 0) return false;
+    if (crossProduct(B1, B2, A1) == 0) { q = A1; return true; }
+    if (crossProduct(B1, B2, A2) == 0) { q = A2; return true; }
+    if (crossProduct(A1, A2, B1) == 0) { q = B1; return true; }
+    if (crossProduct(A1, A2, B2) == 0) { q = B2; return true; }
+    double t = ((B1.x - A1.x) * (B2.y - B1.y) - (B1.y - A1.y) * (B2.x - B1.x)) / d;
+    q.x = A1.x + t * (A2.x - A1.x);
+    q.y = A1.y + t * (A2.y - A1.y);
+    return true;
+}
+
+// 相邻的 a（左）与 b（右）若相交且在下方相互靠拢，交点还未经过，报告该交点并安排交换
+// 舍入后的交点不在 p 之后时在当前事件点立即交换
+// 共线重叠的线段不需要新事件，重叠部分的端点本身就是事件点
+void SweepLine::findNewEvent(int a, int b, const Point& p) {
+    if (compareDirection(a, b) <= 0) return;
+    if (!segmentsIntersect(upper[a], lower[a], upper[b], lower[b])) return;
+    Point q;
+    if (!intersectionPoint(upper[a], lower[a], upper[b], lower[b], q)) return;
+    IntersectionPair r = {std::min(a, b), std::max(a, b), q};
+    found.push_back(r);
+    if (EventLess()(p, q)) queue[q].swaps.push_back(std::make_pair(a, b));
+    else swapAdjacent(a, b, p);
+}
+
+// 交换状态结构中相邻且仍在靠拢的 a（左）与 b（右），再检查交换后的邻居
+void SweepLine::swapAdjacent(int a, int b, const Point& p) {
+    if (!active[a] || !active[b]) return;
+    Status::iterator left = handle[slot[a]], right = handle[slot[b]];
+    if (std::next(left) != right || compareDirection(a, b) <= 0) return;
+    // 在 p 处 a 仍严格在 p 左侧而 b 严格在右侧，交点实际在 p 下方，推迟到下一个事件点
+    if (side(a) < side(b) && !queue.empty()) {
+        std::vector<std::pair<int, int> >& swaps = queue.begin()->second.swaps;
+        if (std::find(swaps.begin(), swaps.end(), std::make_pair(a, b)) == swaps.end()) swaps.push_back(std::make_pair(a, b));
+        return;
+    }
+
+    std::swap(segment[slot[a]], segment[slot[b]]);
+    std::swap(slot[a], slot[b]);
+    checkNeighbors(b, p);
+    checkNeighbors(a, p);
+}
+
+// 检查 s 与左右两侧邻居
+void SweepLine::checkNeighbors(int s, const Point& p) {
+    if (s < 0 || !active[s]) return;
+    Status::iterator it = handle[slot[s]];
+    if (it != status.begin()) findNewEvent(segment[*std::prev(it)], s, p);
+    it = handle[slot[s]];
+    Status::iterator next = std::next(it);
+    if (next != status.end()) findNewEvent(s, segment[*next], p);
+}
+
+void SweepLine::handleEvent(const Point& p, const Event& event) {
+    current = p;
+
+    // 舍入后的交点不一定在两条线段上，它们不属于 C(p)，先交换，使状态结构与 p 处的位置一致
+    for (size_t i = 0; i < event.swaps.size(); ++i) {
+        swapAdjacent(event.swaps[i].first, event.swaps[i].second, p);
+    }
+
+    // 舍入的交点附近，状态结构中的顺序可能与线段相对 p 的位置不符：相互颠倒的两条线段已在 p 上方交叉。
+    // 把 p 附近的一段按位置稳定排序并报告颠倒的线段对，之后经过 p 的线段是连续的一段，重新插入时不会越过其他线段
+    // 颠倒的线段都在 p 附近穿过扫描线，这一段包括穿过位置与 p 足够近的线段；近似距离只决定排序的范围
+    Status::iterator begin = status.lower_bound(PROBE), end = begin;
+    while (begin != status.begin() && (side(segment[*std::prev(begin)]) >= 0 || near(segment[*std::prev(begin)]))) --begin;
+    while (end != status.end() && (side(segment[*end]) <= 0 || near(segment[*end]))) ++end;
+
+    std::vector<int> window, position;
+    bool reordered = false;
+    for (Status::iterator it = begin; it != end; ++it) {
+        window.push_back(segment[*it]);
+        position.push_back(side(segment[*it]));
+    }
+    for (size_t i = 1; i < window.size(); ++i) {
+        for (size_t j = i; j > 0 && position[j - 1] > position[j]; --j) {
+            int a = window[j - 1], b = window[j];
+            Point q;
+            if (segmentsIntersect(upper[a], lower[a], upper[b], lower[b]) &&
+                intersectionPoint(upper[a], lower[a], upper[b], lower[b], q)) {
+                IntersectionPair r = {std::min(a, b), std::max(a, b), q};
+                found.push_back(r);
+            }
+            std::swap(window[j - 1], window[j]);
+            std::swap(position[j - 1], position[j]);
+            reordered = true;
+        }
+    }
+    size_t k = 0;
+    for (Status::iterator it = begin; it != end; ++it, ++k) {
+        segment[*it] = window[k];
+        slot[window[k]] = *it;
+    }
+
+    std::vector<int> C, L;
+    for (size_t i = 0; i < window.size(); ++i) {
+        int s = window[i];
+        if (position[i] != 0) continue;
+        if (lower[s].x == p.x && lower[s].y == p.y) L.push_back(s);
+        else C.push_back(s);
+    }
+
+    // 经过 p 的线段两两相交，交点即 p
+    const std::vector<int>& U = event.upper;
+    std::vector<int> all(U);
+    all.insert(all.end(), C.begin(), C.end());
+    all.insert(all.end(), L.begin(), L.end());
+    for (size_t i = 0; i < all.size(); ++i) {
+        for (size_t j = i + 1; j < all.size(); ++j) {
+            int a = all[i], b = all[j];
+            if (!segmentsIntersect(upper[a], lower[a], upper[b], lower[b])) continue;
+            IntersectionPair r = {std::min(a, b), std::max(a, b), p};
+            found.push_back(r);
+        }
+    }
+
+    // 删除 L(p) 与 C(p)，再按 p 下方的顺序插入 U(p) 与 C(p)，C(p) 的顺序因此反转
+    for (size_t i = 0; i < C.size(); ++i) status.erase(handle[slot[C[i]]]);
+    for (size_t i = 0; i < L.size(); ++i) {
+        status.erase(handle[slot[L[i]]]);
+        active[L[i]] = 0;
+    }
+
+    std::vector<int> inserted;
+    for (size_t i = 0; i < U.size(); ++i) {
+        int s = U[i];
+        if (lower[s].x == p.x && lower[s].y == p.y) continue;  // 退化为点的线段
+        inserted.push_back(s);
+    }
+    inserted.insert(inserted.end(), C.begin(), C.end());
+    for (size_t i = 0; i < inserted.size(); ++i) {
+        int s = inserted[i];
+        handle[slot[s]] = status.insert(slot[s]).first;
+        active[s] = 1;
+    }
+
+    // 插入的线段与重新排序过的一段都可能有了新的邻居
+    for (size_t i = 0; i < inserted.size(); ++i) checkNeighbors(inserted[i], p);
+    if (reordered) {
+        for (size_t i = 0; i < window.size(); ++i) checkNeighbors(window[i], p);
+    }
+    if (inserted.empty()) {
+        Status::iterator right = status.lower_bound(PROBE);
+        if (right != status.end() && right != status.begin()) {
+            findNewEvent(segment[*std::prev(right)], segment[*right], p);
+        }
+    }
+}
+
+std::vector<IntersectionPair> SweepLine::run() {
+    for (size_t i = 0; i < upper.size(); ++i) {
+        queue[upper[i]].upper.push_back(static_cast<int>(i));
+        queue[lower[i]];
+    }
+    while (!queue.empty()) {
+        std::map<Point, Event, EventLess>::iterator it = queue.begin();
+        Point p = it->first;
+        Event event;
+        event.upper.swap(it->second.upper);
+        event.swaps.swap(it->second.swaps);
+        queue.erase(it);
+        handleEvent(p, event);
+    }
+
+    // 每对线段只保留扫描顺序中第一次报告的交点
+    std::stable_sort(found.begin(), found.end(), [](const IntersectionPair& a, const IntersectionPair& b) {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+    std::vector<IntersectionPair> result;
+    for (size_t i = 0; i < found.size(); ++i) {
+        if (!result.empty() && result.back().first == found[i].first && result.back().second == found[i].second) continue;
+        result.push_back(found[i]);
+    }
+    return result;
+}
+
+std::vector<IntersectionPair> findAllIntersections(const std::vector<Segment>& segments) {
+    SweepLine sweep(segments);
+    return sweep.run();
+}
+
 } // namespace LineSegmentIntersection
\ No newline at end of file
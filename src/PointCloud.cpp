@@ -0,0 +1,303 @@
+#include "PointCloud.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define POINT_CLOUD_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PointCloud {
+
+static_assert(sizeof(Header) == 128, "Header must be 128 bytes");
+static_assert(sizeof(int) == sizeof(int32_t), "PointView ids must match the int32 id column");
+
+static const char MAGIC[8] = {'G', 'E', 'O', 'M', 'P', 'T', 'S', '\0'};
+static const uint64_t COLUMN_ALIGNMENT = 4096;
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+static bool littleEndian() {
+    uint32_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static std::runtime_error failure(const std::string& what, const std::string& path) {
+    std::string message = "PointCloud: " + what + " " + path;
+    if (errno != 0) message += ": " + std::string(strerror(errno));
+    return std::runtime_error(message);
+}
+
+// 按块把一列写入文件，get(i) 取第 i 个点的值，视图可以是任意步长，不要求调用者先转成连续数组
+template <typename T, typename Get>
+static bool writeColumn(FILE* file, size_t count, const Get& get) {
+    const size_t block = 1 << 16;
+    std::vector<T> buffer(std::min(count, block));
+    for (size_t first = 0; first < count; first += block) {
+        size_t n = std::min(block, count - first);
+        for (size_t i = 0; i < n; i++) buffer[i] = get(first + i);
+        if (fwrite(buffer.data(), sizeof(T), n, file) != n) return false;
+    }
+    return true;
+}
+
+// 从当前位置补零到 offset
+static bool padTo(FILE* file, uint64_t position, uint64_t offset) {
+    static const char zeros[COLUMN_ALIGNMENT] = {};
+    return offset == position || fwrite(zeros, 1, offset - position, file) == offset - position;
+}
+
+void write(const std::string& path, const PointView& points, bool withIds) {
+    if (!littleEndian()) throw std::runtime_error("PointCloud: big-endian hosts are not supported");
+    size_t n = points.size();
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.flags = withIds ? HAS_IDS : 0;
+    header.count = n;
+    header.xOffset = alignUp(sizeof(Header));
+    header.yOffset = alignUp(header.xOffset + n * sizeof(double));
+    header.idOffset = withIds ? alignUp(header.yOffset + n * sizeof(double)) : 0;
+    header.minX = header.minY = std::numeric_limits<double>::infinity();
+    header.maxX = header.maxY = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++) {
+        double x = points.x(i), y = points.y(i);
+        header.minX = std::min(header.minX, x);
+        header.maxX = std::max(header.maxX, x);
+        header.minY = std::min(header.minY, y);
+        header.maxY = std::max(header.maxY, y);
+    }
+
+    errno = 0;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) throw failure("cannot create", path);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              padTo(file, sizeof(Header), header.xOffset) &&
+              writeColumn<double>(file, n, [&](size_t i) { return points.x(i); }) &&
+              padTo(file, header.xOffset + n * sizeof(double), header.yOffset) &&
+              writeColumn<double>(file, n, [&](size_t i) { return points.y(i); });
+    if (ok && withIds) {
+        ok = padTo(file, header.yOffset + n * sizeof(double), header.idOffset) &&
+             writeColumn<int32_t>(file, n, [&](size_t i) { return static_cast<int32_t>(points.id(i)); });
+    }
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        remove(path.c_str());
+        throw failure("failed to write", path);
+    }
+}
+
+MappedFile::MappedFile()
+    : data(nullptr), length(0), mapped(false), count(0), xs(nullptr), ys(nullptr), ids(nullptr) {}
+
+MappedFile::MappedFile(const std::string& path) : MappedFile() {
+    open(path);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) : MappedFile() {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        close();
+        data = other.data;
+        length = other.length;
+        mapped = other.mapped;
+        count = other.count;
+        xs = other.xs;
+        ys = other.ys;
+        ids = other.ids;
+        other.data = nullptr;
+        other.close();
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+#ifdef POINT_CLOUD_MMAP
+        if (mapped) munmap(const_cast<char*>(data), length);
+#endif
+        if (!mapped) delete[] data;
+    }
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    count = 0;
+    xs = ys = nullptr;
+    ids = nullptr;
+}
+
+// 检查一列是否完整地位于文件内，并且按元素大小对齐
+static bool columnFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t length) {
+    if (offset < sizeof(Header) || offset % elementSize != 0 || offset > length) return false;
+    return count <= (length - offset) / elementSize;
+}
+
+void MappedFile::open(const std::string& path) {
+    close();
+    if (!littleEndian()) throw std::runtime_error("PointCloud: big-endian hosts are not supported");
+
+    errno = 0;
+#ifdef POINT_CLOUD_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw failure("cannot open", path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw failure("cannot stat", path);
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    if (bytes < sizeof(Header)) {
+        ::close(fd);
+        errno = 0;
+        throw failure("file too short:", path);
+    }
+    void* address = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) throw failure("cannot map", path);
+    data = static_cast<const char*>(address);
+    mapped = true;
+#else
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) throw failure("cannot open", path);
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    size_t bytes = end > 0 ? static_cast<size_t>(end) : 0;
+    if (bytes < sizeof(Header)) {
+        fclose(file);
+        errno = 0;
+        throw failure("file too short:", path);
+    }
+    // new 分配的内存按 double 对齐，各列偏移是 4096 的倍数，读入后同样满足对齐要求
+    char* buffer = new char[bytes];
+    bool ok = fread(buffer, 1, bytes, file) == bytes;
+    fclose(file);
+    if (!ok) {
+        delete[] buffer;
+        throw failure("failed to read", path);
+    }
+    data = buffer;
+    mapped = false;
+#endif
+    length = bytes;
+
+    const Header& h = header();
+    std::string problem;
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        problem = "not a point cloud file:";
+    } else if (h.version == 0 || h.version > FORMAT_VERSION) {
+        problem = "unsupported format version " + std::to_string(h.version) + " in";
+    } else if (h.count > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        problem = "too many points in";
+    } else if (!columnFits(h.xOffset, h.count, sizeof(double), length) ||
+               !columnFits(h.yOffset, h.count, sizeof(double), length) ||
+               ((h.flags & HAS_IDS) != 0 && !columnFits(h.idOffset, h.count, sizeof(int32_t), length))) {
+        problem = "truncated or corrupt file:";
+    }
+    if (!problem.empty()) {
+        close();
+        errno = 0;
+        throw failure(problem, path);
+    }
+
+    count = static_cast<size_t>(h.count);
+    xs = reinterpret_cast<const double*>(data + h.xOffset);
+    ys = reinterpret_cast<const double*>(data + h.yOffset);
+    ids = (h.flags & HAS_IDS) != 0 ? reinterpret_cast<const int32_t*>(data + h.idOffset) : nullptr;
+}
+
+PointView MappedFile::view() const {
+    return PointView(xs, ys, ids, count, sizeof(double), sizeof(int32_t));
+}
+
+PointView MappedFile::view(size_t first, size_t n) const {
+    first = std::min(first, count);
+    return view().subview(first, std::min(n, count - first));
+}
+
+void MappedFile::adviseRange(size_t first, size_t n, int advice) const {
+#ifdef POINT_CLOUD_MMAP
+    if (!mapped || first >= count || n == 0) return;
+    n = std::min(n, count - first);
+    const long page = sysconf(_SC_PAGESIZE);
+    // madvise 要求起始地址按页对齐，范围向外扩展到整页
+    auto apply = [&](const char* begin, const char* end) {
+        uintptr_t from = reinterpret_cast<uintptr_t>(begin) / page * page;
+        uintptr_t to = reinterpret_cast<uintptr_t>(end);
+        madvise(reinterpret_cast<void*>(from), to - from, advice);
+    };
+    apply(reinterpret_cast<const char*>(xs + first), reinterpret_cast<const char*>(xs + first + n));
+    apply(reinterpret_cast<const char*>(ys + first), reinterpret_cast<const char*>(ys + first + n));
+    if (ids != nullptr) {
+        apply(reinterpret_cast<const char*>(ids + first), reinterpret_cast<const char*>(ids + first + n));
+    }
+#else
+    (void)first;
+    (void)n;
+    (void)advice;
+#endif
+}
+
+void MappedFile::advise(Access access) const {
+#ifdef POINT_CLOUD_MMAP
+    if (!mapped) return;
+    int advice = access == Sequential ? MADV_SEQUENTIAL : access == Random ? MADV_RANDOM : MADV_NORMAL;
+    madvise(const_cast<char*>(data), length, advice);
+#else
+    (void)access;
+#endif
+}
+
+void MappedFile::prefetch(size_t first, size_t n) const {
+#ifdef POINT_CLOUD_MMAP
+    adviseRange(first, n, MADV_WILLNEED);
+#else
+    (void)first;
+    (void)n;
+#endif
+}
+
+void MappedFile::release(size_t first, size_t n) const {
+#ifdef POINT_CLOUD_MMAP
+    // 文件映射是只读共享的，MADV_DONTNEED 只丢弃本进程的页表项，页缓存中的数据不受影响
+    adviseRange(first, n, MADV_DONTNEED);
+#else
+    (void)first;
+    (void)n;
+#endif
+}
+
+void MappedFile::forEachChunk(size_t chunkPoints, const std::function<void(const PointView&, size_t)>& visit,
+                              bool releaseProcessed) const {
+    if (chunkPoints == 0) throw std::invalid_argument("PointCloud: chunk size must be positive");
+    if (count > 0) prefetch(0, chunkPoints);
+    for (size_t first = 0; first < count; first += chunkPoints) {
+        size_t n = std::min(chunkPoints, count - first);
+        if (first + n < count) prefetch(first + n, chunkPoints);
+        visit(view(first, n), first);
+        // 块的边界不一定在页边界上，与下一块共用的页被释放后再访问只会从页缓存重新映射
+        if (releaseProcessed) release(first, n);
+    }
+}
+
+} // namespace PointCloud
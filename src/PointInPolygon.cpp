@@ -1,20 +1,43 @@
 #include "PointInPolygon.h"
+#include "simd.h"
+#include "predicates.h"
+#include "stats.h"
+#include "ThreadPool.h"
+#include <climits>
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 namespace PointInPolygon {
 
-// 判断点是否在线段上
+// 判断点是否在线段上：在包围盒内且与端点精确共线
 bool isPointOnSegment(const Point& p, const Point& v1, const Point& v2) {
     double minX = std::min(v1.x, v2.x);
     double maxX = std::max(v1.x, v2.x);
     double minY = std::min(v1.y, v2.y);
     double maxY = std::max(v1.y, v2.y);
     bool onSegment = (p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY &&
-                      std::fabs((v2.y - v1.y) * (p.x - v1.x) - (v2.x - v1.x) * (p.y - v1.y)) < 1e-9);
+                      predicates::orient2d(v1, v2, p) == 0);
     return onSegment;
 }
 
+// 跨越 pt.y 的边 v1 -> v2 是否与向右的射线相交
+// orientation 为 orient2d(v1, v2, pt)：向上的边要求点在左侧，向下的边要求点在右侧
+// 点在边上时 orientation 为 0，调用前已按边界处理
+static inline bool crossesRay(double orientation, bool upward) {
+    return upward ? orientation > 0 : orientation < 0;
+}
+
+// 统计一次查询：检查过的边数，以及是否落在边界上
+static inline void countQuery(size_t edges, bool onBoundary) {
+    GEOM_STATS_ADD(PointInPolygonQueries, 1);
+    GEOM_STATS_ADD(PointInPolygonEdgesTested, edges);
+    GEOM_STATS_ADD(PointInPolygonBoundaryHits, onBoundary ? 1 : 0);
+    (void)edges;
+    (void)onBoundary;
+}
+
 // 光线投射算法，射线默认向右侧发射
 bool isPointInPolygonRayCasting(const Point& pt, const std::vector<Point>& polygon) {
     int intersectCount = 0; // 交点计数
@@ -24,25 +47,23 @@ bool isPointInPolygonRayCasting(const Point& pt, const std::vector<Point>& polyg
 
         // 检查点是否在边界上
         if (isPointOnSegment(pt, v1, v2)) {
+            countQuery(i + 1, true);
             return true;
         }
 
         if ((v1.y > pt.y) != (v2.y > pt.y)) {
-            double slope = (v2.x - v1.x) / (v2.y - v1.y);
-            double x = v1.x + slope * (pt.y - v1.y);
-            if (x > pt.x) {
+            if (crossesRay(predicates::orient2d(v1, v2, pt), v2.y > v1.y)) {
                 intersectCount++; // 交点计数加1
             }
         }
     }
+    countQuery(polygon.size(), false);
     // 如果交点数为奇数，点在多边形内
     return (intersectCount % 2) == 1;
 }
 // 计算方向
 int computeOrientation(const Point& p, const Point& q, const Point& r) {
-    double val = (q.x - p.x) * (r.y - p.y) - (q.y - p.y) * (r.x - p.x);
-    if (val == 0) return 0;  // 共线
-    return (val > 0) ? 1 : -1; // 顺时针 或 逆时针
+    return predicates::sign(predicates::orient2d(p, q, r));  // 0 共线，1 逆时针，-1 顺时针
 }
 
 // 回转数算法
@@ -55,6 +76,7 @@ bool isPointInPolygonWindingNumber(const Point& pt, const std::vector<Point>& po
 
         // 检查点是否在边界上
         if (isPointOnSegment(pt, v1, v2)) {
+            countQuery(i + 1, true);
             return true; // 点在边界上
         }
 
@@ -70,9 +92,477 @@ bool isPointInPolygonWindingNumber(const Point& pt, const std::vector<Point>& po
         }
     }
 
+    countQuery(polygon.size(), false);
     // 如果回转数不为0，点在多边形内；否则在外部
     return windingNumber != 0;
 }
 
+// 多边形边的 SoA 存储，长度补齐到 4 的倍数
+// 补齐部分的坐标为 NaN，所有比较均为假，既不会相交也不会落在边上
+struct EdgeArrays {
+    std::vector<double> x1, y1, x2, y2;
+    std::vector<double> minX, maxX, minY, maxY;
+    size_t count;   // 实际边数
+    size_t padded;  // 补齐后的边数
+};
+
+static void buildEdgeArrays(const std::vector<Point>& polygon, EdgeArrays& e) {
+    size_t n = polygon.size();
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    e.count = n;
+    e.padded = (n + 3) & ~static_cast<size_t>(3);
+    std::vector<double>* arrays[] = {&e.x1, &e.y1, &e.x2, &e.y2,
+                                     &e.minX, &e.maxX, &e.minY, &e.maxY};
+    for (size_t k = 0; k < sizeof(arrays) / sizeof(arrays[0]); ++k) {
+        arrays[k]->assign(e.padded, nan);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const Point& v1 = polygon[i];
+        const Point& v2 = polygon[i + 1 < n ? i + 1 : 0];
+        e.x1[i] = v1.x;
+        e.y1[i] = v1.y;
+        e.x2[i] = v2.x;
+        e.y2[i] = v2.y;
+        e.minX[i] = std::min(v1.x, v2.x);
+        e.maxX[i] = std::max(v1.x, v2.x);
+        e.minY[i] = std::min(v1.y, v2.y);
+        e.maxY[i] = std::max(v1.y, v2.y);
+    }
+}
+
+// 标量内核，判断方式与 isPointOnSegment 和光线投射完全相同
+// 内核直接接收点的坐标，批量接口从视图中逐个取出，不先复制成 Point 数组
+static uint8_t classifyScalar(double x, double y, const EdgeArrays& e) {
+    int intersectCount = 0;
+    for (size_t i = 0; i < e.count; ++i) {
+        if (!(y >= e.minY[i] && y <= e.maxY[i])) continue;
+        double o = predicates::orient2d(e.x1[i], e.y1[i], e.x2[i], e.y2[i], x, y);
+        if (x >= e.minX[i] && x <= e.maxX[i] && o == 0) {
+            return OnBoundary;
+        }
+        if ((e.y1[i] > y) != (e.y2[i] > y)) {
+            if (crossesRay(o, e.y2[i] > e.y1[i])) intersectCount++;
+        }
+    }
+    return (intersectCount % 2) == 1 ? Inside : Outside;
+}
+
+// 向量内核算出 orient2d 的近似值后，对误差界内无法确定符号的边逐个精确计算，修正正负号位掩码
+static void refineSigns(double x, double y, const EdgeArrays& e, size_t first, int unsure, int& pos, int& neg) {
+    while (unsure) {
+        int k = __builtin_ctz(unsure);
+        unsure &= unsure - 1;
+        size_t i = first + k;
+        int s = predicates::sign(predicates::orient2d(e.x1[i], e.y1[i], e.x2[i], e.y2[i], x, y));
+        int bit = 1 << k;
+        pos = (pos & ~bit) | (s > 0 ? bit : 0);
+        neg = (neg & ~bit) | (s < 0 ? bit : 0);
+    }
+}
+
+#ifdef SIMD_X86
+// SSE2 内核，每次处理 2 条边
+__attribute__((target("sse2")))
+static uint8_t classifySSE2(double x, double y, const EdgeArrays& e) {
+    const __m128d px = _mm_set1_pd(x);
+    const __m128d py = _mm_set1_pd(y);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d errBound = _mm_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    const __m128d zero = _mm_setzero_pd();
+    int intersectCount = 0;
+    for (size_t i = 0; i < e.padded; i += 2) {
+        // 只有 y 范围包含查询点的边才可能相交或经过该点，整组都不满足时直接跳过
+        __m128d inY = _mm_and_pd(_mm_cmpge_pd(py, _mm_loadu_pd(&e.minY[i])),
+                                 _mm_cmple_pd(py, _mm_loadu_pd(&e.maxY[i])));
+        int inYBits = _mm_movemask_pd(inY);
+        if (!inYBits) continue;
+
+        __m128d x1 = _mm_loadu_pd(&e.x1[i]);
+        __m128d y1 = _mm_loadu_pd(&e.y1[i]);
+        __m128d x2 = _mm_loadu_pd(&e.x2[i]);
+        __m128d y2 = _mm_loadu_pd(&e.y2[i]);
+
+        // orient2d(v1, v2, pt) 的快速路径，与 predicates::orient2d 的计算顺序相同
+        __m128d l = _mm_mul_pd(_mm_sub_pd(x1, px), _mm_sub_pd(y2, py));
+        __m128d r = _mm_mul_pd(_mm_sub_pd(y1, py), _mm_sub_pd(x2, px));
+        __m128d det = _mm_sub_pd(l, r);
+        __m128d bound = _mm_mul_pd(errBound, _mm_add_pd(_mm_and_pd(l, absMask), _mm_and_pd(r, absMask)));
+        int pos = _mm_movemask_pd(_mm_cmpgt_pd(det, zero));
+        int neg = _mm_movemask_pd(_mm_cmplt_pd(det, zero));
+        int unsure = _mm_movemask_pd(_mm_cmplt_pd(_mm_and_pd(det, absMask), bound)) & inYBits;
+        if (unsure) refineSigns(x, y, e, i, unsure, pos, neg);
+
+        // 点在线段上：包围盒内且精确共线
+        __m128d inBox = _mm_and_pd(inY, _mm_and_pd(_mm_cmpge_pd(px, _mm_loadu_pd(&e.minX[i])),
+                                                   _mm_cmple_pd(px, _mm_loadu_pd(&e.maxX[i]))));
+        if (_mm_movemask_pd(inBox) & ~(pos | neg)) return OnBoundary;
+
+        // 射线相交：边跨越查询点所在的水平线，向上的边点在左侧，向下的边点在右侧
+        int straddle = _mm_movemask_pd(_mm_xor_pd(_mm_cmpgt_pd(y1, py), _mm_cmpgt_pd(y2, py)));
+        int up = _mm_movemask_pd(_mm_cmpgt_pd(y2, y1));
+        intersectCount += __builtin_popcount(straddle & ((pos & up) | (neg & ~up)));
+    }
+    return (intersectCount % 2) == 1 ? Inside : Outside;
+}
+
+// AVX2 内核，每次处理 4 条边
+__attribute__((target("avx2")))
+static uint8_t classifyAVX2(double x, double y, const EdgeArrays& e) {
+    const __m256d px = _mm256_set1_pd(x);
+    const __m256d py = _mm256_set1_pd(y);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d errBound = _mm256_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    const __m256d zero = _mm256_setzero_pd();
+    int intersectCount = 0;
+    for (size_t i = 0; i < e.padded; i += 4) {
+        __m256d inY = _mm256_and_pd(_mm256_cmp_pd(py, _mm256_loadu_pd(&e.minY[i]), _CMP_GE_OQ),
+                                    _mm256_cmp_pd(py, _mm256_loadu_pd(&e.maxY[i]), _CMP_LE_OQ));
+        int inYBits = _mm256_movemask_pd(inY);
+        if (!inYBits) continue;
+
+        __m256d x1 = _mm256_loadu_pd(&e.x1[i]);
+        __m256d y1 = _mm256_loadu_pd(&e.y1[i]);
+        __m256d x2 = _mm256_loadu_pd(&e.x2[i]);
+        __m256d y2 = _mm256_loadu_pd(&e.y2[i]);
+
+        // 不使用 FMA，保证近似值的误差在 ORIENT2D_ERROR_BOUND 的推导范围内
+        __m256d l = _mm256_mul_pd(_mm256_sub_pd(x1, px), _mm256_sub_pd(y2, py));
+        __m256d r = _mm256_mul_pd(_mm256_sub_pd(y1, py), _mm256_sub_pd(x2, px));
+        __m256d det = _mm256_sub_pd(l, r);
+        __m256d bound = _mm256_mul_pd(errBound, _mm256_add_pd(_mm256_and_pd(l, absMask), _mm256_and_pd(r, absMask)));
+        int pos = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_GT_OQ));
+        int neg = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_LT_OQ));
+        int unsure = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_and_pd(det, absMask), bound, _CMP_LT_OQ)) & inYBits;
+        if (unsure) refineSigns(x, y, e, i, unsure, pos, neg);
+
+        __m256d inBox = _mm256_and_pd(inY, _mm256_and_pd(_mm256_cmp_pd(px, _mm256_loadu_pd(&e.minX[i]), _CMP_GE_OQ),
+                                                         _mm256_cmp_pd(px, _mm256_loadu_pd(&e.maxX[i]), _CMP_LE_OQ)));
+        if (_mm256_movemask_pd(inBox) & ~(pos | neg)) return OnBoundary;
+
+        int straddle = _mm256_movemask_pd(_mm256_xor_pd(_mm256_cmp_pd(y1, py, _CMP_GT_OQ),
+                                                        _mm256_cmp_pd(y2, py, _CMP_GT_OQ)));
+        int up = _mm256_movemask_pd(_mm256_cmp_pd(y2, y1, _CMP_GT_OQ));
+        intersectCount += __builtin_popcount(straddle & ((pos & up) | (neg & ~up)));
+    }
+    return (intersectCount % 2) == 1 ? Inside : Outside;
+}
+#endif
+
+// 按当前指令集选择内核，对下标 [begin, end) 的点逐个分类
+static void classifyWithKernel(const PointView& pts, size_t begin, size_t end, const EdgeArrays& edges, uint8_t* out) {
+    simd::Level level = simd::activeLevel();
+#ifdef SIMD_X86
+    if (level == simd::AVX2) {
+        for (size_t i = begin; i < end; ++i) out[i] = classifyAVX2(pts.x(i), pts.y(i), edges);
+        return;
+    }
+    if (level == simd::SSE2) {
+        for (size_t i = begin; i < end; ++i) out[i] = classifySSE2(pts.x(i), pts.y(i), edges);
+        return;
+    }
+#endif
+    (void)level;
+    for (size_t i = begin; i < end; ++i) out[i] = classifyScalar(pts.x(i), pts.y(i), edges);
+}
+
+// 统计一批查询，不在内核中打点：每个点按检查了全部边计，在边界上提前结束的点也一样
+static void countBatch(const uint8_t* out, size_t n, const EdgeArrays& edges) {
+#ifdef GEOM_ENABLE_STATS
+    size_t onBoundary = 0;
+    for (size_t i = 0; i < n; ++i) onBoundary += out[i] == OnBoundary;
+    GEOM_STATS_ADD(PointInPolygonQueries, n);
+    GEOM_STATS_ADD(PointInPolygonEdgesTested, n * edges.count);
+    GEOM_STATS_ADD(PointInPolygonBoundaryHits, onBoundary);
+#else
+    (void)out;
+    (void)n;
+    (void)edges;
+#endif
+}
+
+// 每块约检查 2^16 条边，多边形越大块越小
+static size_t pointGrain(const EdgeArrays& edges) {
+    return std::max<size_t>(16, (static_cast<size_t>(1) << 16) / std::max<size_t>(1, edges.count));
+}
+
+// 批量光线投射
+void classifyPoints(const Point* pts, size_t n, const std::vector<Point>& polygon, uint8_t* out, int threads) {
+    classifyPoints(PointView(pts, n), polygon, out, threads);
+}
+
+// 边只构建一次，内核直接从视图读取坐标
+void classifyPoints(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out, int threads) {
+    GEOM_STATS_TIMER(ClassifyPoints);
+    EdgeArrays edges;
+    buildEdgeArrays(polygon, edges);
+    parallelFor(pts.size(), pointGrain(edges), [&pts, &edges, out](size_t begin, size_t end) {
+        classifyWithKernel(pts, begin, end, edges, out);
+    }, threads);
+    countBatch(out, pts.size(), edges);
+}
+
+void isPointInPolygonRayCasting(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out, int threads) {
+    classifyPoints(pts, polygon, out, threads);
+    for (size_t i = 0; i < pts.size(); ++i) out[i] = out[i] != Outside;
+}
+
+// PreparedPolygon::containsWindingNumber 与单点版本结果一致，边按 y 分桶后每个点只检查附近的边
+// 查询很少时分桶的开销超过节省的时间，直接逐个调用单点版本
+void isPointInPolygonWindingNumber(const PointView& pts, const std::vector<Point>& polygon, uint8_t* out,
+                                   int threads) {
+    const size_t minPreparedQueries = 16;
+    if (pts.size() < minPreparedQueries) {
+        size_t grain = std::max<size_t>(1, (static_cast<size_t>(1) << 16) / std::max<size_t>(1, polygon.size()));
+        parallelFor(pts.size(), grain, [&pts, &polygon, out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) out[i] = isPointInPolygonWindingNumber(pts[i], polygon);
+        }, threads);
+        return;
+    }
+    PreparedPolygon prepared(polygon);
+    parallelFor(pts.size(), 1024, [&pts, &prepared, out](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) out[i] = prepared.containsWindingNumber(pts[i]);
+    }, threads);
+}
+
+// 构建预处理多边形：计算每条边的数据，并把边放入它在 y 方向上覆盖的所有桶中
+PreparedPolygon::PreparedPolygon(const std::vector<Point>& polygon)
+    : PreparedPolygon(PointView(polygon)) {}
+
+PreparedPolygon::PreparedPolygon(const PointView& polygon)
+    : minY(0), maxY(0), bucketScale(0), bucketCount(0) {
+    size_t n = polygon.size();
+    if (n == 0) return;
+
+    edges.resize(n);
+    minY = maxY = polygon.y(0);
+    for (size_t i = 0; i < n; ++i) {
+        Point v1 = polygon[i];
+        Point v2 = polygon[i + 1 < n ? i + 1 : 0];
+        Edge& e = edges[i];
+        e.x1 = v1.x;
+        e.y1 = v1.y;
+        e.x2 = v2.x;
+        e.y2 = v2.y;
+        minY = std::min(minY, v1.y);
+        maxY = std::max(maxY, v1.y);
+    }
+
+    // 桶高度均匀，桶数从边数开始减半，直到所有边覆盖的桶数之和不超过边数的 4 倍
+    // 梳子形等有大量长边的多边形桶数会很少，查询变慢但内存保持 O(n)
+    bucketCount = static_cast<int>(std::min<size_t>(n, INT_MAX));
+    for (;;) {
+        bucketScale = (maxY > minY) ? bucketCount / (maxY - minY) : 0.0;
+        if (!std::isfinite(bucketScale)) bucketScale = 0.0;
+        if (bucketCount == 1 || countEntries() <= n * 4) break;
+        bucketCount /= 2;
+    }
+
+    // 两遍计数排序生成 CSR 结构
+    bucketStart.assign(bucketCount + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        int lo = bucketOf(std::min(edges[i].y1, edges[i].y2));
+        int hi = bucketOf(std::max(edges[i].y1, edges[i].y2));
+        for (int b = lo; b <= hi; ++b) bucketStart[b + 1]++;
+    }
+    for (int b = 0; b < bucketCount; ++b) bucketStart[b + 1] += bucketStart[b];
+
+    bucketEdges.resize(bucketStart[bucketCount]);
+    std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        int lo = bucketOf(std::min(edges[i].y1, edges[i].y2));
+        int hi = bucketOf(std::max(edges[i].y1, edges[i].y2));
+        for (int b = lo; b <= hi; ++b) bucketEdges[fill[b]++] = static_cast<int>(i);
+    }
+}
+
+size_t PreparedPolygon::countEntries() const {
+    size_t total = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        total += bucketOf(std::max(edges[i].y1, edges[i].y2)) - bucketOf(std::min(edges[i].y1, edges[i].y2)) + 1;
+    }
+    return total;
+}
+
+// y 到桶下标的映射是单调的，因此 y 落在某条边的 [minY, maxY] 内时，该边一定在 y 所在的桶中
+int PreparedPolygon::bucketOf(double y) const {
+    int b = static_cast<int>((y - minY) * bucketScale);
+    if (b < 0) return 0;
+    if (b >= bucketCount) return bucketCount - 1;
+    return b;
+}
+
+bool PreparedPolygon::containsRayCasting(const Point& pt) const {
+    // 不在 y 范围内的点既不可能在边界上，也不会与任何边相交
+    if (edges.empty() || !(pt.y >= minY && pt.y <= maxY)) {
+        countQuery(0, false);
+        return false;
+    }
+
+    int b = bucketOf(pt.y);
+    int intersectCount = 0;
+    for (size_t k = bucketStart[b]; k < bucketStart[b + 1]; ++k) {
+        const Edge& e = edges[bucketEdges[k]];
+        Point v1 = {e.x1, e.y1};
+        Point v2 = {e.x2, e.y2};
+
+        if (isPointOnSegment(pt, v1, v2)) {
+            countQuery(k - bucketStart[b] + 1, true);
+            return true;
+        }
+
+        if ((e.y1 > pt.y) != (e.y2 > pt.y)) {
+            if (crossesRay(predicates::orient2d(v1, v2, pt), e.y2 > e.y1)) {
+                intersectCount++;
+            }
+        }
+    }
+    countQuery(bucketStart[b + 1] - bucketStart[b], false);
+    return (intersectCount % 2) == 1;
+}
+
+bool PreparedPolygon::containsWindingNumber(const Point& pt) const {
+    if (edges.empty() || !(pt.y >= minY && pt.y <= maxY)) {
+        countQuery(0, false);
+        return false;
+    }
+
+    int b = bucketOf(pt.y);
+    int windingNumber = 0;
+    for (size_t k = bucketStart[b]; k < bucketStart[b + 1]; ++k) {
+        const Edge& e = edges[bucketEdges[k]];
+        Point v1 = {e.x1, e.y1};
+        Point v2 = {e.x2, e.y2};
+
+        if (isPointOnSegment(pt, v1, v2)) {
+            countQuery(k - bucketStart[b] + 1, true);
+            return true;
+        }
+
+        if (e.y1 <= pt.y) {
+            if (e.y2 > pt.y && computeOrientation(v1, v2, pt) == 1) {
+                windingNumber++;
+            }
+        } else {
+            if (e.y2 <= pt.y && computeOrientation(v1, v2, pt) == -1) {
+                windingNumber--;
+            }
+        }
+    }
+    countQuery(bucketStart[b + 1] - bucketStart[b], false);
+    return windingNumber != 0;
+}
+
+// 去掉相邻的重复点；所有转向同号（共线处不能折返），并且边的 y 方向只改变两次（只绕一圈）时多边形是凸的
+bool ConvexPolygon::normalize(const PointView& polygon, std::vector<Point>& hull) {
+    std::vector<Point> p;
+    p.reserve(polygon.size());
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        Point v = polygon[i];
+        if (p.empty() || v.x != p.back().x || v.y != p.back().y) p.push_back(v);
+    }
+    while (p.size() > 1 && p.back().x == p.front().x && p.back().y == p.front().y) p.pop_back();
+
+    size_t m = p.size();
+    hull.clear();
+    int sign = 0;
+    bool reversal = false;
+    std::vector<double> turns(m, 0.0);
+    for (size_t i = 0; i < m && m >= 3; ++i) {
+        const Point& a = p[(i + m - 1) % m];
+        const Point& b = p[i];
+        const Point& c = p[(i + 1) % m];
+        turns[i] = predicates::orient2d(a, b, c);
+        if (turns[i] == 0) {
+            if ((b.x - a.x) * (c.x - b.x) + (b.y - a.y) * (c.y - b.y) < 0) reversal = true;
+            continue;
+        }
+        int s = turns[i] > 0 ? 1 : -1;
+        if (sign != 0 && sign != s) return false;
+        sign = s;
+    }
+
+    if (sign == 0) {
+        // 所有顶点共线，退化为两端点之间的线段
+        if (m == 0) return true;
+        size_t lo = 0, hi = 0;
+        for (size_t i = 1; i < m; ++i) {
+            if (p[i].x < p[lo].x || (p[i].x == p[lo].x && p[i].y < p[lo].y)) lo = i;
+            if (p[i].x > p[hi].x || (p[i].x == p[hi].x && p[i].y > p[hi].y)) hi = i;
+        }
+        hull.push_back(p[lo]);
+        if (hi != lo) hull.push_back(p[hi]);
+        return true;
+    }
+    if (reversal) return false;
+
+    int changes = 0, last = 0;
+    for (size_t k = 0; k < 2 * m; ++k) {
+        const Point& a = p[k % m];
+        const Point& b = p[(k + 1) % m];
+        int dy = b.y > a.y ? 1 : b.y < a.y ? -1 : 0;
+        if (dy == 0) continue;
+        if (last != 0 && dy != last && k >= m) changes++;
+        last = dy;
+    }
+    if (changes != 2) return false;
+
+    for (size_t i = 0; i < m; ++i) {
+        if (turns[i] != 0) hull.push_back(p[i]);
+    }
+    if (sign < 0) std::reverse(hull.begin(), hull.end());
+    return true;
+}
+
+ConvexPolygon::ConvexPolygon(const std::vector<Point>& polygon) : ConvexPolygon(PointView(polygon)) {}
+
+ConvexPolygon::ConvexPolygon(const PointView& polygon) {
+    if (!normalize(polygon, hull)) throw std::invalid_argument("ConvexPolygon: polygon is not convex");
+}
+
+bool ConvexPolygon::isConvex(const PointView& polygon) {
+    std::vector<Point> hull;
+    return normalize(polygon, hull);
+}
+
+// hull 按逆时针排列且没有共线点，点在扇区 (v0, v[k], v[k + 1]) 中时 orient(v0, v[k], pt) >= 0 对 k 单调
+PointLocation ConvexPolygon::locate(const Point& pt) const {
+    size_t n = hull.size();
+    if (n < 3) {
+        bool onBoundary = n == 1 ? (pt.x == hull[0].x && pt.y == hull[0].y)
+                                 : n == 2 && isPointOnSegment(pt, hull[0], hull[1]);
+        countQuery(n, onBoundary);
+        return onBoundary ? OnBoundary : Outside;
+    }
+
+    const Point& v0 = hull[0];
+    double first = predicates::orient2d(v0, hull[1], pt);
+    double last = predicates::orient2d(v0, hull[n - 1], pt);
+    if (first < 0 || last > 0) {
+        countQuery(2, false);
+        return Outside;
+    }
+
+    // 无分支的二分查找：lo 为满足 orient(v0, v[k], pt) >= 0 的最大 k，每次把区间减半
+    size_t lo = 1, len = n - 2, tests = 2;
+    while (len > 1) {
+        size_t half = len / 2;
+        lo = predicates::orient2d(v0, hull[lo + half], pt) >= 0 ? lo + half : lo;
+        len -= half;
+        tests++;
+    }
+
+    double outer = predicates::orient2d(hull[lo], hull[lo + 1], pt);
+    bool onBoundary = outer == 0 || (outer > 0 && ((lo == 1 && first == 0) || (lo == n - 2 && last == 0)));
+    countQuery(tests + 1, onBoundary);
+    if (onBoundary) return OnBoundary;
+    return outer > 0 ? Inside : Outside;
+}
+
+void ConvexPolygon::classifyPoints(const PointView& pts, uint8_t* out, int threads) const {
+    GEOM_STATS_TIMER(ClassifyPoints);
+    parallelFor(pts.size(), 4096, [this, &pts, out](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) out[i] = static_cast<uint8_t>(locate(pts[i]));
+    }, threads);
+}
 
 } // namespace PointInPolygon
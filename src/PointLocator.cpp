@@ -0,0 +1,439 @@
+#include "PointLocator.h"
+#include "ThreadPool.h"
+#include "predicates.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// 边上方为正，下方为负，在边所在直线上为 0；调用者保证 x 在边的 x 范围内
+template <typename Edge>
+static int side(const Edge& e, double x, double y) {
+    return predicates::sign(predicates::orient2d(e.x1, e.y1, e.x2, e.y2, x, y));
+}
+
+// 散列边的编号作为 treap 优先级，构建结果只取决于输入
+static uint32_t priority(int32_t edge) {
+    uint32_t h = static_cast<uint32_t>(edge) * 0x9E3779B1u;
+    h ^= h >> 15;
+    h *= 0x85EBCA77u;
+    h ^= h >> 13;
+    return h;
+}
+
+// 可持久化 treap 的构建过程：修改时复制从根到修改位置的路径，旧版本保持不变
+// 同一条分界线上的多次修改共用一个新版本，本次新建的节点（下标不小于 fresh）直接原地修改
+namespace {
+
+template <typename Edge, typename Node>
+class TreapBuilder {
+public:
+    TreapBuilder(const std::vector<Edge>& edges, std::vector<Node>& nodes) : edges(edges), nodes(nodes), fresh(0) {}
+
+    void beginVersion() { fresh = nodes.size(); }
+
+    int32_t insert(int32_t root, int32_t edge) {
+        if (root < 0 || priority(edge) > priority(nodes[root].edge)) {
+            int32_t left, right;
+            split(root, edge, left, right);
+            Node node = {edge, left, right};
+            nodes.push_back(node);
+            return static_cast<int32_t>(nodes.size() - 1);
+        }
+        int32_t copy = own(root);
+        if (compare(edge, nodes[copy].edge) < 0) {
+            int32_t child = insert(nodes[copy].left, edge);
+            nodes[copy].left = child;
+        } else {
+            int32_t child = insert(nodes[copy].right, edge);
+            nodes[copy].right = child;
+        }
+        return copy;
+    }
+
+    // 找不到这条边说明输入的多边形有重叠，边的上下次序不一致
+    int32_t erase(int32_t root, int32_t edge) {
+        if (root < 0) throw std::invalid_argument("PointLocator: polygons overlap or self-intersect");
+        if (nodes[root].edge == edge) return merge(nodes[root].left, nodes[root].right);
+        int32_t copy = own(root);
+        if (compare(edge, nodes[copy].edge) < 0) {
+            int32_t child = erase(nodes[copy].left, edge);
+            nodes[copy].left = child;
+        } else {
+            int32_t child = erase(nodes[copy].right, edge);
+            nodes[copy].right = child;
+        }
+        return copy;
+    }
+
+private:
+    const std::vector<Edge>& edges;
+    std::vector<Node>& nodes;
+    size_t fresh;
+
+    int32_t own(int32_t node) {
+        if (static_cast<size_t>(node) >= fresh) return node;
+        Node copy = nodes[node];
+        nodes.push_back(copy);
+        return static_cast<int32_t>(nodes.size() - 1);
+    }
+
+    // 两条边都跨过当前条带且不相交，取一条边上落在另一条边 x 范围内的端点判断上下
+    // 端点在另一条边上时改用右端点；两边共线重叠时，上方没有多边形的边排在下面，查询时优先得到有多边形的一侧
+    int compare(int32_t a, int32_t b) const {
+        if (a == b) return 0;
+        const Edge& e = edges[a];
+        const Edge& f = edges[b];
+        int s = e.x1 >= f.x1 ? side(f, e.x1, e.y1) : -side(e, f.x1, f.y1);
+        if (s != 0) return s;
+        s = e.x2 <= f.x2 ? side(f, e.x2, e.y2) : -side(e, f.x2, f.y2);
+        if (s != 0) return s;
+        bool emptyA = e.above == PointLocator::NONE, emptyB = f.above == PointLocator::NONE;
+        if (emptyA != emptyB) return emptyA ? -1 : 1;
+        return a < b ? -1 : 1;
+    }
+
+    void split(int32_t root, int32_t edge, int32_t& left, int32_t& right) {
+        if (root < 0) {
+            left = right = -1;
+            return;
+        }
+        int32_t copy = own(root);
+        if (compare(nodes[copy].edge, edge) < 0) {
+            int32_t l, r;
+            split(nodes[copy].right, edge, l, r);
+            nodes[copy].right = l;
+            left = copy;
+            right = r;
+        } else {
+            int32_t l, r;
+            split(nodes[copy].left, edge, l, r);
+            nodes[copy].left = r;
+            left = l;
+            right = copy;
+        }
+    }
+
+    int32_t merge(int32_t a, int32_t b) {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        if (priority(nodes[a].edge) > priority(nodes[b].edge)) {
+            int32_t copy = own(a);
+            int32_t child = merge(nodes[copy].right, b);
+            nodes[copy].right = child;
+            return copy;
+        }
+        int32_t copy = own(b);
+        int32_t child = merge(a, nodes[copy].left);
+        nodes[copy].left = child;
+        return copy;
+    }
+};
+
+} // namespace
+
+PointLocator::PointLocator(const std::vector<std::vector<Point>>& polygons) : numPolygons(0) {
+    std::vector<double> xs, ys;
+    std::vector<size_t> offsets(1, 0);
+    for (size_t k = 0; k < polygons.size(); k++) {
+        for (size_t i = 0; i < polygons[k].size(); i++) {
+            xs.push_back(polygons[k][i].x);
+            ys.push_back(polygons[k][i].y);
+        }
+        offsets.push_back(xs.size());
+    }
+    *this = PointLocator(xs.data(), ys.data(), offsets.data(), polygons.size());
+}
+
+// 每个多边形按面积的符号确定内部在边的哪一侧，竖直边和面积为 0 的多边形不参与构建
+PointLocator::PointLocator(const double* xs, const double* ys, const size_t* offsets, size_t count) : numPolygons(0) {
+    if (count > static_cast<size_t>(INT32_MAX)) throw std::invalid_argument("PointLocator: too many polygons");
+    std::vector<Edge> raw;
+    for (size_t k = 0; k < count; k++) {
+        size_t first = offsets[k], n = offsets[k + 1] - offsets[k];
+        if (n < 3) continue;
+        double area2 = 0;
+        for (size_t i = 0; i < n; i++) {
+            size_t a = first + i, b = first + (i + 1 == n ? 0 : i + 1);
+            area2 += xs[a] * ys[b] - xs[b] * ys[a];
+        }
+        if (area2 == 0) continue;
+        for (size_t i = 0; i < n; i++) {
+            size_t a = first + i, b = first + (i + 1 == n ? 0 : i + 1);
+            if (xs[a] == xs[b]) continue;
+            // 逆时针多边形的内部在边的左侧，边从左向右时左侧就是上方
+            bool rightward = xs[a] < xs[b];
+            bool interiorAbove = rightward == (area2 > 0);
+            Edge e;
+            e.x1 = rightward ? xs[a] : xs[b];
+            e.y1 = rightward ? ys[a] : ys[b];
+            e.x2 = rightward ? xs[b] : xs[a];
+            e.y2 = rightward ? ys[b] : ys[a];
+            e.above = interiorAbove ? static_cast<int32_t>(k) : NONE;
+            e.below = interiorAbove ? NONE : static_cast<int32_t>(k);
+            raw.push_back(e);
+        }
+    }
+    build(raw, count);
+}
+
+void PointLocator::build(const std::vector<Edge>& raw, size_t polygonCount) {
+    numPolygons = polygonCount;
+    slabX.clear();
+    roots.clear();
+    edges.clear();
+    nodes.clear();
+
+    // 合并重合的边：相邻的两个多边形各贡献一侧
+    std::vector<Edge> sorted(raw);
+    std::sort(sorted.begin(), sorted.end(), [](const Edge& a, const Edge& b) {
+        if (a.x1 != b.x1) return a.x1 < b.x1;
+        if (a.y1 != b.y1) return a.y1 < b.y1;
+        if (a.x2 != b.x2) return a.x2 < b.x2;
+        return a.y2 < b.y2;
+    });
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const Edge& e = sorted[i];
+        if (!edges.empty()) {
+            Edge& last = edges.back();
+            if (last.x1 == e.x1 && last.y1 == e.y1 && last.x2 == e.x2 && last.y2 == e.y2) {
+                if ((e.above != NONE && last.above != NONE && e.above != last.above) ||
+                    (e.below != NONE && last.below != NONE && e.below != last.below)) {
+                    throw std::invalid_argument("PointLocator: polygons overlap or self-intersect");
+                }
+                if (e.above != NONE) last.above = e.above;
+                if (e.below != NONE) last.below = e.below;
+                continue;
+            }
+        }
+        edges.push_back(e);
+    }
+    if (edges.size() > static_cast<size_t>(INT32_MAX)) throw std::invalid_argument("PointLocator: too many edges");
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        slabX.push_back(edges[i].x1);
+        slabX.push_back(edges[i].x2);
+    }
+    std::sort(slabX.begin(), slabX.end());
+    slabX.erase(std::unique(slabX.begin(), slabX.end()), slabX.end());
+    if (slabX.size() < 2) {
+        slabX.clear();
+        return;
+    }
+
+    // edges 已按左端点排序，另按右端点排序得到删除次序
+    std::vector<int32_t> byEnd(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) byEnd[i] = static_cast<int32_t>(i);
+    std::sort(byEnd.begin(), byEnd.end(), [this](int32_t a, int32_t b) { return edges[a].x2 < edges[b].x2; });
+
+    // 在每条分界线上先删除结束的边，再插入开始的边，得到右侧条带的版本
+    TreapBuilder<Edge, Node> treap(edges, nodes);
+    roots.resize(slabX.size() - 1);
+    int32_t root = -1;
+    size_t start = 0, end = 0;
+    for (size_t k = 0; k + 1 < slabX.size(); k++) {
+        treap.beginVersion();
+        for (; end < byEnd.size() && edges[byEnd[end]].x2 == slabX[k]; end++) root = treap.erase(root, byEnd[end]);
+        for (; start < edges.size() && edges[start].x1 == slabX[k]; start++) {
+            root = treap.insert(root, static_cast<int32_t>(start));
+        }
+        roots[k] = root;
+    }
+
+    // 按后序重新编号，子节点的下标总小于父节点，load 据此拒绝含环的文件；不可达的旧节点同时被丢弃
+    std::vector<int32_t> order(nodes.size(), -1);
+    std::vector<Node> numbered;
+    numbered.reserve(nodes.size());
+    std::vector<std::pair<int32_t, int>> stack;  // 节点和已处理的子节点个数
+    for (size_t k = 0; k < roots.size(); k++) {
+        if (roots[k] >= 0 && order[roots[k]] < 0) stack.push_back(std::make_pair(roots[k], 0));
+        while (!stack.empty()) {
+            int32_t node = stack.back().first;
+            int state = stack.back().second++;
+            if (state < 2) {
+                int32_t child = state == 0 ? nodes[node].left : nodes[node].right;
+                if (child >= 0 && order[child] < 0) stack.push_back(std::make_pair(child, 0));
+                continue;
+            }
+            stack.pop_back();
+            Node copy = nodes[node];
+            if (copy.left >= 0) copy.left = order[copy.left];
+            if (copy.right >= 0) copy.right = order[copy.right];
+            order[node] = static_cast<int32_t>(numbered.size());
+            numbered.push_back(copy);
+        }
+        if (roots[k] >= 0) roots[k] = order[roots[k]];
+    }
+    std::vector<Node>(numbered).swap(nodes);
+}
+
+// 找到条带中点下方最近的边，点的位置就是这条边上方的多边形
+int PointLocator::locateInSlab(size_t slab, double x, double y) const {
+    int32_t node = roots[slab], below = -1;
+    while (node >= 0) {
+        const Edge& e = edges[nodes[node].edge];
+        int s = side(e, x, y);
+        if (s == 0) return e.above != NONE ? e.above : e.below;
+        if (s > 0) {
+            below = nodes[node].edge;
+            node = nodes[node].right;
+        } else {
+            node = nodes[node].left;
+        }
+    }
+    return below < 0 ? NONE : edges[below].above;
+}
+
+// 分界线上的点先按右侧条带查询，不在多边形内时再查左侧条带，竖直边上的点因此也能找到所属的多边形
+int PointLocator::locate(double x, double y) const {
+    if (slabX.empty() || !(x >= slabX.front() && x <= slabX.back())) return NONE;
+    size_t slab = std::upper_bound(slabX.begin(), slabX.end(), x) - slabX.begin() - 1;
+    if (slab + 1 == slabX.size()) slab--;
+    int result = locateInSlab(slab, x, y);
+    if (result == NONE && x == slabX[slab] && slab > 0) result = locateInSlab(slab - 1, x, y);
+    return result;
+}
+
+// 按 x 排序后依次查询，相邻的查询落在相邻的条带中，访问的节点大多还在缓存里
+void PointLocator::locate(const PointView& points, int* out, int threads) const {
+    size_t n = points.size();
+    std::vector<std::pair<double, size_t>> order(n);
+    for (size_t i = 0; i < n; i++) order[i] = std::make_pair(points.x(i), i);
+    std::sort(order.begin(), order.end());
+
+    parallelFor(n, 4096, [this, &points, &order, out](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            size_t i = order[k].second;
+            out[i] = locate(points.x(i), points.y(i));
+        }
+    }, threads);
+}
+
+// 文件格式：文件头之后依次为 slabX、roots、edges、nodes 四个数组
+// 版本 2 起节点按后序存放，子节点的下标小于父节点
+namespace {
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t polygons, slabs, roots, edges, nodes;
+};
+
+const char LOCATOR_MAGIC[8] = {'G', 'E', 'O', 'M', 'L', 'O', 'C', '\0'};
+const uint32_t LOCATOR_VERSION = 2;
+
+std::runtime_error fileError(const std::string& what, const std::string& path) {
+    std::string message = "PointLocator: " + what + " " + path;
+    if (errno != 0) message += ": " + std::string(strerror(errno));
+    return std::runtime_error(message);
+}
+
+template <typename T>
+bool writeArray(FILE* file, const std::vector<T>& values) {
+    return values.empty() || fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+}
+
+template <typename T>
+bool readArray(FILE* file, std::vector<T>& values, uint64_t count) {
+    values.resize(static_cast<size_t>(count));
+    return values.empty() || fread(values.data(), sizeof(T), values.size(), file) == values.size();
+}
+
+} // namespace
+
+void PointLocator::save(const std::string& path) const {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOCATOR_MAGIC, sizeof(LOCATOR_MAGIC));
+    header.version = LOCATOR_VERSION;
+    header.polygons = numPolygons;
+    header.slabs = slabX.size();
+    header.roots = roots.size();
+    header.edges = edges.size();
+    header.nodes = nodes.size();
+
+    errno = 0;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) throw fileError("cannot create", path);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && writeArray(file, slabX) && writeArray(file, roots) &&
+              writeArray(file, edges) && writeArray(file, nodes);
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        remove(path.c_str());
+        throw fileError("failed to write", path);
+    }
+}
+
+// 读入后检查各数组的长度和所有下标，损坏的文件不会导致越界访问
+// 分配内存之前先核对文件头中的数量与文件剩余的字节数，伪造的巨大数量不会导致大量分配
+PointLocator PointLocator::load(const std::string& path) {
+    errno = 0;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) throw fileError("cannot open", path);
+
+    PointLocator locator;
+    FileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1;
+    long remaining = -1;
+    if (ok && fseek(file, 0, SEEK_END) == 0) {
+        long size = ftell(file);
+        if (size >= 0 && fseek(file, static_cast<long>(sizeof(header)), SEEK_SET) == 0) {
+            remaining = size - static_cast<long>(sizeof(header));
+        }
+    }
+    std::string problem;
+    if (!ok || memcmp(header.magic, LOCATOR_MAGIC, sizeof(LOCATOR_MAGIC)) != 0) {
+        problem = "not a point locator file:";
+    } else if (header.version != LOCATOR_VERSION) {
+        problem = "unsupported format version " + std::to_string(header.version) + " in";
+    } else if (remaining < 0) {
+        problem = "cannot determine the size of";
+    } else if (header.polygons > static_cast<uint64_t>(INT32_MAX) || header.edges > static_cast<uint64_t>(INT32_MAX) ||
+               header.nodes > static_cast<uint64_t>(INT32_MAX) || header.slabs > 2 * header.edges ||
+               header.roots != (header.slabs < 2 ? 0 : header.slabs - 1)) {
+        // 每条边贡献两条分界线，数量都不超过 INT32_MAX，下面的字节数不会溢出
+        problem = "corrupt file:";
+    } else if (header.slabs * sizeof(double) + header.roots * sizeof(int32_t) + header.edges * sizeof(Edge) +
+                   header.nodes * sizeof(Node) != static_cast<uint64_t>(remaining)) {
+        problem = "file size does not match the header of";
+    } else if (!readArray(file, locator.slabX, header.slabs) || !readArray(file, locator.roots, header.roots) ||
+               !readArray(file, locator.edges, header.edges) || !readArray(file, locator.nodes, header.nodes)) {
+        problem = "truncated file:";
+    }
+    fclose(file);
+
+    if (problem.empty()) {
+        locator.numPolygons = static_cast<size_t>(header.polygons);
+        int32_t polygonCount = static_cast<int32_t>(header.polygons);
+        int32_t edgeCount = static_cast<int32_t>(header.edges);
+        int32_t nodeCount = static_cast<int32_t>(header.nodes);
+        auto validPolygon = [polygonCount](int32_t id) { return id == NONE || (id >= 0 && id < polygonCount); };
+        auto validNode = [nodeCount](int32_t id) { return id >= -1 && id < nodeCount; };
+        for (size_t i = 0; i < locator.edges.size() && problem.empty(); i++) {
+            const Edge& e = locator.edges[i];
+            if (!(e.x1 < e.x2) || !validPolygon(e.above) || !validPolygon(e.below)) problem = "corrupt file:";
+        }
+        // 子节点的下标必须小于父节点，节点图因此无环，查询一定在有限步内结束
+        for (size_t i = 0; i < locator.nodes.size() && problem.empty(); i++) {
+            const Node& node = locator.nodes[i];
+            int32_t self = static_cast<int32_t>(i);
+            if (node.edge < 0 || node.edge >= edgeCount || !validNode(node.left) || !validNode(node.right) ||
+                node.left >= self || node.right >= self) {
+                problem = "corrupt file:";
+            }
+        }
+        for (size_t i = 0; i < locator.roots.size() && problem.empty(); i++) {
+            if (!validNode(locator.roots[i])) problem = "corrupt file:";
+        }
+        for (size_t i = 1; i < locator.slabX.size() && problem.empty(); i++) {
+            if (!(locator.slabX[i - 1] < locator.slabX[i])) problem = "corrupt file:";
+        }
+    }
+    if (!problem.empty()) {
+        errno = 0;
+        throw fileError(problem, path);
+    }
+    return locator;
+}
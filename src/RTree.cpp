@@ -0,0 +1,296 @@
+#include "RTree.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+typedef RTree::Box Box;
+
+static bool isValid(const Box& b) {
+    return b.minX <= b.maxX && b.minY <= b.maxY;
+}
+
+static Box emptyBox() {
+    double inf = std::numeric_limits<double>::infinity();
+    Box b = {inf, inf, -inf, -inf};
+    return b;
+}
+
+static void expand(Box& b, const Box& other) {
+    b.minX = std::min(b.minX, other.minX);
+    b.minY = std::min(b.minY, other.minY);
+    b.maxX = std::max(b.maxX, other.maxX);
+    b.maxY = std::max(b.maxY, other.maxY);
+}
+
+static bool intersects(const Box& a, const Box& b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+// 点到包围盒的距离平方，点在盒内时为 0
+static double distance2(const Box& b, double x, double y) {
+    double dx = std::max(std::max(b.minX - x, x - b.maxX), 0.0);
+    double dy = std::max(std::max(b.minY - y, y - b.maxY), 0.0);
+    return dx * dx + dy * dy;
+}
+
+// STR 排列：按中心 x 排序后切成 ceil(sqrt(节点数)) 个竖条，竖条内再按中心 y 排序
+// 之后每 capacity 个连续的包围盒组成一个上层节点
+static void strSort(std::vector<int>& order, const std::vector<Box>& b, size_t capacity) {
+    size_t n = order.size();
+    size_t groups = (n + capacity - 1) / capacity;
+    size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(groups))));
+    size_t sliceSize = slices * capacity;
+    std::sort(order.begin(), order.end(), [&b](int i, int j) {
+        return b[i].minX + b[i].maxX < b[j].minX + b[j].maxX;
+    });
+    for (size_t first = 0; first < n; first += sliceSize) {
+        size_t last = std::min(n, first + sliceSize);
+        std::sort(order.begin() + first, order.begin() + last, [&b](int i, int j) {
+            return b[i].minY + b[i].maxY < b[j].minY + b[j].maxY;
+        });
+    }
+}
+
+RTree::RTree(const std::vector<Box>& boxes, int nodeCapacity) : capacity(16), leafCount(0), boxes(boxes) {
+    build(nodeCapacity);
+}
+
+RTree RTree::fromRectangles(const std::vector<Rectangle>& rectangles, int nodeCapacity) {
+    std::vector<Box> b(rectangles.size());
+    for (size_t i = 0; i < rectangles.size(); i++) {
+        const Rectangle& r = rectangles[i];
+        b[i].minX = std::min(r.x1, r.x2);
+        b[i].minY = std::min(r.y1, r.y2);
+        b[i].maxX = std::max(r.x1, r.x2);
+        b[i].maxY = std::max(r.y1, r.y2);
+    }
+    return RTree(b, nodeCapacity);
+}
+
+RTree RTree::fromSegments(const std::vector<LineSegmentIntersection::Segment>& segments, int nodeCapacity) {
+    std::vector<Box> b(segments.size());
+    for (size_t i = 0; i < segments.size(); i++) {
+        const LineSegmentIntersection::Segment& s = segments[i];
+        b[i].minX = std::min(s.a.x, s.b.x);
+        b[i].minY = std::min(s.a.y, s.b.y);
+        b[i].maxX = std::max(s.a.x, s.b.x);
+        b[i].maxY = std::max(s.a.y, s.b.y);
+    }
+    return RTree(b, nodeCapacity);
+}
+
+RTree RTree::fromPolygons(const std::vector<std::vector<Point>>& polygons, int nodeCapacity) {
+    std::vector<Box> b(polygons.size(), emptyBox());
+    for (size_t i = 0; i < polygons.size(); i++) {
+        for (size_t j = 0; j < polygons[i].size(); j++) {
+            const Point& p = polygons[i][j];
+            Box point = {p.x, p.y, p.x, p.y};
+            expand(b[i], point);
+        }
+    }
+    return RTree(b, nodeCapacity);
+}
+
+RTree RTree::fromPolygons(const double* xs, const double* ys, const size_t* offsets, size_t count,
+                          int nodeCapacity) {
+    std::vector<Box> b(count, emptyBox());
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+            Box point = {xs[j], ys[j], xs[j], ys[j]};
+            expand(b[i], point);
+        }
+    }
+    return RTree(b, nodeCapacity);
+}
+
+void RTree::build(int nodeCapacity) {
+    if (nodeCapacity < 2 || nodeCapacity > 64) throw std::invalid_argument("RTree node capacity must be in [2, 64]");
+    capacity = nodeCapacity;
+    size_t cap = static_cast<size_t>(capacity);
+
+    // 叶子层：元素按 STR 顺序排列，每 capacity 个组成一个叶子
+    std::vector<int> order;
+    order.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (isValid(boxes[i])) order.push_back(static_cast<int>(i));
+    }
+    strSort(order, boxes, cap);
+    entries.resize(order.size());
+    ids = order;
+    for (size_t i = 0; i < order.size(); i++) entries[i] = boxes[order[i]];
+
+    nodes.clear();
+    for (size_t first = 0; first < entries.size(); first += cap) {
+        Node node = {emptyBox(), static_cast<int>(first), static_cast<int>(std::min(cap, entries.size() - first))};
+        for (int i = node.first; i < node.first + node.count; i++) expand(node.box, entries[i]);
+        nodes.push_back(node);
+    }
+    leafCount = nodes.size();
+
+    // 逐层向上：本层节点按 STR 重新排列后，每 capacity 个组成一个上层节点，直到只剩根节点
+    size_t levelBegin = 0, levelEnd = nodes.size();
+    std::vector<Box> levelBoxes;
+    std::vector<Node> levelNodes;
+    while (levelEnd - levelBegin > 1) {
+        size_t count = levelEnd - levelBegin;
+        levelBoxes.resize(count);
+        levelNodes.assign(nodes.begin() + levelBegin, nodes.begin() + levelEnd);
+        for (size_t i = 0; i < count; i++) levelBoxes[i] = levelNodes[i].box;
+        order.resize(count);
+        for (size_t i = 0; i < count; i++) order[i] = static_cast<int>(i);
+        strSort(order, levelBoxes, cap);
+        for (size_t i = 0; i < count; i++) nodes[levelBegin + i] = levelNodes[order[i]];
+
+        for (size_t first = 0; first < count; first += cap) {
+            Node node = {emptyBox(), static_cast<int>(levelBegin + first), static_cast<int>(std::min(cap, count - first))};
+            for (int i = node.first; i < node.first + node.count; i++) expand(node.box, nodes[i].box);
+            nodes.push_back(node);
+        }
+        levelBegin = levelEnd;
+        levelEnd = nodes.size();
+    }
+}
+
+template <typename Test>
+void RTree::search(const Test& test, std::vector<int>& stack, std::vector<int>& out) const {
+    if (nodes.empty() || !test(nodes.back().box)) return;
+    stack.clear();
+    stack.push_back(static_cast<int>(nodes.size()) - 1);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        bool leaf = static_cast<size_t>(stack.back()) < leafCount;
+        stack.pop_back();
+        if (leaf) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                if (test(entries[i])) out.push_back(ids[i]);
+            }
+        } else {
+            // 逆序入栈，使子节点按存放顺序出栈
+            for (int c = node.first + node.count - 1; c >= node.first; c--) {
+                if (test(nodes[c].box)) stack.push_back(c);
+            }
+        }
+    }
+}
+
+// 窗口与点查询的判断条件
+struct WindowTest {
+    Box window;
+    bool operator()(const Box& b) const { return intersects(window, b); }
+};
+
+struct PointTest {
+    double x, y;
+    bool operator()(const Box& b) const { return b.minX <= x && x <= b.maxX && b.minY <= y && y <= b.maxY; }
+};
+
+void RTree::queryWindow(const Box& window, std::vector<int>& out) const {
+    std::vector<int> stack;
+    WindowTest test = {window};
+    search(test, stack, out);
+}
+
+void RTree::queryPoint(double x, double y, std::vector<int>& out) const {
+    std::vector<int> stack;
+    PointTest test = {x, y};
+    search(test, stack, out);
+}
+
+// 最佳优先搜索：节点和元素按距离放入同一个小根堆，元素出堆时即为当前最近
+void RTree::nearest(double x, double y, size_t k, std::vector<int>& out,
+                    const std::function<double(int id)>& itemDistance2) const {
+    if (nodes.empty() || k == 0) return;
+
+    struct Candidate {
+        double dist2;
+        int index;  // 非负为节点下标，负数 -1 - i 表示 entries[i]
+        bool operator>(const Candidate& other) const { return dist2 > other.dist2; }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+    Candidate root = {distance2(nodes.back().box, x, y), static_cast<int>(nodes.size()) - 1};
+    heap.push(root);
+
+    size_t found = 0;
+    while (!heap.empty() && found < k) {
+        Candidate c = heap.top();
+        heap.pop();
+        if (c.index < 0) {
+            out.push_back(ids[-1 - c.index]);
+            found++;
+            continue;
+        }
+        const Node& node = nodes[c.index];
+        if (static_cast<size_t>(c.index) < leafCount) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                double d = itemDistance2 ? itemDistance2(ids[i]) : distance2(entries[i], x, y);
+                Candidate item = {d, -1 - i};
+                heap.push(item);
+            }
+        } else {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                Candidate child = {distance2(nodes[i].box, x, y), i};
+                heap.push(child);
+            }
+        }
+    }
+}
+
+// 把 n 个查询分块执行，每块把结果写入自己的缓冲区，最后按查询顺序拼接为 CSR
+// query(i, stack, out) 把第 i 个查询的结果追加到 out
+template <typename Query>
+static void runBatch(size_t n, int threads, const Query& query, std::vector<size_t>& offsets, std::vector<int>& items) {
+    if (threads <= 0) threads = globalThreads();
+    const size_t minChunk = 256;
+    size_t chunks = threads == 1 ? 1 : std::max<size_t>(1, std::min(n / minChunk, static_cast<size_t>(threads) * 4));
+
+    offsets.assign(n + 1, 0);
+    std::vector<std::vector<int>> results(chunks);
+    auto work = [n, chunks, &query, &offsets, &results](size_t c) {
+        std::vector<int> stack;
+        for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++) {
+            size_t before = results[c].size();
+            query(i, stack, results[c]);
+            offsets[i + 1] = results[c].size() - before;
+        }
+    };
+    parallelFor(chunks, 1, [&work](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) work(c);
+    }, threads);
+
+    for (size_t i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+    items.resize(offsets[n]);
+    for (size_t c = 0; c < chunks; c++) {
+        std::copy(results[c].begin(), results[c].end(), items.begin() + offsets[n * c / chunks]);
+    }
+}
+
+void RTree::queryWindows(const std::vector<Box>& windows, std::vector<size_t>& offsets, std::vector<int>& items,
+                         int threads) const {
+    runBatch(windows.size(), threads, [this, &windows](size_t i, std::vector<int>& stack, std::vector<int>& out) {
+        WindowTest test = {windows[i]};
+        search(test, stack, out);
+    }, offsets, items);
+}
+
+void RTree::queryPoints(const PointView& points, std::vector<size_t>& offsets, std::vector<int>& items,
+                        int threads) const {
+    runBatch(points.size(), threads, [this, &points](size_t i, std::vector<int>& stack, std::vector<int>& out) {
+        PointTest test = {points.x(i), points.y(i)};
+        search(test, stack, out);
+    }, offsets, items);
+}
+
+void RTree::nearestPoints(const PointView& points, std::vector<int>& out, int threads) const {
+    std::vector<size_t> offsets;
+    std::vector<int> items;
+    runBatch(points.size(), threads, [this, &points](size_t i, std::vector<int>&, std::vector<int>& result) {
+        nearest(points.x(i), points.y(i), 1, result);
+    }, offsets, items);
+    out.assign(points.size(), -1);
+    for (size_t i = 0; i < points.size(); i++) {
+        if (offsets[i + 1] > offsets[i]) out[i] = items[offsets[i]];
+    }
+}
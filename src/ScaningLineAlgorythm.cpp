@@ -1,4 +1,11 @@
 #include "ScaningLineAlgorythm.h"
+#include "ThreadPool.h"
+#include "stats.h"
+
+#include <climits>
+#include <cstdio>
+#include <queue>
+#include <stdexcept>
 
 
 
@@ -6,92 +13,717 @@
 bool compareEvents(const Event &a, const Event &b) {
     return a.x < b.x;
 }
-SegmentTree::SegmentTree(const std::vector<int>& coordinates) {
-    yCoordinates = coordinates;
-    tree.resize(yCoordinates.size() * 4); // 初始化线段树节点数量
-    build(0, 0, yCoordinates.size() - 1); // 构建线段树
+
+// 扫描 SegmentTree 时使用的事件，y 范围已离散化为叶子区间 [first, last]
+struct LeafEvent {
+    int x, first, last, type;
+};
+
+static bool compareLeafEvents(const LeafEvent &a, const LeafEvent &b) {
+    return a.x < b.x;
 }
 
-void SegmentTree::build(int node, int start, int end) {
-    tree[node].left = start;
-    tree[node].right = end;
-    tree[node].count = 0;
-    tree[node].length = 0;
+// x 坐标相同时进入事件在前，周长只在覆盖区域真正变化时增加
+static bool compareEventsEnterFirst(const LeafEvent &a, const LeafEvent &b) {
+    return a.x != b.x ? a.x < b.x : a.type > b.type;
+}
 
-    if (start < end) {
-        int mid = (start + end) / 2;
-        build(node * 2 + 1, start, mid);       // 构建左子树
-        build(node * 2 + 2, mid + 1, end);     // 构建右子树
+SegmentTree::SegmentTree(const std::vector<int>& coordinates, int depth, bool trackSegments) : depth(depth) {
+    int leaves = coordinates.size() > 1 ? static_cast<int>(coordinates.size()) - 1 : 1;
+    size = 1;
+    while (size < leaves) size <<= 1;
+    Node empty = {0, 0, 0};
+    tree.assign(size * 2, empty);
+    if (depth > 0) depthLength.assign(static_cast<size_t>(size) * 2 * depth, 0);
+    if (trackSegments) {
+        Boundary none = {0, false, false};
+        boundary.assign(size * 2, none);
     }
-}
 
-void SegmentTree::update(int node, int start, int end, int value) {
-    if (tree[node].left > end || tree[node].right < start) return; // 如果节点范围与更新范围无交集
+    // 补齐的叶子宽度为 0
+    for (int i = 0; i + 1 < static_cast<int>(coordinates.size()); i++) {
+        tree[size + i].width = static_cast<long long>(coordinates[i + 1]) - coordinates[i];
+    }
+    for (int i = size - 1; i > 0; i--) tree[i].width = tree[i * 2].width + tree[i * 2 + 1].width;
+}
 
-    if (start <= tree[node].left && tree[node].right <= end) {
-        tree[node].count += value; // 更新当前节点的覆盖计数
+// 根据覆盖次数和子节点重新计算节点的覆盖长度
+void SegmentTree::pull(int node) {
+    GEOM_STATS_ADD(SegmentTreeNodeVisits, 1);
+    Node& cur = tree[node];
+    if (cur.count > 0) {
+        cur.length = cur.width;
+    } else if (node >= size) {
+        cur.length = 0;
     } else {
-        update(node * 2 + 1, start, end, value); // 更新左子树
-        update(node * 2 + 2, start, end, value); // 更新右子树
+        cur.length = tree[node * 2].length + tree[node * 2 + 1].length;
     }
 
-    if (tree[node].count > 0) {
-        // 如果当前节点被覆盖，计算被覆盖的长度
-        tree[node].length = getCoordinate(tree[node].right + 1) - getCoordinate(tree[node].left);
-    } else if (tree[node].left == tree[node].right) {
-        tree[node].length = 0; // 如果节点是叶子节点且未被覆盖，长度为0
-    } else {
-        // 否则，节点的长度为左右子树的长度之和
-        tree[node].length = tree[node * 2 + 1].length + tree[node * 2 + 2].length;
+    // 节点自身被完整覆盖 count 次，子树中被覆盖 k - count 次的部分合计被覆盖 k 次
+    if (depth > 0) {
+        long long* lengths = &depthLength[static_cast<size_t>(node) * depth];
+        int full = std::min(cur.count, depth);
+        for (int k = 0; k < full; k++) lengths[k] = cur.width;
+        if (node >= size) {
+            for (int k = full; k < depth; k++) lengths[k] = 0;
+        } else {
+            const long long* left = &depthLength[static_cast<size_t>(node) * 2 * depth];
+            const long long* right = left + depth;
+            for (int k = full; k < depth; k++) lengths[k] = left[k - full] + right[k - full];
+        }
     }
-}
 
-int SegmentTree::getLength() {
-    return tree[0].length; // 返回根节点的长度
+    // 左右子区间相接处都被覆盖时，两边的覆盖段连成一段
+    if (!boundary.empty()) {
+        Boundary& b = boundary[node];
+        if (cur.count > 0) {
+            b.segments = 1;
+            b.lowCovered = b.highCovered = true;
+        } else if (node >= size) {
+            b.segments = 0;
+            b.lowCovered = b.highCovered = false;
+        } else {
+            const Boundary& left = boundary[node * 2];
+            const Boundary& right = boundary[node * 2 + 1];
+            b.segments = left.segments + right.segments - (left.highCovered && right.lowCovered ? 1 : 0);
+            b.lowCovered = left.lowCovered;
+            b.highCovered = right.highCovered;
+        }
+    }
 }
 
-int SegmentTree::getCoordinate(int index) {
-    if (index >= 0 && index < yCoordinates.size()) {
-        return yCoordinates[index]; // 返回离散化后的 y 坐标
+void SegmentTree::update(int start, int end, int value) {
+    if (start > end) return;
+    GEOM_STATS_ADD(SegmentTreeUpdates, 1);
+    int l = start + size, r = end + size + 1;
+    int l0 = l, r0 = r - 1;
+
+    // 自底向上找出恰好覆盖 [start, end] 的节点
+    for (; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) {
+            tree[l].count += value;
+            pull(l++);
+        }
+        if (r & 1) {
+            --r;
+            tree[r].count += value;
+            pull(r);
+        }
+    }
+
+    // 修改过的节点的祖先都在两端叶子到根的路径上
+    for (l0 >>= 1, r0 >>= 1; l0 != r0; l0 >>= 1, r0 >>= 1) {
+        pull(l0);
+        pull(r0);
     }
-    return 0;
+    for (; l0 > 0; l0 >>= 1) pull(l0);
 }
 
+long long SegmentTree::getLength() const {
+    return tree[1].length; // 返回根节点的长度
+}
 
-// 计算矩形覆盖的总面积
-int calculateArea(const std::vector<Rectangle> &rectangles) {
-    std::vector<Event> events;
-    std::set<int> yCoordinateSet;
+long long SegmentTree::getDepthLength(int k) const {
+    return depthLength[depth + k - 1];
+}
 
-    // 为每个矩形创建进入和离开事件，并收集 y 坐标
-    for (const auto &rect : rectangles) {
-        events.push_back({rect.x1, rect.y1, rect.y2, 1});
-        events.push_back({rect.x2, rect.y1, rect.y2, -1});
-        yCoordinateSet.insert(rect.y1);
-        yCoordinateSet.insert(rect.y2);
+int SegmentTree::getSegments() const {
+    return boundary[1].segments;
+}
+
+
+// 坐标与编号打包成可直接比较的 64 位整数，高 32 位为翻转符号位后的坐标
+static unsigned long long packKey(int value, size_t index) {
+    return (static_cast<unsigned long long>(static_cast<unsigned>(value) ^ 0x80000000u) << 32) | index;
+}
+
+// 为每个矩形创建进入和离开事件（未排序），事件中直接保存离散化后的叶子区间
+static void buildEvents(const Rectangle *rectangles, size_t n, std::vector<LeafEvent> &events,
+                        std::vector<int> &yCoordinates) {
+    // 离散化 y 坐标：对 (y, 下标) 排序后依次编号，避免对每个端点二分查找
+    std::vector<unsigned long long> keys(n * 2);
+    for (size_t i = 0; i < n; i++) {
+        keys[i * 2] = packKey(rectangles[i].y1, i * 2);
+        keys[i * 2 + 1] = packKey(rectangles[i].y2, i * 2 + 1);
     }
+    std::sort(keys.begin(), keys.end());
+    yCoordinates.clear();
+    std::vector<int> yIndex(n * 2);
+    for (size_t i = 0; i < keys.size(); i++) {
+        int y = static_cast<int>(static_cast<unsigned>(keys[i] >> 32) ^ 0x80000000u);
+        if (yCoordinates.empty() || yCoordinates.back() != y) yCoordinates.push_back(y);
+        yIndex[keys[i] & 0xffffffffu] = static_cast<int>(yCoordinates.size()) - 1;
+    }
+    std::vector<unsigned long long>().swap(keys);
 
-    // 按 x 坐标对事件进行排序
-    std::sort(events.begin(), events.end(), compareEvents);
+    events.clear();
+    events.reserve(n * 2);
+    for (size_t i = 0; i < n; i++) {
+        int first = yIndex[i * 2], last = yIndex[i * 2 + 1] - 1;
+        events.push_back({rectangles[i].x1, first, last, 1});
+        events.push_back({rectangles[i].x2, first, last, -1});
+    }
+}
+
+// 单线程扫描，rectangles 中的矩形都不退化
+static unsigned long long sweepArea(const Rectangle *rectangles, size_t n) {
+    if (n == 0) return 0;
+
+    std::vector<LeafEvent> events;
+    std::vector<int> yCoordinates;
+    buildEvents(rectangles, n, events, yCoordinates);
 
-    // 将 y 坐标从 set 转换为 vector
-    std::vector<int> yCoordinates(yCoordinateSet.begin(), yCoordinateSet.end());
+    // 按 x 坐标对事件进行排序
+    std::sort(events.begin(), events.end(), compareLeafEvents);
 
     SegmentTree segmentTree(yCoordinates);
     int prevX = events.front().x; // 上一个 x 坐标
-    int area = 0;
+    unsigned long long area = 0;
 
     // 遍历所有事件
     for (const auto &event : events) {
         int currX = event.x; // 当前事件的 x 坐标
-        area += segmentTree.getLength() * (currX - prevX); // 计算被覆盖的面积
-        // 更新线段树，记录当前 y 坐标范围的覆盖情况
-        segmentTree.update(0, 
-                           std::lower_bound(yCoordinates.begin(), yCoordinates.end(), event.y1) - yCoordinates.begin(), 
-                           std::lower_bound(yCoordinates.begin(), yCoordinates.end(), event.y2) - yCoordinates.begin() - 1, 
-                           event.type);
+        // 被覆盖的面积，两个因子都不超过 2^32，乘积在 64 位无符号整数内
+        area += static_cast<unsigned long long>(segmentTree.getLength()) *
+                static_cast<unsigned long long>(static_cast<long long>(currX) - prevX);
+        segmentTree.update(event.first, event.last, event.type);
         prevX = currX; // 更新上一个 x 坐标
     }
 
     return area; // 返回总面积
-}
\ No newline at end of file
+}
+
+// 单线程扫描，同时累加所选的指标，rectangles 中的矩形都不退化
+// 周长的横边为各段覆盖的上下边，竖边为每个事件前后覆盖长度之差
+// skipLow / skipHigh 为 true 时不计 x 等于 lowX / highX 处的竖边，用于竖条分界线上被裁剪出的边
+static void sweepCoverage(const Rectangle *rectangles, size_t n, const CoverageOptions &options,
+                          bool skipLow, int lowX, bool skipHigh, int highX, CoverageResult &result) {
+    if (n == 0) return;
+    bool wantArea = (options.metrics & CoverArea) != 0;
+    bool wantPerimeter = (options.metrics & CoverPerimeter) != 0;
+    // 覆盖次数不超过矩形个数，更深的层次恒为 0，不必记录
+    int depth = (options.metrics & CoverDepth) != 0 ? static_cast<int>(std::min<size_t>(options.maxDepth, n)) : 0;
+
+    std::vector<LeafEvent> events;
+    std::vector<int> yCoordinates;
+    buildEvents(rectangles, n, events, yCoordinates);
+    std::sort(events.begin(), events.end(), compareEventsEnterFirst);
+
+    SegmentTree segmentTree(yCoordinates, depth, wantPerimeter);
+    int prevX = events.front().x;
+    long long prevLength = 0;
+
+    for (const auto &event : events) {
+        if (event.x != prevX) {
+            unsigned long long dx = static_cast<unsigned long long>(static_cast<long long>(event.x) - prevX);
+            if (wantArea) result.area += static_cast<unsigned long long>(segmentTree.getLength()) * dx;
+            for (int k = 1; k <= depth; k++) {
+                result.depthArea[k - 1] += static_cast<unsigned long long>(segmentTree.getDepthLength(k)) * dx;
+            }
+            if (wantPerimeter) result.perimeter += 2 * static_cast<unsigned long long>(segmentTree.getSegments()) * dx;
+            prevX = event.x;
+        }
+        segmentTree.update(event.first, event.last, event.type);
+        if (wantPerimeter) {
+            long long length = segmentTree.getLength();
+            if (!(skipLow && event.x == lowX) && !(skipHigh && event.x == highX)) {
+                result.perimeter += static_cast<unsigned long long>(length > prevLength ? length - prevLength
+                                                                                        : prevLength - length);
+            }
+            prevLength = length;
+        }
+    }
+}
+
+// y 区间 [first, second) 的并集长度，会重排 intervals
+static long long unionLength(std::vector<std::pair<int, int>> &intervals) {
+    std::sort(intervals.begin(), intervals.end());
+    long long length = 0;
+    long long coveredTo = LLONG_MIN;
+    for (const auto &interval : intervals) {
+        long long lo = std::max<long long>(interval.first, coveredTo);
+        if (interval.second > lo) {
+            length += interval.second - lo;
+            coveredTo = interval.second;
+        }
+    }
+    return length;
+}
+
+// 矩形按 x 轴切分到竖条 [cuts[i], cuts[i + 1]) 中，跨越多个竖条的矩形被裁剪成多块
+// 结果按竖条存放在 pieces[start[i], start[i + 1]) 中，返回总块数
+static size_t splitIntoSlabs(const std::vector<Rectangle> &rectangles, const std::vector<int> &cuts,
+                             std::vector<size_t> &start, std::vector<Rectangle> &pieces, bool fill) {
+    size_t slabs = cuts.size() - 1;
+    start.assign(slabs + 1, 0);
+    for (const auto &rect : rectangles) {
+        size_t first = std::upper_bound(cuts.begin(), cuts.end(), rect.x1) - cuts.begin() - 1;
+        size_t last = std::lower_bound(cuts.begin(), cuts.end(), rect.x2) - cuts.begin() - 1;
+        for (size_t s = first; s <= last; s++) start[s + 1]++;
+    }
+    for (size_t s = 0; s < slabs; s++) start[s + 1] += start[s];
+    if (!fill) return start[slabs];
+
+    pieces.resize(start[slabs]);
+    std::vector<size_t> pos(start.begin(), start.end() - 1);
+    for (const auto &rect : rectangles) {
+        size_t first = std::upper_bound(cuts.begin(), cuts.end(), rect.x1) - cuts.begin() - 1;
+        size_t last = std::lower_bound(cuts.begin(), cuts.end(), rect.x2) - cuts.begin() - 1;
+        for (size_t s = first; s <= last; s++) {
+            pieces[pos[s]++] = {std::max(rect.x1, cuts[s]), rect.y1, std::min(rect.x2, cuts[s + 1]), rect.y2};
+        }
+    }
+    return start[slabs];
+}
+
+// 按抽样得到的 x 坐标分位数选取 slabs - 1 条切分线
+static std::vector<int> chooseCuts(const std::vector<Rectangle> &rectangles, size_t slabs) {
+    std::vector<int> samples;
+    size_t step = std::max<size_t>(1, rectangles.size() / (slabs * 64));
+    for (size_t i = 0; i < rectangles.size(); i += step) {
+        samples.push_back(rectangles[i].x1);
+        samples.push_back(rectangles[i].x2);
+    }
+    std::sort(samples.begin(), samples.end());
+    std::vector<int> cuts(1, INT_MIN);
+    for (size_t i = 1; i < slabs; i++) {
+        int x = samples[samples.size() * i / slabs];
+        if (x > cuts.back()) cuts.push_back(x);
+    }
+    cuts.push_back(INT_MAX);
+    return cuts;
+}
+
+// 跳过面积为 0 的矩形
+static std::vector<Rectangle> nonEmptyRectangles(const std::vector<Rectangle> &rectangles) {
+    std::vector<Rectangle> valid;
+    valid.reserve(rectangles.size());
+    for (const auto &rect : rectangles) {
+        if (rect.x1 < rect.x2 && rect.y1 < rect.y2) valid.push_back(rect);
+    }
+    return valid;
+}
+
+// 把矩形切分到竖条中，不值得切分时返回 false，此时 valid 保持不变，应直接单线程扫描
+// 每个竖条约 slabSize 个矩形，使线段树能放进缓存；并行时竖条数至少为线程数的 4 倍以平衡负载
+static bool splitForSweep(std::vector<Rectangle> &valid, int threads, std::vector<int> &cuts,
+                          std::vector<size_t> &start, std::vector<Rectangle> &pieces) {
+    const size_t slabSize = 1 << 16;
+    size_t slabs = std::max(valid.size() / slabSize, threads > 1 ? static_cast<size_t>(threads) * 4 : 1);
+    if (valid.size() < slabSize || slabs <= 1) return false;
+
+    // 宽矩形会被复制到多个竖条中，裁剪后的总块数过多时减少竖条数
+    for (;;) {
+        cuts = chooseCuts(valid, slabs);
+        size_t total = splitIntoSlabs(valid, cuts, start, pieces, false);
+        if (total <= valid.size() * 2 || slabs <= static_cast<size_t>(threads)) break;
+        slabs /= 2;
+    }
+    if (cuts.size() <= 2) return false;
+    splitIntoSlabs(valid, cuts, start, pieces, true);
+    std::vector<Rectangle>().swap(valid);
+    return true;
+}
+
+// 计算矩形覆盖的总面积
+unsigned long long calculateArea(const std::vector<Rectangle> &rectangles, int threads) {
+    GEOM_STATS_TIMER(CalculateArea);
+    std::vector<Rectangle> valid = nonEmptyRectangles(rectangles);
+
+    if (threads <= 0) threads = globalThreads();
+    std::vector<int> cuts;
+    std::vector<size_t> start;
+    std::vector<Rectangle> pieces;
+    if (!splitForSweep(valid, threads, cuts, start, pieces)) return sweepArea(valid.data(), valid.size());
+
+    std::vector<unsigned long long> partial(cuts.size() - 1, 0);
+    parallelFor(partial.size(), 1, [&pieces, &start, &partial](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) partial[i] = sweepArea(pieces.data() + start[i], start[i + 1] - start[i]);
+    }, threads);
+
+    unsigned long long area = 0;
+    for (size_t i = 0; i < partial.size(); i++) area += partial[i];
+    return area;
+}
+
+CoverageResult calculateCoverage(const std::vector<Rectangle> &rectangles, const CoverageOptions &options,
+                                 int threads) {
+    GEOM_STATS_TIMER(CalculateCoverage);
+    if ((options.metrics & CoverDepth) != 0 && options.maxDepth <= 0) {
+        throw std::invalid_argument("calculateCoverage: maxDepth must be positive");
+    }
+    size_t depth = (options.metrics & CoverDepth) != 0 ? static_cast<size_t>(options.maxDepth) : 0;
+    std::vector<Rectangle> valid = nonEmptyRectangles(rectangles);
+
+    CoverageResult result;
+    result.depthArea.assign(depth, 0);
+    if (threads <= 0) threads = globalThreads();
+    std::vector<int> cuts;
+    std::vector<size_t> start;
+    std::vector<Rectangle> pieces;
+    if (!splitForSweep(valid, threads, cuts, start, pieces)) {
+        sweepCoverage(valid.data(), valid.size(), options, false, 0, false, 0, result);
+        return result;
+    }
+
+    // 各竖条不计分界线上的竖边，所有指标按竖条相加
+    size_t slabs = cuts.size() - 1;
+    std::vector<CoverageResult> partial(slabs, result);
+    parallelFor(slabs, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sweepCoverage(pieces.data() + start[i], start[i + 1] - start[i], options, i > 0, cuts[i], i + 1 < slabs,
+                          cuts[i + 1], partial[i]);
+        }
+    }, threads);
+    for (size_t i = 0; i < slabs; i++) {
+        result.area += partial[i].area;
+        result.perimeter += partial[i].perimeter;
+        for (size_t k = 0; k < depth; k++) result.depthArea[k] += partial[i].depthArea[k];
+    }
+
+    // 分界线 x = c 上的竖边为左右两侧覆盖范围的对称差：左侧为在 c 处结束的块，右侧为从 c 开始的块
+    if ((options.metrics & CoverPerimeter) != 0) {
+        for (size_t s = 1; s < slabs; s++) {
+            std::vector<std::pair<int, int>> left, right, both;
+            for (size_t i = start[s - 1]; i < start[s]; i++) {
+                if (pieces[i].x2 == cuts[s]) left.push_back(std::make_pair(pieces[i].y1, pieces[i].y2));
+            }
+            for (size_t i = start[s]; i < start[s + 1]; i++) {
+                if (pieces[i].x1 == cuts[s]) right.push_back(std::make_pair(pieces[i].y1, pieces[i].y2));
+            }
+            both = left;
+            both.insert(both.end(), right.begin(), right.end());
+            long long united = unionLength(both);
+            result.perimeter += static_cast<unsigned long long>(2 * united - unionLength(left) - unionLength(right));
+        }
+    }
+    return result;
+}
+
+// 动态开点线段树，覆盖整个 int 范围，叶子 y 对应区间 [y, y + 1)
+// 覆盖长度为 0 的子树立即回收，节点数只与当前覆盖的区间有关
+class CoverageTree {
+public:
+    CoverageTree() : root(-1) {}
+
+    // 区间 [y1, y2] 内的叶子覆盖次数加 value
+    void update(int y1, int y2, int value) {
+        GEOM_STATS_ADD(SegmentTreeUpdates, 1);
+        root = update(root, INT_MIN, INT_MAX, y1, y2, value);
+    }
+
+    long long getLength() const {
+        return root == -1 ? 0 : nodes[root].length;
+    }
+
+private:
+    struct Node {
+        int left, right;   // 子节点，-1 表示整个子区间未被覆盖
+        int count;         // 被完整覆盖的次数
+        long long length;  // 区间内被覆盖的长度
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    int root;
+
+    int create() {
+        Node empty = {-1, -1, 0, 0};
+        if (!freeNodes.empty()) {
+            int node = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[node] = empty;
+            return node;
+        }
+        nodes.push_back(empty);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    void release(int node) {
+        if (node == -1) return;
+        release(nodes[node].left);
+        release(nodes[node].right);
+        freeNodes.push_back(node);
+    }
+
+    // 返回更新后的节点，子树不再有覆盖时返回 -1
+    int update(int node, long long lo, long long hi, long long y1, long long y2, int value) {
+        GEOM_STATS_ADD(SegmentTreeNodeVisits, 1);
+        if (node == -1) node = create();
+        if (y1 <= lo && hi <= y2) {
+            nodes[node].count += value;
+        } else {
+            long long mid = lo + (hi - lo) / 2;
+            if (y1 <= mid) {
+                int child = update(nodes[node].left, lo, mid, y1, y2, value);
+                nodes[node].left = child;
+            }
+            if (y2 > mid) {
+                int child = update(nodes[node].right, mid + 1, hi, y1, y2, value);
+                nodes[node].right = child;
+            }
+        }
+
+        Node &cur = nodes[node];
+        if (cur.count > 0) {
+            cur.length = hi - lo + 1;
+        } else {
+            cur.length = (cur.left == -1 ? 0 : nodes[cur.left].length) +
+                         (cur.right == -1 ? 0 : nodes[cur.right].length);
+        }
+        if (cur.count == 0 && cur.length == 0) {
+            release(node);
+            return -1;
+        }
+        return node;
+    }
+};
+
+// 临时文件可能超过 2GB，使用 64 位偏移定位
+static int seekTo(FILE *file, long long offset) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+// 临时文件中的一段有序事件，按块读回
+class EventRun {
+public:
+    EventRun(FILE *file, long long offset, size_t count, size_t bufferSize)
+        : file(file), offset(offset), remaining(count), bufferSize(bufferSize), pos(0) {}
+
+    // 取出当前事件，没有事件时返回 false
+    bool peek(Event &event) {
+        if (pos == buffer.size() && !refill()) return false;
+        event = buffer[pos];
+        return true;
+    }
+
+    void pop() { pos++; }
+
+private:
+    FILE *file;
+    long long offset;     // 下一个未读事件在文件中的位置
+    size_t remaining;     // 文件中尚未读入的事件数
+    size_t bufferSize;
+    size_t pos;
+    std::vector<Event> buffer;
+
+    bool refill() {
+        if (remaining == 0) return false;
+        size_t count = std::min(remaining, bufferSize);
+        buffer.resize(count);
+        if (seekTo(file, offset) != 0 ||
+            fread(buffer.data(), sizeof(Event), count, file) != count) {
+            throw std::runtime_error("calculateAreaStreaming: failed to read temporary file");
+        }
+        offset += static_cast<long long>(count * sizeof(Event));
+        remaining -= count;
+        pos = 0;
+        return true;
+    }
+};
+
+// 把事件按块顺序写入临时文件，组成新的一段
+class EventWriter {
+public:
+    EventWriter(FILE *file, long long offset, size_t bufferSize)
+        : file(file), offset(offset), count(0), bufferSize(bufferSize) {
+        buffer.reserve(bufferSize);
+    }
+
+    void add(const Event &event) {
+        buffer.push_back(event);
+        if (buffer.size() == bufferSize) flush();
+    }
+
+    // 写出缓冲区中的事件，返回这一段的起始位置和事件数
+    std::pair<long long, size_t> finish() {
+        flush();
+        return std::make_pair(offset, count);
+    }
+
+private:
+    FILE *file;
+    long long offset;  // 这一段在文件中的起始位置
+    size_t count;      // 已写出的事件数
+    size_t bufferSize;
+    std::vector<Event> buffer;
+
+    void flush() {
+        if (buffer.empty()) return;
+        if (seekTo(file, offset + static_cast<long long>(count * sizeof(Event))) != 0 ||
+            fwrite(buffer.data(), sizeof(Event), buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("calculateAreaStreaming: failed to write temporary file");
+        }
+        count += buffer.size();
+        buffer.clear();
+    }
+};
+
+// 每次最多同时归并的段数，读缓冲区的总大小因此与段数无关
+static const size_t MERGE_FAN_IN = 64;
+
+// 把文件中 runs[first, last) 这几段归并后依次交给 output.add
+template <typename Output>
+static void mergeRuns(FILE *file, const std::vector<std::pair<long long, size_t>> &runs, size_t first, size_t last,
+                      size_t bufferSize, Output &output) {
+    std::vector<EventRun> readers;
+    readers.reserve(last - first);
+    for (size_t i = first; i < last; i++) readers.push_back(EventRun(file, runs[i].first, runs[i].second, bufferSize));
+
+    typedef std::pair<int, size_t> Head;  // 段首事件的 x 坐标和段号
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    Event event = {0, 0, 0, 0};
+    for (size_t i = 0; i < readers.size(); i++) {
+        if (readers[i].peek(event)) heads.push(std::make_pair(event.x, i));
+    }
+    while (!heads.empty()) {
+        size_t i = heads.top().second;
+        heads.pop();
+        readers[i].peek(event);
+        readers[i].pop();
+        output.add(event);
+        if (readers[i].peek(event)) heads.push(std::make_pair(event.x, i));
+    }
+}
+
+// 按 x 坐标顺序依次处理事件，累加覆盖面积
+class AreaSweep {
+public:
+    AreaSweep() : started(false), prevX(0), area(0) {}
+
+    void add(const Event &event) {
+        if (started) {
+            area += static_cast<unsigned long long>(tree.getLength()) *
+                    static_cast<unsigned long long>(static_cast<long long>(event.x) - prevX);
+        }
+        tree.update(event.y1, event.y2 - 1, event.type);
+        prevX = event.x;
+        started = true;
+    }
+
+    unsigned long long getArea() const { return area; }
+
+private:
+    CoverageTree tree;
+    bool started;
+    int prevX;
+    unsigned long long area;
+};
+
+unsigned long long calculateAreaStreaming(const RectangleSource &source, size_t chunkRectangles) {
+    GEOM_STATS_TIMER(CalculateAreaStreaming);
+    chunkRectangles = std::max<size_t>(chunkRectangles, 1);
+    std::vector<Rectangle> chunk(chunkRectangles);
+    std::vector<Event> events;
+    events.reserve(chunkRectangles * 2);
+
+    FILE *spill = nullptr;
+    std::vector<std::pair<long long, size_t>> runs;  // 每段在临时文件中的起始位置和事件数
+    long long written = 0;
+
+    try {
+        for (;;) {
+            // 读满一块或读到结尾
+            size_t count = 0;
+            while (count < chunkRectangles) {
+                size_t got = source(chunk.data() + count, chunkRectangles - count);
+                if (got == 0) break;
+                count += got;
+            }
+
+            events.clear();
+            for (size_t i = 0; i < count; i++) {
+                const Rectangle &rect = chunk[i];
+                if (rect.x1 >= rect.x2 || rect.y1 >= rect.y2) continue;
+                events.push_back({rect.x1, rect.y1, rect.y2, 1});
+                events.push_back({rect.x2, rect.y1, rect.y2, -1});
+            }
+            std::sort(events.begin(), events.end(), compareEvents);
+
+            // 全部输入只有一块时直接在内存中扫描
+            if (count < chunkRectangles && runs.empty()) {
+                AreaSweep sweep;
+                for (const auto &event : events) sweep.add(event);
+                return sweep.getArea();
+            }
+
+            if (!events.empty()) {
+                if (spill == nullptr && (spill = tmpfile()) == nullptr) {
+                    throw std::runtime_error("calculateAreaStreaming: failed to create temporary file");
+                }
+                if (fwrite(events.data(), sizeof(Event), events.size(), spill) != events.size()) {
+                    throw std::runtime_error("calculateAreaStreaming: failed to write temporary file");
+                }
+                runs.push_back(std::make_pair(written, events.size()));
+                written += static_cast<long long>(events.size() * sizeof(Event));
+            }
+            if (count < chunkRectangles) break;
+        }
+        std::vector<Rectangle>().swap(chunk);
+        std::vector<Event>().swap(events);
+        if (runs.empty()) return 0;
+        fflush(spill);
+
+        // 多路归并，每次最多归并 MERGE_FAN_IN 段：段数较多时先逐轮把每 MERGE_FAN_IN 段归并为一段写入新的临时文件
+        // 各段的读缓冲区总大小与一块的事件数相当，内存占用与段数无关
+        size_t bufferSize = std::max<size_t>(1024, chunkRectangles * 2 / std::min(runs.size(), MERGE_FAN_IN));
+        while (runs.size() > MERGE_FAN_IN) {
+            FILE *next = tmpfile();
+            if (next == nullptr) throw std::runtime_error("calculateAreaStreaming: failed to create temporary file");
+            std::vector<std::pair<long long, size_t>> merged;
+            long long offset = 0;
+            try {
+                for (size_t first = 0; first < runs.size(); first += MERGE_FAN_IN) {
+                    EventWriter writer(next, offset, bufferSize);
+                    mergeRuns(spill, runs, first, std::min(runs.size(), first + MERGE_FAN_IN), bufferSize, writer);
+                    merged.push_back(writer.finish());
+                    offset += static_cast<long long>(merged.back().second * sizeof(Event));
+                }
+                fflush(next);
+            } catch (...) {
+                fclose(next);
+                throw;
+            }
+            fclose(spill);
+            spill = next;
+            runs.swap(merged);
+        }
+
+        AreaSweep sweep;
+        mergeRuns(spill, runs, 0, runs.size(), bufferSize, sweep);
+        fclose(spill);
+        return sweep.getArea();
+    } catch (...) {
+        if (spill != nullptr) fclose(spill);
+        throw;
+    }
+}
+
+unsigned long long calculateAreaFromFile(const std::string &path, size_t chunkRectangles) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) throw std::runtime_error("calculateAreaFromFile: cannot open " + path);
+
+    // Rectangle 由 4 个 int 组成，与文件中的记录布局相同，可以整块读入
+    // 按字节读入，文件末尾不足一条记录的字节说明文件被截断，不能悄悄丢弃
+    static_assert(sizeof(Rectangle) == 4 * sizeof(int), "Rectangle must match the file record layout");
+    RectangleSource source = [file, &path](Rectangle *buffer, size_t capacity) {
+        size_t bytes = fread(buffer, 1, capacity * sizeof(Rectangle), file);
+        if (ferror(file)) throw std::runtime_error("calculateAreaFromFile: failed to read " + path);
+        if (bytes % sizeof(Rectangle) != 0) {
+            throw std::runtime_error("calculateAreaFromFile: truncated record at the end of " + path);
+        }
+        return bytes / sizeof(Rectangle);
+    };
+    try {
+        unsigned long long area = calculateAreaStreaming(source, chunkRectangles);
+        fclose(file);
+        return area;
+    } catch (...) {
+        fclose(file);
+        throw;
+    }
+}
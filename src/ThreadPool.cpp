@@ -0,0 +1,199 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+// 当前线程所属的线程池与队列编号，非工作线程为 -1
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local int currentQueue = -1;
+
+ThreadPool::ThreadPool(int workers) : stopping(false), pending(0), nextQueue(0) {
+    if (workers < 0) workers = 0;
+    for (int i = 0; i < workers; ++i) queues.emplace_back(new Queue());
+    for (int i = 0; i < workers; ++i) threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    if (queues.empty()) {
+        task();
+        return;
+    }
+    int index = (currentPool == this) ? currentQueue
+                                      : static_cast<int>(nextQueue++ % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    pending++;
+    // 先获取 sleepMutex 再通知，避免工作线程检查完条件、尚未进入等待时错过通知
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+// 先从自己队列的队尾取任务，再依次从其他队列的队首窃取
+bool ThreadPool::takeTask(int self, std::function<void()>& task) {
+    if (pending == 0) return false;
+    int count = static_cast<int>(queues.size());
+    if (self >= 0) {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+    int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < count; ++k) {
+        int index = (start + k) % count;
+        if (index == self) continue;
+        Queue& victim = *queues[index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+    if (!takeTask(currentPool == this ? currentQueue : -1, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentPool = this;
+    currentQueue = index;
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if (stopping && pending == 0) return;
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool), pending(0) {}
+
+TaskGroup::~TaskGroup() {
+    // 析构时必须等待任务结束，任务可能引用调用方栈上的数据
+    while (pending > 0) {
+        if (!pool.runPendingTask()) std::this_thread::yield();
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending++;
+    pool.submit([this, task] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        pending--;
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending > 0) {
+        if (!pool.runPendingTask()) std::this_thread::yield();
+    }
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+// 不析构，线程在静态对象销毁之后仍可提交任务
+static std::mutex globalMutex;
+static ThreadPool* globalInstance = nullptr;
+static int globalThreadCount = 0;
+
+static int hardwareThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+ThreadPool& globalPool() {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    if (globalInstance == nullptr) {
+        if (globalThreadCount <= 0) globalThreadCount = hardwareThreads();
+        globalInstance = new ThreadPool(globalThreadCount - 1);
+    }
+    return *globalInstance;
+}
+
+void setGlobalThreads(int threads) {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    if (globalInstance != nullptr) throw std::logic_error("ThreadPool: global pool is already running");
+    globalThreadCount = threads > 0 ? threads : hardwareThreads();
+}
+
+int globalThreads() {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    if (globalInstance != nullptr) return globalInstance->size() + 1;
+    return globalThreadCount > 0 ? globalThreadCount : hardwareThreads();
+}
+
+void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& body, int threads) {
+    if (n == 0) return;
+    if (threads == 1) {
+        body(0, n);
+        return;
+    }
+    ThreadPool& pool = globalPool();
+    int participants = pool.size() + 1;
+    if (threads > 1) participants = std::min(participants, threads);
+    if (grain == 0) grain = std::max<size_t>(1, n / (static_cast<size_t>(participants) * 4));
+    size_t chunks = (n - 1) / grain + 1;
+    if (participants == 1 || chunks == 1) {
+        body(0, n);
+        return;
+    }
+    participants = static_cast<int>(std::min(static_cast<size_t>(participants), chunks));
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t c = next++; c < chunks; c = next++) {
+            try {
+                body(c * grain, std::min(n, (c + 1) * grain));
+            } catch (...) {
+                next = chunks;
+                throw;
+            }
+        }
+    };
+    TaskGroup group(pool);
+    for (int i = 1; i < participants; i++) group.run(work);
+    std::exception_ptr error;
+    try {
+        work();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    try {
+        group.wait();
+    } catch (...) {
+        if (!error) error = std::current_exception();
+    }
+    if (error) std::rethrow_exception(error);
+}
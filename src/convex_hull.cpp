@@ -1,12 +1,9 @@
 #include "convex_hull.h"
+#include "predicates.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
-
-// 计算叉积
-static double cross(const Point& p1, const Point& p2) {
-    return p1.x * p2.y - p1.y * p2.x;
-}
+#include <stdexcept>
 
 // 比较函数用于排序
 static bool cmp(const Point& p1, const Point& p2, const Point& p1_ref) {
@@ -33,9 +30,6 @@ std::vector<Point> ConvexHull::grahamScan(std::vector<Point>& points) {
     std::swap(points[0], points[min_point_idx]);
 
     Point p1_ref = points[0];
-    for (int i = 1; i < n; ++i) {
-        points[i].ang = atan2(points[i].y - p1_ref.y, points[i].x - p1_ref.x);
-    }
 
     std::sort(points.begin() + 1, points.end(), [p1_ref](const Point& p1, const Point& p2) {
         return cmp(p1, p2, p1_ref);
@@ -44,7 +38,7 @@ std::vector<Point> ConvexHull::grahamScan(std::vector<Point>& points) {
     // 调试输出排序后的点
     std::cout << "Sorted Points:\n";
     for (const auto& p : points) {
-        std::cout << "(" << p.x << ", " << p.y << ") Angle: " << p.ang << "\n";
+        std::cout << "(" << p.x << ", " << p.y << ") Angle: " << atan2(p.y - p1_ref.y, p.x - p1_ref.x) << "\n";
     }
 
     std::vector<Point> hull;
@@ -55,7 +49,7 @@ std::vector<Point> ConvexHull::grahamScan(std::vector<Point>& points) {
         std::cout << "Processing Point: (" << points[i].x << ", " << points[i].y << ")\n";
 
         // 检查是否右拐，如果是则弹出栈顶的点
-        while (hull.size() >= 2 && cross(hull[hull.size() - 1] - hull[hull.size() - 2], points[i] - hull[hull.size() - 1]) <= 0) {
+        while (hull.size() >= 2 && predicates::orient2d(hull[hull.size() - 2], hull[hull.size() - 1], points[i]) <= 0) {
             std::cout << "Popping Point: (" << hull.back().x << ", " << hull.back().y << ")\n";
             hull.pop_back();
         }
@@ -75,3 +69,263 @@ std::vector<Point> ConvexHull::grahamScan(std::vector<Point>& points) {
 
     return hull;
 }
+
+// 方向判断：c 在有向直线 a -> b 的左侧为正，右侧为负，共线为 0
+static double orient(const Point& a, const Point& b, const Point& c) {
+    return predicates::orient2d(a, b, c);
+}
+
+static bool samePoint(const Point& a, const Point& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+// 把凸包旋转到从最低（其次最左）的点开始
+static void rotateToLowest(std::vector<Point>& hull) {
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull.size(); ++i) {
+        if (hull[i].y < hull[lowest].y || (hull[i].y == hull[lowest].y && hull[i].x < hull[lowest].x)) {
+            lowest = i;
+        }
+    }
+    std::rotate(hull.begin(), hull.begin() + lowest, hull.end());
+}
+
+// Andrew 单调链：按 (x, y) 排序后分别构造下凸壳和上凸壳，会对 points 排序
+std::vector<Point> ConvexHull::monotoneChain(std::vector<Point>& points) {
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    std::vector<Point> hull;
+    // 下凸壳，从左到右
+    for (size_t i = 0; i < points.size(); ++i) {
+        while (hull.size() >= 2 && orient(hull[hull.size() - 2], hull.back(), points[i]) <= 0) {
+            hull.pop_back();
+        }
+        hull.push_back(points[i]);
+    }
+    // 上凸壳，从右到左，起点（最右点）已在下凸壳中
+    size_t lowerSize = hull.size();
+    for (size_t i = points.size() - 1; i-- > 0;) {
+        while (hull.size() > lowerSize && orient(hull[hull.size() - 2], hull.back(), points[i]) <= 0) {
+            hull.pop_back();
+        }
+        hull.push_back(points[i]);
+    }
+    hull.pop_back();  // 最后一个点是起点
+
+    // 所有点重合时只保留一个
+    if (hull.size() == 2 && samePoint(hull[0], hull[1])) hull.pop_back();
+    return hull;
+}
+
+// 礼品包装法，O(nh)，凸包点数超过 maxHullSize 时放弃并返回 false
+bool ConvexHull::giftWrapping(const std::vector<Point>& points, size_t maxHullSize, std::vector<Point>& hull) {
+    size_t start = 0;
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (points[i].y < points[start].y || (points[i].y == points[start].y && points[i].x < points[start].x)) {
+            start = i;
+        }
+    }
+
+    // 凸包恰好有 maxHullSize 个顶点时，最后一个顶点的下一个点就是起点，不算超出
+    hull.clear();
+    size_t current = start;
+    do {
+        hull.push_back(points[current]);
+
+        // 找到使所有点都在 current -> next 左侧的点，共线时取最远的点
+        const Point& cur = points[current];
+        size_t next = current;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (samePoint(points[i], cur)) continue;
+            if (next == current) {
+                next = i;
+                continue;
+            }
+            double o = orient(cur, points[next], points[i]);
+            if (o < 0 || (o == 0 && (points[i].x - cur.x) * (points[i].x - cur.x) + (points[i].y - cur.y) * (points[i].y - cur.y) >
+                                    (points[next].x - cur.x) * (points[next].x - cur.x) + (points[next].y - cur.y) * (points[next].y - cur.y))) {
+                next = i;
+            }
+        }
+        if (next == current) break;  // 所有点重合
+        current = next;
+        // 还没有回到起点，说明还有顶点要加入，此时已有 maxHullSize 个顶点则放弃
+        if (!samePoint(points[current], points[start]) && hull.size() >= maxHullSize) return false;
+    } while (!samePoint(points[current], points[start]));
+    return true;
+}
+
+// 输出敏感模式下礼品包装的顶点数上限 ceil(log2 n)，凸包顶点数不超过它时由礼品包装法完成
+static size_t wrappingBudget(size_t n) {
+    size_t budget = 1;
+    while ((static_cast<size_t>(1) << budget) < n) ++budget;
+    return budget;
+}
+
+std::vector<Point> ConvexHull::compute(std::vector<Point>& points, const Options& options) {
+    if (options.preserveInput) return compute(static_cast<const std::vector<Point>&>(points), options);
+    if (points.size() <= 1) return points;
+
+    std::vector<Point> hull;
+    if (options.outputSensitive && giftWrapping(points, wrappingBudget(points.size()), hull)) return hull;
+    hull = monotoneChain(points);
+    rotateToLowest(hull);
+    return hull;
+}
+
+std::vector<Point> ConvexHull::compute(const std::vector<Point>& points, const Options& options) {
+    if (points.size() <= 1) return points;
+
+    std::vector<Point> hull;
+    if (options.outputSensitive && giftWrapping(points, wrappingBudget(points.size()), hull)) return hull;
+    std::vector<Point> sorted(points);
+    hull = monotoneChain(sorted);
+    rotateToLowest(hull);
+    return hull;
+}
+
+// 与 monotoneChain 相同，但只对下标排序，不移动视图中的点
+std::vector<int> ConvexHull::hullIndices(const PointView& points) {
+    int n = static_cast<int>(points.size());
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    if (n <= 1) return order;
+
+    std::sort(order.begin(), order.end(), [&points](int a, int b) {
+        return points.x(a) < points.x(b) || (points.x(a) == points.x(b) && points.y(a) < points.y(b));
+    });
+    auto turn = [&points](int a, int b, int c) {
+        return predicates::orient2d(points.x(a), points.y(a), points.x(b), points.y(b), points.x(c), points.y(c));
+    };
+
+    std::vector<int> hull;
+    for (int i = 0; i < n; ++i) {
+        while (hull.size() >= 2 && turn(hull[hull.size() - 2], hull.back(), order[i]) <= 0) hull.pop_back();
+        hull.push_back(order[i]);
+    }
+    size_t lowerSize = hull.size();
+    for (int i = n - 1; i-- > 0;) {
+        while (hull.size() > lowerSize && turn(hull[hull.size() - 2], hull.back(), order[i]) <= 0) hull.pop_back();
+        hull.push_back(order[i]);
+    }
+    hull.pop_back();
+    if (hull.size() == 2 && points.x(hull[0]) == points.x(hull[1]) && points.y(hull[0]) == points.y(hull[1])) {
+        hull.pop_back();
+    }
+
+    // 从最低（其次最左）的点开始
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull.size(); ++i) {
+        int a = hull[i], b = hull[lowest];
+        if (points.y(a) < points.y(b) || (points.y(a) == points.y(b) && points.x(a) < points.x(b))) lowest = i;
+    }
+    std::rotate(hull.begin(), hull.begin() + lowest, hull.end());
+    return hull;
+}
+
+// 以 origin 为原点、单位向量 u 及其左法向为坐标轴，沿 u 的范围为 [minT, maxT]，法向范围为 [0, height]
+static ConvexHull::EnclosingRectangle makeRectangle(const Point& origin, double ux, double uy,
+                                                    double minT, double maxT, double height) {
+    ConvexHull::EnclosingRectangle rect;
+    double nx = -uy, ny = ux;
+    rect.corners[0] = Point(origin.x + ux * minT, origin.y + uy * minT);
+    rect.corners[1] = Point(origin.x + ux * maxT, origin.y + uy * maxT);
+    rect.corners[2] = Point(rect.corners[1].x + nx * height, rect.corners[1].y + ny * height);
+    rect.corners[3] = Point(rect.corners[0].x + nx * height, rect.corners[0].y + ny * height);
+    rect.length = maxT - minT;
+    rect.height = height;
+    rect.area = rect.length * height;
+    rect.perimeter = 2 * (rect.length + height);
+    return rect;
+}
+
+// 指针沿凸包前进，直到下一步使 gain 不再增加，重复点直接跳过
+// 指针最多绕一圈，防止舍入误差使输入略微不凸时无限前进
+template <typename Gain>
+static size_t advancePointer(const std::vector<Point>& hull, size_t k, const Gain& gain) {
+    size_t h = hull.size();
+    for (size_t s = 0; s < h; s++) {
+        size_t next = k + 1 == h ? 0 : k + 1;
+        double dx = hull[next].x - hull[k].x, dy = hull[next].y - hull[k].y;
+        if ((dx != 0 || dy != 0) && gain(dx, dy) <= 0) break;
+        k = next;
+    }
+    return k;
+}
+
+// 对每条边维护三个单调前进的指针：沿边方向最远的点、离边所在直线最远的点、沿边方向最近的点
+// 最远点对一定是某条边的端点与其对踵点，最小宽度和两种最小外接矩形都有一条边与凸包的边共线
+ConvexHull::Calipers ConvexHull::rotatingCalipers(const std::vector<Point>& hull) {
+    size_t h = hull.size();
+    if (h == 0) throw std::invalid_argument("ConvexHull::rotatingCalipers: hull is empty");
+
+    Calipers result;
+    result.diameter = {hull[0], hull[0], 0};
+    result.width = {0, hull[0], hull[0], hull[0]};
+    result.minArea = result.minPerimeter = makeRectangle(hull[0], 1, 0, 0, 0, 0);
+    double bestDistance2 = 0;
+    bool haveEdge = false;
+
+    auto next = [h](size_t k) { return k + 1 == h ? 0 : k + 1; };
+    auto dot = [](double ax, double ay, double bx, double by) { return ax * bx + ay * by; };
+    auto updateDiameter = [&](const Point& a, const Point& b) {
+        double d2 = (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+        if (d2 > bestDistance2) {
+            bestDistance2 = d2;
+            result.diameter.a = a;
+            result.diameter.b = b;
+        }
+    };
+
+    size_t right = 0, top = 0, left = 0;
+    for (size_t i = 0; i < h; i++) {
+        const Point& a = hull[i];
+        const Point& b = hull[next(i)];
+        double ex = b.x - a.x, ey = b.y - a.y;
+        double length = std::sqrt(ex * ex + ey * ey);
+        if (length == 0) continue;  // 重复点
+
+        if (!haveEdge) right = next(i);
+        right = advancePointer(hull, right, [ex, ey](double dx, double dy) { return dx * ex + dy * ey; });
+        if (!haveEdge) top = right;
+        top = advancePointer(hull, top, [ex, ey](double dx, double dy) { return ex * dy - ey * dx; });
+        if (!haveEdge) left = top;
+        left = advancePointer(hull, left, [ex, ey](double dx, double dy) { return -(dx * ex + dy * ey); });
+
+        updateDiameter(a, hull[top]);
+        updateDiameter(b, hull[top]);
+
+        double ux = ex / length, uy = ey / length;
+        double height = ux * (hull[top].y - a.y) - uy * (hull[top].x - a.x);
+        double maxT = dot(ux, uy, hull[right].x - a.x, hull[right].y - a.y);
+        double minT = dot(ux, uy, hull[left].x - a.x, hull[left].y - a.y);
+        double area = (maxT - minT) * height, perimeter = 2 * (maxT - minT + height);
+
+        if (!haveEdge || height < result.width.width) result.width = {height, a, b, hull[top]};
+        if (!haveEdge || area < result.minArea.area) result.minArea = makeRectangle(a, ux, uy, minT, maxT, height);
+        if (!haveEdge || perimeter < result.minPerimeter.perimeter) {
+            result.minPerimeter = makeRectangle(a, ux, uy, minT, maxT, height);
+        }
+        haveEdge = true;
+    }
+    result.diameter.distance = std::sqrt(bestDistance2);
+    return result;
+}
+
+ConvexHull::FarthestPair ConvexHull::diameter(const std::vector<Point>& hull) {
+    return rotatingCalipers(hull).diameter;
+}
+
+ConvexHull::Width ConvexHull::minWidth(const std::vector<Point>& hull) {
+    return rotatingCalipers(hull).width;
+}
+
+ConvexHull::EnclosingRectangle ConvexHull::minAreaRectangle(const std::vector<Point>& hull) {
+    return rotatingCalipers(hull).minArea;
+}
+
+ConvexHull::EnclosingRectangle ConvexHull::minPerimeterRectangle(const std::vector<Point>& hull) {
+    return rotatingCalipers(hull).minPerimeter;
+}
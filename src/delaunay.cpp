@@ -1,63 +1,117 @@
 #include "delaunay.h"
+#include "ThreadPool.h"
+#include "predicates.h"
+#include "stats.h"
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
-const double EPS = 1e-8;
-
-struct Point3D {
-    double x, y, z;
-    Point3D(double a = 0, double b = 0, double c = 0) : x(a), y(b), z(c) {}
-    Point3D(const Point& p) : x(p.x), y(p.y), z(p.x * p.x + p.y * p.y) {}
-    Point3D operator-(const Point3D& p) const { return Point3D(x - p.x, y - p.y, z - p.z); }
-    double dot(const Point3D& p) const { return x * p.x + y * p.y + z * p.z; }
-
-    static Point3D cross(const Point3D& a, const Point3D& b) {
-        return Point3D(
-            a.y * b.z - a.z * b.y,
-            a.z * b.x - a.x * b.z,
-            a.x * b.y - a.y * b.x
-        );
-    }
-};
+using predicates::sign;
 
+// 方向判断使用自适应精度谓词，符号总是精确的
 double Delaunay::cross(const Point& o, const Point& a, const Point& b) {
-    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
-}
-
-inline int cmp(double x) {
-    if (std::fabs(x) < EPS) return 0;
-    else return x < 0 ? -1 : 1;
+    return predicates::orient2d(o, a, b);
 }
 
 int Delaunay::intersection(const Point &a, const Point &b, const Point &c, const Point &d) {
-    return cmp(cross(a, c, b)) * cmp(cross(a, b, d)) > 0 &&
-           cmp(cross(c, a, d)) * cmp(cross(c, d, b)) > 0;
+    GEOM_STATS_ADD(DelaunayIntersection, 1);
+    return sign(cross(a, c, b)) * sign(cross(a, b, d)) > 0 &&
+           sign(cross(c, a, d)) * sign(cross(c, d, b)) > 0;
 }
 
 int Delaunay::inCircle(const Point &a, Point b, Point c, const Point &p) {
+    GEOM_STATS_ADD(DelaunayInCircle, 1);
     if (cross(a, b, c) < 0) std::swap(b, c);
-    Point3D a3(a), b3(b), c3(c), p3(p);
-    b3 = b3 - a3, c3 = c3 - a3, p3 = p3 - a3;
-    Point3D f = Point3D::cross(b3, c3);
-    return cmp(p3.dot(f));  // check same direction, in: < 0, on: = 0, out: > 0
+    return -sign(predicates::incircle(a, b, c, p));  // in: < 0, on: = 0, out: > 0
 }
 
-void Delaunay::init(int n, Point p[]) {
+void Delaunay::init(int n, Point p[], int threads, int parallelCutoff) {
     this->n = n;
     this->p.assign(p, p + n);
+    build(threads, parallelCutoff);
+}
+
+void Delaunay::init(const PointView& points, int threads, int parallelCutoff) {
+    n = static_cast<int>(points.size());
+    p.resize(n);
+    for (int i = 0; i < n; i++) {
+        p[i] = points[i];
+        if (p[i].id < 0) p[i].id = i;
+    }
+    build(threads, parallelCutoff);
+}
+
+// 对 this->p 中的点做分治剖分
+void Delaunay::build(int threads, int parallelCutoff) {
+    GEOM_STATS_TIMER(DelaunayBuild);
     std::sort(this->p.begin(), this->p.end(), [](const Point& a, const Point& b) {
         return a.x == b.x ? a.y < b.y : a.x < b.x;
     });
-    rename.resize(n);
+    // 重合的点只有第一个参与剖分，其余移到末尾，作为没有边的孤立点保留
+    int distinct = 0;
+    std::vector<Point> duplicates;
+    for (int i = 0; i < n; i++) {
+        if (distinct > 0 && p[i].x == p[distinct - 1].x && p[i].y == p[distinct - 1].y) {
+            duplicates.push_back(p[i]);
+        } else {
+            p[distinct++] = p[i];
+        }
+    }
+    std::copy(duplicates.begin(), duplicates.end(), p.begin() + distinct);
+    firstDuplicate = distinct;
+    duplicateEnd = n;
+    int maxId = -1;
+    for (int i = 0; i < n; i++) maxId = std::max(maxId, this->p[i].id);
+    rename.assign(maxId + 1, -1);
     for (int i = 0; i < n; i++) rename[this->p[i].id] = i;
-    head.resize(n);
-    divide(0, n - 1);
+    alive.assign(n, 1);
+
+    // 三角形网格在第一次增量更新时再构建
+    tris.clear();
+    freeTris.clear();
+    vertexTri.clear();
+    triMark.clear();
+    finiteTriangles = 0;
+    hintTri = -1;
+    meshReady = false;
+
+    // 平面图的边数不超过 3n，另留 n 条边应对退化输入
+    size_t halfEdges = 8 * static_cast<size_t>(n);
+    edgeTo.assign(halfEdges, -1);
+    edgeNext.assign(halfEdges, -1);
+    edgePrev.assign(halfEdges, -1);
+    head.assign(n, -1);
+    freeEdges.head = freeEdges.tail = -1;
+    overflowEdges = nullptr;
+    if (n <= 0) return;
+
+    std::atomic<int> overflow(3 * n);
+    overflowEdges = &overflow;
+    this->parallelCutoff = std::max(parallelCutoff, 3);
+    if (threads <= 0) threads = globalThreads();
+    if (threads > 1 && distinct > this->parallelCutoff) {
+        divideParallel(0, distinct - 1, freeEdges, globalPool(), threads);
+    } else {
+        divide(0, distinct - 1, freeEdges);
+    }
+    overflowEdges = nullptr;
+
+    // 溢出区和留给重合点的编号中未使用的边也归入空闲链表
+    EdgePool rest = {-1, -1};
+    for (int k = 4 * n - 1; k >= 3 * distinct; k--) {
+        if (k >= 3 * n && k < overflow.load()) continue;
+        edgeNext[2 * k] = rest.head;
+        rest.head = k;
+        if (rest.tail == -1) rest.tail = k;
+    }
+    appendPool(freeEdges, rest);
 }
 
 std::vector<std::pair<int, int>> Delaunay::getEdge() const {
     std::vector<std::pair<int, int>> ret;
     for (int i = 0; i < n; i++) {
-        for (const auto& e : head[i]) {
+        for (int h = head[i]; h != -1; h = edgeNext[h]) {
+            int e = edgeTo[h];
             if (e < i) continue;
             ret.push_back(std::make_pair(p[i].id, p[e].id));
         }
@@ -65,88 +119,921 @@ std::vector<std::pair<int, int>> Delaunay::getEdge() const {
     return ret;
 }
 
-void Delaunay::addEdge(int u, int v) {
-    head[u].push_front(v);
-    head[v].push_front(u);
+// 把 u 的邻点按极角逆时针排序
+void Delaunay::sortAround(int u, std::vector<int>& around) const {
+    around.clear();
+    for (int h = head[u]; h != -1; h = edgeNext[h]) around.push_back(edgeTo[h]);
+    const Point& o = p[u];
+    std::sort(around.begin(), around.end(), [this, &o](int a, int b) {
+        bool ha = p[a].y > o.y || (p[a].y == o.y && p[a].x > o.x);
+        bool hb = p[b].y > o.y || (p[b].y == o.y && p[b].x > o.x);
+        if (ha != hb) return ha;
+        return cross(o, p[a], p[b]) > 0;
+    });
+}
+
+std::vector<std::array<int, 3>> Delaunay::getTriangle() const {
+    std::vector<std::array<int, 3>> ret;
+    std::vector<int> around;
+    for (int u = 0; u < n; u++) {
+        sortAround(u, around);
+        if (around.size() < 2) continue;
+
+        // 相邻两个邻点夹角小于 180 度时与 u 构成一个三角形
+        const Point& o = p[u];
+        for (size_t i = 0; i < around.size(); i++) {
+            int a = around[i], b = around[(i + 1) % around.size()];
+            // 每个三角形只在编号最小的顶点处输出一次
+            if (a < u || b < u) continue;
+            if (cross(o, p[a], p[b]) > 0) {
+                std::array<int, 3> t = {{p[u].id, p[a].id, p[b].id}};
+                ret.push_back(t);
+            }
+        }
+    }
+    return ret;
+}
+
+// 从空闲链表中取一条边，链表为空时从溢出区或数组末尾分配
+int Delaunay::allocEdge(EdgePool& pool) {
+    int k;
+    if (pool.head != -1) {
+        k = pool.head;
+        pool.head = edgeNext[2 * k];
+        if (pool.head == -1) pool.tail = -1;
+    } else if (overflowEdges != nullptr) {
+        k = (*overflowEdges)++;
+        if (2 * static_cast<size_t>(k) + 1 >= edgeTo.size()) {
+            throw std::runtime_error("Delaunay: edge storage exhausted");
+        }
+    } else {
+        k = static_cast<int>(edgeTo.size() / 2);
+        edgeTo.resize(edgeTo.size() + 2);
+        edgeNext.resize(edgeNext.size() + 2);
+        edgePrev.resize(edgePrev.size() + 2);
+    }
+    return k;
+}
+
+// 把 other 中的空闲边接到 pool 末尾
+void Delaunay::appendPool(EdgePool& pool, const EdgePool& other) {
+    if (other.head == -1) return;
+    if (pool.head == -1) {
+        pool = other;
+        return;
+    }
+    edgeNext[2 * pool.tail] = other.head;
+    pool.tail = other.tail;
+}
+
+void Delaunay::addEdge(int u, int v, EdgePool& pool) {
+    int k = allocEdge(pool);
+    int h = 2 * k, t = 2 * k + 1;
+    edgeTo[h] = v;
+    edgeTo[t] = u;
+    // 插入到链表头部
+    edgePrev[h] = -1;
+    edgeNext[h] = head[u];
+    if (head[u] != -1) edgePrev[head[u]] = h;
+    head[u] = h;
+    edgePrev[t] = -1;
+    edgeNext[t] = head[v];
+    if (head[v] != -1) edgePrev[head[v]] = t;
+    head[v] = t;
 }
 
-void Delaunay::divide(int l, int r) {
+// O(1) 删除半边 h 及其反向边
+void Delaunay::removeEdge(int h, EdgePool& pool) {
+    GEOM_STATS_ADD(DelaunayEdgeRemovals, 1);
+    int pair[2] = {h, h ^ 1};
+    for (int i = 0; i < 2; i++) {
+        int e = pair[i];
+        int from = edgeTo[e ^ 1];
+        if (edgePrev[e] != -1) edgeNext[edgePrev[e]] = edgeNext[e];
+        else head[from] = edgeNext[e];
+        if (edgeNext[e] != -1) edgePrev[edgeNext[e]] = edgePrev[e];
+    }
+    int k = h >> 1;
+    edgeNext[2 * k] = pool.head;
+    pool.head = k;
+    if (pool.tail == -1) pool.tail = k;
+}
+
+void Delaunay::divide(int l, int r, EdgePool& pool) {
     if (r - l <= 2) {  // #point <= 3
+        // 子问题 [l, r] 独占编号 [3l, 3r + 3) 的边
+        pool.head = pool.tail = -1;
+        for (int k = 3 * r + 2; k >= 3 * l; k--) {
+            edgeNext[2 * k] = pool.head;
+            pool.head = k;
+            if (pool.tail == -1) pool.tail = k;
+        }
+        // 三点共线时中间的点在两端点之间（已按坐标排序），两端点不连边
+        bool collinear = (r - l == 2 && sign(cross(p[l], p[l + 1], p[r])) == 0);
         for (int i = l; i <= r; i++)
-            for (int j = i + 1; j <= r; j++) addEdge(i, j);
+            for (int j = i + 1; j <= r; j++) {
+                if (collinear && i == l && j == r) continue;
+                addEdge(i, j, pool);
+            }
         return;
     }
     int mid = (l + r) / 2;
-    divide(l, mid);
-    divide(mid + 1, r);
+    EdgePool right;
+    divide(l, mid, pool);
+    divide(mid + 1, r, right);
+    appendPool(pool, right);
+    merge(l, r, pool);
+}
 
+// 左半部分作为任务交给线程池，右半部分在当前线程完成，两者只访问各自的顶点和边
+// threads 为这个子问题可用的线程数，左右两半各分一半，只剩一个线程时不再派生任务，同时运行的子问题不超过 threads 个
+void Delaunay::divideParallel(int l, int r, EdgePool& pool, ThreadPool& workers, int threads) {
+    if (threads <= 1 || r - l + 1 <= parallelCutoff) {
+        divide(l, r, pool);
+        return;
+    }
+    int mid = (l + r) / 2;
+    int leftThreads = threads / 2;
+    EdgePool right;
+    TaskGroup group(workers);
+    group.run([this, l, mid, &pool, &workers, leftThreads] { divideParallel(l, mid, pool, workers, leftThreads); });
+    divideParallel(mid + 1, r, right, workers, threads - leftThreads);
+    group.wait();
+    appendPool(pool, right);
+    merge(l, r, pool);
+}
+
+// 合并左右两部分 [l, mid] 与 [mid + 1, r] 的三角剖分
+void Delaunay::merge(int l, int r, EdgePool& pool) {
     // Find and update convex hull
     int nowl = l, nowr = r;
     for (int update = 1; update;) {
         update = 0;
+        GEOM_STATS_ADD(DelaunayHullWalkSteps, 1);
         Point ptL = p[nowl], ptR = p[nowr];
-        for (auto it = head[nowl].begin(); it != head[nowl].end(); it++) {
-            Point t = p[*it];
+        for (int h = head[nowl]; h != -1; h = edgeNext[h]) {
+            Point t = p[edgeTo[h]];
             double v = cross(ptR, ptL, t);
-            if (cmp(v) > 0 || (cmp(v) == 0 && ptR.dist2(t) < ptR.dist2(ptL))) {
-                nowl = *it, update = 1;
+            if (sign(v) > 0 || (sign(v) == 0 && ptR.dist2(t) < ptR.dist2(ptL))) {
+                nowl = edgeTo[h], update = 1;
                 break;
             }
         }
         if (update) continue;
-        for (auto it = head[nowr].begin(); it != head[nowr].end(); it++) {
-            Point t = p[*it];
+        for (int h = head[nowr]; h != -1; h = edgeNext[h]) {
+            Point t = p[edgeTo[h]];
             double v = cross(ptL, ptR, t);
-            if (cmp(v) < 0 || (cmp(v) == 0 && ptL.dist2(t) < ptL.dist2(ptR))) {
-                nowr = *it, update = 1;
+            if (sign(v) < 0 || (sign(v) == 0 && ptL.dist2(t) < ptL.dist2(ptR))) {
+                nowr = edgeTo[h], update = 1;
                 break;
             }
         }
     }
 
-    addEdge(nowl, nowr);  // add tangent
+    addEdge(nowl, nowr, pool);  // add tangent
 
     for (int update = 1; true;) {
         update = 0;
         Point ptL = p[nowl], ptR = p[nowr];
         int ch = -1, side = 0;
-        for (auto it = head[nowl].begin(); it != head[nowl].end(); it++) {
-            if (cmp(cross(ptL, ptR, p[*it])) > 0 &&
-                (ch == -1 || inCircle(ptL, ptR, p[ch], p[*it]) < 0)) {
-                ch = *it, side = -1;
+        for (int h = head[nowl]; h != -1; h = edgeNext[h]) {
+            int t = edgeTo[h];
+            if (sign(cross(ptL, ptR, p[t])) > 0 &&
+                (ch == -1 || inCircle(ptL, ptR, p[ch], p[t]) < 0)) {
+                ch = t, side = -1;
             }
         }
-        for (auto it = head[nowr].begin(); it != head[nowr].end(); it++) {
-            if (cmp(cross(ptR, p[*it], ptL)) > 0 &&
-                (ch == -1 || inCircle(ptL, ptR, p[ch], p[*it]) < 0)) {
-                ch = *it, side = 1;
+        for (int h = head[nowr]; h != -1; h = edgeNext[h]) {
+            int t = edgeTo[h];
+            if (sign(cross(ptR, p[t], ptL)) > 0 &&
+                (ch == -1 || inCircle(ptL, ptR, p[ch], p[t]) < 0)) {
+                ch = t, side = 1;
             }
         }
         if (ch == -1) break;  // upper common tangent
+        GEOM_STATS_ADD(DelaunayMergeSteps, 1);
         if (side == -1) {
-            for (auto it = head[nowl].begin(); it != head[nowl].end();) {
-                if (intersection(ptL, p[*it], ptR, p[ch])) {
-                    auto toErase = it++;
-                    head[*toErase].remove(nowl);
-                    head[nowl].erase(toErase);
-                } else {
-                    ++it;
-                }
+            for (int h = head[nowl]; h != -1;) {
+                int next = edgeNext[h];
+                if (intersection(ptL, p[edgeTo[h]], ptR, p[ch])) removeEdge(h, pool);
+                h = next;
             }
             nowl = ch;
-            addEdge(nowl, nowr);
+            addEdge(nowl, nowr, pool);
         } else {
-            for (auto it = head[nowr].begin(); it != head[nowr].end();) {
-                if (intersection(ptR, p[*it], ptL, p[ch])) {
-                    auto toErase = it++;
-                    head[*toErase].remove(nowr);
-                    head[nowr].erase(toErase);
-                } else {
-                    ++it;
-                }
+            for (int h = head[nowr]; h != -1;) {
+                int next = edgeNext[h];
+                if (intersection(ptR, p[edgeTo[h]], ptL, p[ch])) removeEdge(h, pool);
+                h = next;
             }
             nowr = ch;
-            addEdge(nowl, nowr);
+            addEdge(nowl, nowr, pool);
+        }
+    }
+}
+
+// 网格更新使用的 in-circle 判断，d 在逆时针三角形 abc 的外接圆内部时为正
+static double inCircleDet(const Point& a, const Point& b, const Point& c, const Point& d) {
+    return predicates::incircle(a, b, c, d);
+}
+
+// q 是否严格位于线段 ab 内部（已知三点共线），只比较坐标，结果精确
+static bool strictlyBetween(const Point& a, const Point& b, const Point& q) {
+    if (a.x != b.x) return (a.x < q.x && q.x < b.x) || (b.x < q.x && q.x < a.x);
+    return (a.y < q.y && q.y < b.y) || (b.y < q.y && q.y < a.y);
+}
+
+int Delaunay::randomInt(int bound) {
+    walkSeed = walkSeed * 1103515245u + 12345u;
+    return static_cast<int>((walkSeed >> 8) % static_cast<unsigned>(bound));
+}
+
+int Delaunay::infiniteIndex(const Triangle& t) {
+    for (int k = 0; k < 3; k++) {
+        if (t.v[k] == INF_VERTEX) return k;
+    }
+    return -1;
+}
+
+int Delaunay::newTriangle(int a, int b, int c) {
+    int t;
+    if (!freeTris.empty()) {
+        t = freeTris.back();
+        freeTris.pop_back();
+    } else {
+        t = static_cast<int>(tris.size());
+        tris.push_back(Triangle());
+        triMark.push_back(0);
+    }
+    Triangle& T = tris[t];
+    T.v[0] = a, T.v[1] = b, T.v[2] = c;
+    T.nb[0] = T.nb[1] = T.nb[2] = -1;
+    triMark[t] = 0;
+    if (a != INF_VERTEX && b != INF_VERTEX && c != INF_VERTEX) finiteTriangles++;
+    return t;
+}
+
+void Delaunay::freeTriangle(int t) {
+    if (infiniteIndex(tris[t]) == -1) finiteTriangles--;
+    tris[t].v[0] = DEAD_TRIANGLE;
+    freeTris.push_back(t);
+}
+
+// 把三角形 t 中边 {a, b} 对面的邻居改为 to
+void Delaunay::relink(int t, int a, int b, int to) {
+    if (t < 0) return;
+    Triangle& T = tris[t];
+    for (int k = 0; k < 3; k++) {
+        if (T.v[k] != a && T.v[k] != b) {
+            T.nb[k] = to;
+            return;
+        }
+    }
+}
+
+int Delaunay::findHalfEdge(int u, int v) const {
+    for (int h = head[u]; h != -1; h = edgeNext[h]) {
+        if (edgeTo[h] == v) return h;
+    }
+    return -1;
+}
+
+// 由图构建三角形网格：每个顶点的邻点按极角排序后，夹角小于 180 度的相邻邻点构成三角形，
+// 其余的间隔朝向凸包外侧，对应一个虚拟三角形。所有点共线时返回 false
+bool Delaunay::buildMesh() {
+    tris.clear();
+    freeTris.clear();
+    triMark.clear();
+    finiteTriangles = 0;
+    vertexTri.assign(n, -1);
+
+    std::vector<int> around;
+    for (int u = 0; u < n; u++) {
+        if (!alive[u]) continue;
+        sortAround(u, around);
+        if (around.size() < 2) continue;
+        for (size_t i = 0; i < around.size(); i++) {
+            int a = around[i], b = around[(i + 1) % around.size()];
+            if (cross(p[u], p[a], p[b]) > 0) {
+                if (u < a && u < b) newTriangle(u, a, b);
+            } else {
+                newTriangle(b, u, INF_VERTEX);
+            }
+        }
+    }
+    if (finiteTriangles == 0) {
+        tris.clear();
+        triMark.clear();
+        return false;
+    }
+
+    // 按有向边配对相邻三角形：三角形中的边 a -> b 与邻居中的边 b -> a 对应
+    struct HalfEdge {
+        int from, to, tri, k;
+        bool operator<(const HalfEdge& o) const { return from != o.from ? from < o.from : to < o.to; }
+    };
+    std::vector<HalfEdge> halfEdges;
+    halfEdges.reserve(tris.size() * 3);
+    for (int t = 0; t < static_cast<int>(tris.size()); t++) {
+        for (int k = 0; k < 3; k++) {
+            HalfEdge e = {tris[t].v[(k + 1) % 3], tris[t].v[(k + 2) % 3], t, k};
+            halfEdges.push_back(e);
+        }
+    }
+    std::sort(halfEdges.begin(), halfEdges.end());
+    for (size_t i = 0; i < halfEdges.size(); i++) {
+        HalfEdge key = {halfEdges[i].to, halfEdges[i].from, 0, 0};
+        std::vector<HalfEdge>::iterator it = std::lower_bound(halfEdges.begin(), halfEdges.end(), key);
+        if (it == halfEdges.end() || it->from != key.from || it->to != key.to) {
+            throw std::runtime_error("Delaunay: graph is not a valid triangulation");
+        }
+        tris[halfEdges[i].tri].nb[halfEdges[i].k] = it->tri;
+    }
+
+    for (int t = 0; t < static_cast<int>(tris.size()); t++) {
+        for (int k = 0; k < 3; k++) {
+            if (tris[t].v[k] != INF_VERTEX) vertexTri[tris[t].v[k]] = t;
+        }
+    }
+    hintTri = 0;
+    meshReady = true;
+    return true;
+}
+
+// 网格退化（点数不足或全部共线）时用分治算法整体重建
+void Delaunay::rebuild() {
+    std::vector<Point> pts;
+    for (int i = 0; i < n; i++) {
+        if (alive[i]) pts.push_back(p[i]);
+    }
+    init(static_cast<int>(pts.size()), pts.data());
+}
+
+// 追加一个顶点，返回其下标
+int Delaunay::addVertex(const Point& point) {
+    Point v = point;
+    if (v.id < 0) v.id = static_cast<int>(rename.size());
+    if (v.id < static_cast<int>(rename.size()) && rename[v.id] != -1) {
+        throw std::runtime_error("Delaunay: point id already in use");
+    }
+    if (v.id >= static_cast<int>(rename.size())) rename.resize(v.id + 1, -1);
+    int index = n++;
+    rename[v.id] = index;
+    p.push_back(v);
+    head.push_back(-1);
+    alive.push_back(1);
+    if (meshReady) vertexTri.push_back(-1);
+    return index;
+}
+
+// t 的外接圆是否严格包含 q；虚拟三角形在 q 位于其有限边外侧或落在该边内部时冲突
+bool Delaunay::inConflict(int t, const Point& q) const {
+    const Triangle& T = tris[t];
+    int k = infiniteIndex(T);
+    if (k == -1) return inCircleDet(p[T.v[0]], p[T.v[1]], p[T.v[2]], q) > 0;
+    const Point& a = p[T.v[(k + 1) % 3]];
+    const Point& b = p[T.v[(k + 2) % 3]];
+    double o = cross(a, b, q);
+    if (o != 0) return o > 0;
+    return strictlyBetween(a, b, q);
+}
+
+// 跳跃-游走定位：从随机抽样的顶点与上次更新位置中离 q 最近的一个出发，沿三角形随机游走
+// 返回包含 q 的有限三角形，q 在凸包外时返回可见的虚拟三角形
+int Delaunay::locate(const Point& q) {
+    int start = -1;
+    double best = 0;
+    if (hintTri >= 0 && tris[hintTri].v[0] != DEAD_TRIANGLE) {
+        const Triangle& H = tris[hintTri];
+        start = H.v[0] != INF_VERTEX ? H.v[0] : H.v[1];
+        best = p[start].dist2(q);
+    }
+    int samples = static_cast<int>(std::cbrt(static_cast<double>(n))) + 1;
+    for (int s = 0; s < samples; s++) {
+        int v = randomInt(n);
+        if (!alive[v] || vertexTri[v] < 0) continue;
+        double d = p[v].dist2(q);
+        if (start == -1 || d < best) start = v, best = d;
+    }
+
+    int t = vertexTri[start];
+    int k = infiniteIndex(tris[t]);
+    if (k != -1) t = tris[t].nb[k];
+
+    for (size_t steps = 0; steps <= tris.size(); steps++) {
+        const Triangle& T = tris[t];
+        int r = randomInt(3), next = -1;
+        for (int j = 0; j < 3 && next == -1; j++) {
+            int i = (r + j) % 3;
+            if (cross(p[T.v[(i + 1) % 3]], p[T.v[(i + 2) % 3]], q) < 0) next = T.nb[i];
         }
+        if (next == -1) return t;
+        t = next;
+        if (infiniteIndex(tris[t]) != -1) return t;
+    }
+
+    // 数值误差导致游走不收敛时逐个检查
+    for (int c = 0; c < static_cast<int>(tris.size()); c++) {
+        const Triangle& T = tris[c];
+        if (T.v[0] == DEAD_TRIANGLE) continue;
+        if (infiniteIndex(T) != -1) {
+            if (inConflict(c, q)) return c;
+            continue;
+        }
+        bool inside = true;
+        for (int i = 0; i < 3; i++) {
+            if (cross(p[T.v[(i + 1) % 3]], p[T.v[(i + 2) % 3]], q) < 0) inside = false;
+        }
+        if (inside) return c;
+    }
+    return t;
+}
+
+// Bowyer-Watson 插入：删除外接圆包含新点的所有三角形，再把空腔边界与新点相连
+int Delaunay::insert(const Point& point) {
+    if (!meshReady && !buildMesh()) {
+        for (int i = 0; i < n; i++) {
+            if (alive[i] && p[i].x == point.x && p[i].y == point.y) return p[i].id;
+        }
+        int v = addVertex(point);
+        int id = p[v].id;
+        rebuild();
+        return id;
+    }
+
+    int t = locate(point);
+    for (int k = 0; k < 3; k++) {
+        int v = tris[t].v[k];
+        if (v != INF_VERTEX && p[v].x == point.x && p[v].y == point.y) return p[v].id;
+    }
+    int q = addVertex(point);
+
+    // 从所在三角形出发搜索冲突区域，新点落在某条边内部时该边两侧都属于空腔
+    std::vector<int> cavity, stack(1, t);
+    std::vector<std::array<int, 3>> boundary;  // 空腔边界 a -> b 及其外侧的三角形
+    markStamp++;
+    triMark[t] = markStamp;
+    while (!stack.empty()) {
+        int c = stack.back();
+        stack.pop_back();
+        cavity.push_back(c);
+        for (int i = 0; i < 3; i++) {
+            const Triangle& C = tris[c];
+            int o = C.nb[i], a = C.v[(i + 1) % 3], b = C.v[(i + 2) % 3];
+            if (triMark[o] == markStamp) continue;
+            bool onEdge = a != INF_VERTEX && b != INF_VERTEX &&
+                          cross(p[a], p[b], point) == 0 && strictlyBetween(p[a], p[b], point);
+            if (onEdge || inConflict(o, point)) {
+                triMark[o] = markStamp;
+                stack.push_back(o);
+            } else {
+                std::array<int, 3> e = {{a, b, o}};
+                boundary.push_back(e);
+            }
+        }
+    }
+
+    // 空腔内部的边从图中删除
+    for (size_t i = 0; i < cavity.size(); i++) {
+        const Triangle& C = tris[cavity[i]];
+        for (int k = 0; k < 3; k++) {
+            int a = C.v[(k + 1) % 3], b = C.v[(k + 2) % 3];
+            if (C.nb[k] < cavity[i] || triMark[C.nb[k]] != markStamp) continue;
+            if (a == INF_VERTEX || b == INF_VERTEX) continue;
+            int h = findHalfEdge(a, b);
+            if (h != -1) removeEdge(h, freeEdges);
+        }
+    }
+    for (size_t i = 0; i < cavity.size(); i++) freeTriangle(cavity[i]);
+
+    // 新三角形 (a, b, q)，相邻新三角形通过公共顶点连接
+    if (startTri.size() < static_cast<size_t>(n) + 1) startTri.resize(n + 1, -1);
+    std::vector<int> created;
+    for (size_t i = 0; i < boundary.size(); i++) {
+        int a = boundary[i][0], b = boundary[i][1], o = boundary[i][2];
+        int nt = newTriangle(a, b, q);
+        tris[nt].nb[2] = o;
+        relink(o, a, b, nt);
+        startTri[a + 1] = nt;
+        created.push_back(nt);
+        if (a != INF_VERTEX) addEdge(q, a, freeEdges);
+    }
+    for (size_t i = 0; i < created.size(); i++) {
+        int nt = created[i];
+        int m = startTri[tris[nt].v[1] + 1];
+        tris[nt].nb[0] = m;
+        tris[m].nb[1] = nt;
+        for (int k = 0; k < 3; k++) {
+            if (tris[nt].v[k] != INF_VERTEX) vertexTri[tris[nt].v[k]] = nt;
+        }
+    }
+    hintTri = created.front();
+    return p[q].id;
+}
+
+// 耳朵 (ring[i - 1], ring[i], ring[i + 1]) 能否割下：
+// 有限三角形需为逆时针且外接圆内不含环上其他点，虚拟三角形需环上其他点都不在其有限边外侧
+bool Delaunay::earIsValid(const std::vector<int>& ring, size_t i) const {
+    size_t m = ring.size();
+    int tri[3] = {ring[(i + m - 1) % m], ring[i], ring[(i + 1) % m]};
+    int k = -1;
+    for (int j = 0; j < 3; j++) {
+        if (tri[j] == INF_VERTEX) k = j;
+    }
+
+    if (k == -1) {
+        const Point &a = p[tri[0]], &b = p[tri[1]], &c = p[tri[2]];
+        if (!(cross(a, b, c) > 0)) return false;
+        for (size_t j = 0; j < m; j++) {
+            int w = ring[j];
+            if (w == INF_VERTEX || w == tri[0] || w == tri[1] || w == tri[2]) continue;
+            if (inCircleDet(a, b, c, p[w]) > 0) return false;
+        }
+        return true;
+    }
+
+    const Point& a = p[tri[(k + 1) % 3]];
+    const Point& b = p[tri[(k + 2) % 3]];
+    for (size_t j = 0; j < m; j++) {
+        int w = ring[j];
+        if (w == INF_VERTEX || w == tri[(k + 1) % 3] || w == tri[(k + 2) % 3]) continue;
+        double o = cross(a, b, p[w]);
+        if (o > 0 || (o == 0 && strictlyBetween(a, b, p[w]))) return false;
+    }
+    return true;
+}
+
+// 删除顶点：取出它周围的一圈邻点，按 Delaunay 条件逐个割耳重新三角化
+bool Delaunay::remove(int id) {
+    if (id < 0 || id >= static_cast<int>(rename.size()) || rename[id] < 0) return false;
+    int v = rename[id];
+    // 有重合的孤立点时由它接替被删除的点，剖分不变
+    for (int w = firstDuplicate; w < duplicateEnd && head[v] != -1; w++) {
+        if (alive[w] && p[w].x == p[v].x && p[w].y == p[v].y) {
+            p[v].id = p[w].id;
+            rename[p[v].id] = v;
+            alive[w] = 0;
+            rename[id] = -1;
+            return true;
+        }
+    }
+    if (!meshReady && !buildMesh()) {
+        alive[v] = 0;
+        rename[id] = -1;
+        rebuild();
+        return true;
+    }
+
+    // 与其他点重合的孤立点不在任何三角形中，直接删除
+    if (vertexTri[v] < 0) {
+        alive[v] = 0;
+        rename[id] = -1;
+        return true;
+    }
+
+    // 逆时针收集星形区域：三角形 (v, ring[j], ring[j + 1]) 的外侧邻居为 outer[j]
+    std::vector<int> star, ring, outer;
+    int t0 = vertexTri[v], t = t0;
+    do {
+        const Triangle& T = tris[t];
+        int i = 0;
+        while (T.v[i] != v) i++;
+        star.push_back(t);
+        ring.push_back(T.v[(i + 1) % 3]);
+        outer.push_back(T.nb[i]);
+        t = T.nb[(i + 1) % 3];
+    } while (t != t0);
+
+    // 先确定割耳顺序，失败时网格保持不变并整体重建
+    std::vector<int> order;
+    std::vector<int> rest(ring);
+    while (rest.size() > 3) {
+        size_t i = 0;
+        while (i < rest.size() && !earIsValid(rest, i)) i++;
+        if (i == rest.size()) break;
+        order.push_back(rest[i]);
+        rest.erase(rest.begin() + i);
+    }
+    bool ok = rest.size() == 3;
+    if (ok && rest[0] != INF_VERTEX && rest[1] != INF_VERTEX && rest[2] != INF_VERTEX) {
+        ok = cross(p[rest[0]], p[rest[1]], p[rest[2]]) > 0;
+    }
+    if (!ok) {
+        alive[v] = 0;
+        rename[id] = -1;
+        rebuild();
+        return true;
+    }
+
+    for (int h = head[v]; h != -1;) {
+        int next = edgeNext[h];
+        removeEdge(h, freeEdges);
+        h = next;
+    }
+    for (size_t i = 0; i < star.size(); i++) freeTriangle(star[i]);
+    alive[v] = 0;
+    rename[id] = -1;
+    vertexTri[v] = -1;
+
+    // 按顺序割耳，新三角形 (x, y, z) 与环上两条边外侧的三角形相连，新边 x -> z 的外侧记为该三角形
+    std::vector<int> created;
+    for (size_t e = 0; e <= order.size(); e++) {
+        size_t m = ring.size(), i = 1;
+        if (e < order.size()) {
+            while (ring[i % m] != order[e]) i++;
+            i %= m;
+        }
+        int x = ring[(i + m - 1) % m], y = ring[i], z = ring[(i + 1) % m];
+        int nt = newTriangle(x, y, z);
+        int outXY = outer[(i + m - 1) % m], outYZ = outer[i];
+        tris[nt].nb[2] = outXY;
+        relink(outXY, x, y, nt);
+        tris[nt].nb[0] = outYZ;
+        relink(outYZ, y, z, nt);
+        created.push_back(nt);
+        if (e == order.size()) {
+            int outZX = outer[(i + 1) % m];
+            tris[nt].nb[1] = outZX;
+            relink(outZX, z, x, nt);
+            break;
+        }
+        if (x != INF_VERTEX && z != INF_VERTEX) addEdge(x, z, freeEdges);
+        outer[(i + m - 1) % m] = nt;
+        ring.erase(ring.begin() + i);
+        outer.erase(outer.begin() + i);
+    }
+    for (size_t i = 0; i < created.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+            int w = tris[created[i]].v[k];
+            if (w != INF_VERTEX) vertexTri[w] = created[i];
+        }
+    }
+    hintTri = created.front();
+
+    // 剩余的点全部共线时网格退化
+    if (finiteTriangles == 0) rebuild();
+    return true;
+}
+
+// 最近点查询的起点：抽样约 n^(1/3) 个顶点，取离 q 最近的一个
+// 只选有邻边的顶点，与其他点重合而被孤立的顶点无法沿图移动；所有点都没有边时（只有一个不同的位置）返回任一存活的点
+int Delaunay::startVertex(const Point& q) const {
+    int samples = static_cast<int>(std::cbrt(static_cast<double>(n))) + 1;
+    int step = std::max(1, n / samples);
+    int start = -1;
+    double best = 0;
+    for (int v = 0; v < n; v += step) {
+        if (!alive[v] || head[v] == -1) continue;
+        double d = p[v].dist2(q);
+        if (start == -1 || d < best) start = v, best = d;
+    }
+    if (start != -1) return start;
+    int isolated = -1;
+    for (int v = 0; v < n; v++) {
+        if (!alive[v]) continue;
+        if (head[v] != -1) return v;
+        if (isolated == -1) isolated = v;
+    }
+    return isolated;
+}
+
+// 贪心移动到离 q 更近的邻点，直到没有更近的邻点
+// Delaunay 图中不是最近点的顶点总有一个比它更近的邻点，因此停下的点就是最近点
+int Delaunay::walkToNearest(int v, const Point& q) const {
+    double best = p[v].dist2(q);
+    for (;;) {
+        int next = -1;
+        for (int h = head[v]; h != -1; h = edgeNext[h]) {
+            double d = p[edgeTo[h]].dist2(q);
+            if (d < best) best = d, next = edgeTo[h];
+        }
+        if (next == -1) return v;
+        v = next;
+    }
+}
+
+// hint 与抽样的顶点中取离 q 较近的一个出发，hint 离得很远时也不会退化为长距离游走
+int Delaunay::nearest(const Point& q, int hint) const {
+    int v = startVertex(q);
+    if (v == -1) return -1;
+    if (hint >= 0 && hint < static_cast<int>(rename.size()) && rename[hint] >= 0 && head[rename[hint]] != -1 &&
+        p[rename[hint]].dist2(q) < p[v].dist2(q)) {
+        v = rename[hint];
+    }
+    return p[walkToNearest(v, q)].id;
+}
+
+// 点在 2^16 x 2^16 网格上的 Hilbert 曲线序号
+static uint32_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t side = 1u << 16;
+    uint32_t d = 0;
+    for (uint32_t s = side / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+void Delaunay::nearest(const PointView& queries, int* ids, int threads) const {
+    size_t m = queries.size();
+    if (m == 0) return;
+    if (startVertex(queries[0]) == -1) {
+        std::fill(ids, ids + m, -1);
+        return;
+    }
+
+    // 按 Hilbert 序号排序，相邻的查询在空间上也相邻，从上一个结果出发只需移动很少几步
+    double minX = queries.x(0), maxX = minX, minY = queries.y(0), maxY = minY;
+    for (size_t i = 1; i < m; i++) {
+        minX = std::min(minX, queries.x(i));
+        maxX = std::max(maxX, queries.x(i));
+        minY = std::min(minY, queries.y(i));
+        maxY = std::max(maxY, queries.y(i));
+    }
+    double scaleX = maxX > minX ? 65535.0 / (maxX - minX) : 0.0;
+    double scaleY = maxY > minY ? 65535.0 / (maxY - minY) : 0.0;
+    if (!std::isfinite(scaleX)) scaleX = 0.0;
+    if (!std::isfinite(scaleY)) scaleY = 0.0;
+    std::vector<uint64_t> order(m);
+    for (size_t i = 0; i < m; i++) {
+        // 坐标为 NaN 时格点取 0
+        double gx = (queries.x(i) - minX) * scaleX, gy = (queries.y(i) - minY) * scaleY;
+        uint32_t cx = gx >= 0 && gx <= 65535.0 ? static_cast<uint32_t>(gx) : 0;
+        uint32_t cy = gy >= 0 && gy <= 65535.0 ? static_cast<uint32_t>(gy) : 0;
+        order[i] = static_cast<uint64_t>(hilbertIndex(cx, cy)) << 32 | i;
+    }
+    std::sort(order.begin(), order.end());
+
+    if (threads <= 0) threads = globalThreads();
+    const size_t minChunk = 1024;
+    size_t chunks = threads == 1 ? 1 : std::max<size_t>(1, std::min(m / minChunk, static_cast<size_t>(threads) * 4));
+    auto work = [this, m, chunks, &queries, &order, ids](size_t c) {
+        int v = -1;
+        for (size_t k = m * c / chunks; k < m * (c + 1) / chunks; k++) {
+            size_t i = static_cast<size_t>(order[k] & 0xffffffffu);
+            Point q = queries[i];
+            if (v == -1) v = startVertex(q);
+            v = walkToNearest(v, q);
+            ids[i] = p[v].id;
+        }
+    };
+    parallelFor(chunks, 1, [&work](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) work(c);
+    }, threads);
+}
+
+static Point circumcenter(const Point& a, const Point& b, const Point& c) {
+    double bx = b.x - a.x, by = b.y - a.y;
+    double cx = c.x - a.x, cy = c.y - a.y;
+    double d = 2 * (bx * cy - by * cx);
+    double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+    return Point(a.x + (cy * b2 - by * c2) / d, a.y + (bx * c2 - cx * b2) / d);
+}
+
+// 保留凸多边形中满足 ((x, y) - (px, py)) . (nx, ny) <= 0 的部分（Sutherland-Hodgman）
+static void clipHalfPlane(std::vector<Point>& polygon, double px, double py, double nx, double ny) {
+    std::vector<Point> result;
+    size_t m = polygon.size();
+    for (size_t i = 0; i < m; i++) {
+        const Point& a = polygon[i];
+        const Point& b = polygon[(i + 1) % m];
+        double da = (a.x - px) * nx + (a.y - py) * ny;
+        double db = (b.x - px) * nx + (b.y - py) * ny;
+        if (da <= 0) result.push_back(a);
+        if ((da < 0 && db > 0) || (da > 0 && db < 0)) {
+            double t = da / (da - db);
+            result.push_back(Point(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t));
+        }
+    }
+    polygon.swap(result);
+}
+
+// 顶点 u 的 Voronoi 单元，around 为按极角逆时针排好的邻点
+// 相邻两个邻点与 u 构成三角形时，单元顶点为其外接圆圆心；两个邻点之间的夹角不小于 180 度时单元在这一侧无界，
+// 用两条中垂线上足够远的点和远处的一段折线封闭，再裁剪到矩形
+void Delaunay::voronoiCell(int u, const std::vector<int>& around, double minX, double minY, double maxX, double maxY,
+                           std::vector<double>& x, std::vector<double>& y) const {
+    const Point& o = p[u];
+    std::vector<Point> cell;
+    size_t m = around.size();
+    if (m == 0) {
+        cell.push_back(Point(minX, minY));
+        cell.push_back(Point(maxX, minY));
+        cell.push_back(Point(maxX, maxY));
+        cell.push_back(Point(minX, maxY));
+    } else {
+        // 远处的点要在矩形和所有有限顶点之外
+        double reach = 0;
+        double cornersX[2] = {minX, maxX}, cornersY[2] = {minY, maxY};
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++) reach = std::max(reach, std::sqrt(o.dist2(Point(cornersX[i], cornersY[j]))));
+        std::vector<Point> centers(m);
+        std::vector<char> finite(m);
+        for (size_t i = 0; i < m; i++) {
+            int a = around[i], b = around[(i + 1) % m];
+            reach = std::max(reach, std::sqrt(o.dist2(p[a])));
+            finite[i] = m > 1 && cross(o, p[a], p[b]) > 0;
+            if (finite[i]) {
+                centers[i] = circumcenter(o, p[a], p[b]);
+                reach = std::max(reach, std::sqrt(o.dist2(centers[i])));
+            }
+        }
+        double far = 4 * reach + 1;
+
+        // 内部的点的单元通常是有界的并且在矩形内，不需要裁剪
+        bool inside = true;
+        for (size_t i = 0; i < m && inside; i++) {
+            inside = finite[i] && centers[i].x >= minX && centers[i].x <= maxX &&
+                     centers[i].y >= minY && centers[i].y <= maxY;
+        }
+        for (size_t i = 0; i < m && inside; i++) {
+            x.push_back(centers[i].x);
+            y.push_back(centers[i].y);
+        }
+        if (inside) return;
+
+        for (size_t i = 0; i < m; i++) {
+            if (finite[i]) {
+                cell.push_back(centers[i]);
+                continue;
+            }
+            // 从 a 一侧中垂线的方向（o -> a 逆时针旋转 90 度）逆时针转到 b 一侧中垂线的方向（o -> b 顺时针旋转 90 度），
+            // 转过的角度为 a、b 之间的夹角减去 180 度；只有一个邻点时夹角按 360 度计
+            const double pi = std::acos(-1.0);
+            const Point& a = p[around[i]];
+            const Point& b = p[around[(i + 1) % m]];
+            double ax = a.x - o.x, ay = a.y - o.y, bx = b.x - o.x, by = b.y - o.y;
+            double la = std::sqrt(ax * ax + ay * ay), lb = std::sqrt(bx * bx + by * by);
+            double gap = m == 1 ? 2 * pi : std::atan2(ax * by - ay * bx, ax * bx + ay * by);
+            if (gap <= 0) gap += 2 * pi;
+            double from = std::atan2(ax, -ay), sweep = std::max(gap - pi, 0.0);
+            cell.push_back(Point(o.x + ax / 2 - ay / la * far, o.y + ay / 2 + ax / la * far));
+            int steps = static_cast<int>(std::ceil(sweep / (pi / 3)));
+            for (int s = 1; s < steps; s++) {
+                double angle = from + sweep * s / steps;
+                cell.push_back(Point(o.x + 2 * far * std::cos(angle), o.y + 2 * far * std::sin(angle)));
+            }
+            cell.push_back(Point(o.x + bx / 2 + by / lb * far, o.y + by / 2 - bx / lb * far));
+        }
+        clipHalfPlane(cell, minX, 0, -1, 0);
+        clipHalfPlane(cell, maxX, 0, 1, 0);
+        clipHalfPlane(cell, 0, minY, 0, -1);
+        clipHalfPlane(cell, 0, maxY, 0, 1);
+    }
+    for (size_t i = 0; i < cell.size(); i++) {
+        x.push_back(cell[i].x);
+        y.push_back(cell[i].y);
+    }
+}
+
+void Delaunay::getVoronoi(Voronoi& out, double minX, double minY, double maxX, double maxY) const {
+    out.centerX.clear();
+    out.centerY.clear();
+    out.site.clear();
+    out.offsets.assign(1, 0);
+    out.x.clear();
+    out.y.clear();
+
+    std::vector<int> around;
+    int sites = 0;
+    for (int u = 0; u < n; u++) sites += alive[u];
+    for (int u = 0; u < n; u++) {
+        if (!alive[u]) continue;
+        sortAround(u, around);
+        // 外接圆圆心与 getTriangle 的顺序相同：每个三角形在编号最小的顶点处输出
+        for (size_t i = 0; around.size() >= 2 && i < around.size(); i++) {
+            int a = around[i], b = around[(i + 1) % around.size()];
+            if (a < u || b < u || cross(p[u], p[a], p[b]) <= 0) continue;
+            Point c = circumcenter(p[u], p[a], p[b]);
+            out.centerX.push_back(c.x);
+            out.centerY.push_back(c.y);
+        }
+        // 与其他点重合的孤立点没有单元，只有一个点时单元为整个矩形
+        out.site.push_back(p[u].id);
+        if (!around.empty() || sites == 1) voronoiCell(u, around, minX, minY, maxX, maxY, out.x, out.y);
+        out.offsets.push_back(out.x.size());
+    }
+}
+
+void Delaunay::getVoronoi(Voronoi& out) const {
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool first = true;
+    for (int u = 0; u < n; u++) {
+        if (!alive[u]) continue;
+        if (first || p[u].x < minX) minX = p[u].x;
+        if (first || p[u].x > maxX) maxX = p[u].x;
+        if (first || p[u].y < minY) minY = p[u].y;
+        if (first || p[u].y > maxY) maxY = p[u].y;
+        first = false;
     }
+    double w = maxX - minX, h = maxY - minY;
+    double margin = std::max(std::max(w, h), 1.0);
+    getVoronoi(out, minX - margin, minY - margin, maxX + margin, maxY + margin);
 }
@@ -1,12 +1,135 @@
 #include "findIntersection.h"
+#include "predicates.h"
+#include "simd.h"
+#include "ThreadPool.h"
+#include <limits>
 
 // 求两条直线的交点，输入直线方程的系数
 Point findIntersection(double A1, double B1, double C1, double A2, double B2, double C2) {
-    double determinant = A1 * B2 - A2 * B1;
-    if (std::fabs(determinant) < 1e-9) {
+    Point p;
+    if (intersectLines(A1, B1, C1, A2, B2, C2, p) != UniqueIntersection) {
         throw std::runtime_error("The lines are parallel or coincident, no unique intersection point.");
     }
-    double x = (B2 * C1 - B1 * C2) / determinant;
-    double y = (A1 * C2 - A2 * C1) / determinant;
-    return {x, y};
-}
\ No newline at end of file
+    return p;
+}
+
+// 克莱姆法则：x、y 的分子与行列式共用同一组系数
+// 三个 2x2 行列式都是 orient2d 以原点为第三个点的特例，由它精确判断是否为 0
+// 平行时两个分子也都为 0 说明两个方程成比例，即两条直线重合
+LineRelation intersectLines(double A1, double B1, double C1, double A2, double B2, double C2, Point& p) {
+    double determinant = predicates::orient2d(A1, A2, B1, B2, 0, 0);
+    if (determinant == 0) {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        p.x = p.y = nan;
+        if (predicates::orient2d(B2, B1, C2, C1, 0, 0) == 0 && predicates::orient2d(A1, A2, C1, C2, 0, 0) == 0) {
+            return CoincidentLines;
+        }
+        return ParallelLines;
+    }
+    p.x = (B2 * C1 - B1 * C2) / determinant;
+    p.y = (A1 * C2 - A2 * C1) / determinant;
+    return UniqueIntersection;
+}
+
+static void intersectScalar(const double* A1, const double* B1, const double* C1,
+                            const double* A2, const double* B2, const double* C2,
+                            size_t first, size_t last, double* x, double* y, uint8_t* status) {
+    for (size_t i = first; i < last; ++i) {
+        Point p;
+        status[i] = static_cast<uint8_t>(intersectLines(A1[i], B1[i], C1[i], A2[i], B2[i], C2[i], p));
+        x[i] = p.x;
+        y[i] = p.y;
+    }
+}
+
+#ifdef SIMD_X86
+// 向量内核与 orient2d 的快速路径做同样的运算：|行列式| 大于误差界的通道一定交于一点，直接相除
+// 其余通道（mask 中置位，可能平行）交给 intersectLines 处理，这种情况很少出现
+static void recheckLanes(const double* A1, const double* B1, const double* C1,
+                         const double* A2, const double* B2, const double* C2,
+                         size_t first, int mask, double* x, double* y, uint8_t* status) {
+    for (; mask != 0; mask &= mask - 1) {
+        size_t i = first + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        intersectScalar(A1, B1, C1, A2, B2, C2, i, i + 1, x, y, status);
+    }
+}
+
+// SSE2 内核，每次处理 2 对直线
+__attribute__((target("sse2")))
+static void intersectSSE2(const double* A1, const double* B1, const double* C1,
+                          const double* A2, const double* B2, const double* C2,
+                          size_t n, double* x, double* y, uint8_t* status) {
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d errorBound = _mm_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d a1 = _mm_loadu_pd(A1 + i), b1 = _mm_loadu_pd(B1 + i), c1 = _mm_loadu_pd(C1 + i);
+        __m128d a2 = _mm_loadu_pd(A2 + i), b2 = _mm_loadu_pd(B2 + i), c2 = _mm_loadu_pd(C2 + i);
+        __m128d left = _mm_mul_pd(a1, b2), right = _mm_mul_pd(a2, b1);
+        __m128d det = _mm_sub_pd(left, right);
+        __m128d bound = _mm_mul_pd(errorBound, _mm_add_pd(_mm_and_pd(left, absMask), _mm_and_pd(right, absMask)));
+        __m128d nx = _mm_sub_pd(_mm_mul_pd(b2, c1), _mm_mul_pd(b1, c2));
+        __m128d ny = _mm_sub_pd(_mm_mul_pd(a1, c2), _mm_mul_pd(a2, c1));
+        _mm_storeu_pd(x + i, _mm_div_pd(nx, det));
+        _mm_storeu_pd(y + i, _mm_div_pd(ny, det));
+        status[i] = status[i + 1] = UniqueIntersection;
+        int uncertain = _mm_movemask_pd(_mm_cmple_pd(_mm_and_pd(det, absMask), bound));
+        if (uncertain != 0) recheckLanes(A1, B1, C1, A2, B2, C2, i, uncertain, x, y, status);
+    }
+    intersectScalar(A1, B1, C1, A2, B2, C2, i, n, x, y, status);
+}
+
+// AVX2 内核，每次处理 4 对直线
+__attribute__((target("avx2")))
+static void intersectAVX2(const double* A1, const double* B1, const double* C1,
+                          const double* A2, const double* B2, const double* C2,
+                          size_t n, double* x, double* y, uint8_t* status) {
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d errorBound = _mm256_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d a1 = _mm256_loadu_pd(A1 + i), b1 = _mm256_loadu_pd(B1 + i), c1 = _mm256_loadu_pd(C1 + i);
+        __m256d a2 = _mm256_loadu_pd(A2 + i), b2 = _mm256_loadu_pd(B2 + i), c2 = _mm256_loadu_pd(C2 + i);
+        __m256d left = _mm256_mul_pd(a1, b2), right = _mm256_mul_pd(a2, b1);
+        __m256d det = _mm256_sub_pd(left, right);
+        __m256d bound = _mm256_mul_pd(errorBound,
+                                      _mm256_add_pd(_mm256_and_pd(left, absMask), _mm256_and_pd(right, absMask)));
+        __m256d nx = _mm256_sub_pd(_mm256_mul_pd(b2, c1), _mm256_mul_pd(b1, c2));
+        __m256d ny = _mm256_sub_pd(_mm256_mul_pd(a1, c2), _mm256_mul_pd(a2, c1));
+        _mm256_storeu_pd(x + i, _mm256_div_pd(nx, det));
+        _mm256_storeu_pd(y + i, _mm256_div_pd(ny, det));
+        for (int k = 0; k < 4; ++k) status[i + k] = UniqueIntersection;
+        int uncertain = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_and_pd(det, absMask), bound, _CMP_LE_OQ));
+        if (uncertain != 0) recheckLanes(A1, B1, C1, A2, B2, C2, i, uncertain, x, y, status);
+    }
+    intersectScalar(A1, B1, C1, A2, B2, C2, i, n, x, y, status);
+}
+#endif
+
+// 处理下标 [begin, end) 的直线对
+static void intersectRange(const double* A1, const double* B1, const double* C1,
+                           const double* A2, const double* B2, const double* C2,
+                           size_t begin, size_t end, double* x, double* y, uint8_t* status) {
+#ifdef SIMD_X86
+    simd::Level level = simd::activeLevel();
+    if (level == simd::AVX2) {
+        intersectAVX2(A1 + begin, B1 + begin, C1 + begin, A2 + begin, B2 + begin, C2 + begin, end - begin,
+                      x + begin, y + begin, status + begin);
+        return;
+    }
+    if (level == simd::SSE2) {
+        intersectSSE2(A1 + begin, B1 + begin, C1 + begin, A2 + begin, B2 + begin, C2 + begin, end - begin,
+                      x + begin, y + begin, status + begin);
+        return;
+    }
+#endif
+    intersectScalar(A1, B1, C1, A2, B2, C2, begin, end, x, y, status);
+}
+
+void findIntersections(const double* A1, const double* B1, const double* C1,
+                       const double* A2, const double* B2, const double* C2,
+                       size_t n, double* x, double* y, uint8_t* status, int threads) {
+    parallelFor(n, 1 << 14, [=](size_t begin, size_t end) {
+        intersectRange(A1, B1, C1, A2, B2, C2, begin, end, x, y, status);
+    }, threads);
+}
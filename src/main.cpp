@@ -140,6 +140,55 @@ int main() {
 
 
 
+//凸包引擎与 grahamScan 性能对比
+
+// #include <chrono>
+// #include <iostream>
+// #include <random>
+// #include "convex_hull.h"
+
+// static double elapsedMs(std::chrono::steady_clock::time_point start) {
+//     return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+// }
+
+// int main() {
+//     std::mt19937 rng(2024);
+//     std::uniform_real_distribution<double> coord(-1000.0, 1000.0);
+
+//     for (int n = 1000; n <= 1000000; n *= 10) {
+//         std::vector<Point> points(n);
+//         for (auto& p : points) p = Point(coord(rng), coord(rng));
+
+//         // grahamScan 会输出大量调试信息，计时时关闭 std::cout
+//         std::vector<Point> copy = points;
+//         auto start = std::chrono::steady_clock::now();
+//         std::cout.setstate(std::ios::failbit);
+//         std::vector<Point> graham = ConvexHull::grahamScan(copy);
+//         std::cout.clear();
+//         double grahamMs = elapsedMs(start);
+
+//         start = std::chrono::steady_clock::now();
+//         std::vector<Point> hull = ConvexHull::compute(points);
+//         double computeMs = elapsedMs(start);
+
+//         ConvexHull::Options options;
+//         options.outputSensitive = true;
+//         start = std::chrono::steady_clock::now();
+//         ConvexHull::compute(points, options);
+//         double outputSensitiveMs = elapsedMs(start);
+
+//         std::cout << "n = " << n << ", hull size = " << hull.size() << " (graham " << graham.size() << ")\n"
+//                   << "  grahamScan:       " << grahamMs << " ms\n"
+//                   << "  compute:          " << computeMs << " ms\n"
+//                   << "  output sensitive: " << outputSensitiveMs << " ms\n";
+//     }
+
+//     return 0;
+// }
+
+
+
+
 //判断点在线段的哪个位置
 
 // #include "point_line.h"
@@ -151,6 +200,13 @@ int main() {
 
 //     std::cout << determinePosition(P, Q, v) << std::endl;
 
+//     // 批量判断：按列存放的坐标，输出 -1/0/1
+//     double xs[] = {1, 2, -1}, ys[] = {1, 0, -3};
+//     int8_t signs[3];
+//     classifyPositions(xs, ys, 3, P, v, signs);
+//     for (int i = 0; i < 3; i++) std::cout << int(signs[i]) << " ";
+//     std::cout << std::endl;
+
 //     return 0;
 // }
 
@@ -201,6 +257,48 @@ int main() {
 //     return 0;
 // }
 
+//扫描线求所有线段交点测试，与两两暴力判断的结果对比
+
+// #include <iostream>
+// #include <random>
+// #include <set>
+// #include "LineSegmentIntersection.h"
+
+// using namespace LineSegmentIntersection;
+
+// int main() {
+//     // 在小网格上随机生成线段，包含大量共端点、共线重叠、水平和竖直线段
+//     std::mt19937 rng(2024);
+//     std::vector<Segment> segments;
+//     for (int i = 0; i < 500; ++i) {
+//         Point a = {double(rng() % 20), double(rng() % 20)};
+//         Point b = {double(rng() % 20), double(rng() % 20)};
+//         segments.push_back({a, b});
+//     }
+
+//     // 暴力 O(n^2) 结果
+//     std::set<std::pair<int, int>> expected;
+//     for (size_t i = 0; i < segments.size(); ++i) {
+//         for (size_t j = i + 1; j < segments.size(); ++j) {
+//             if (segmentsIntersect(segments[i].a, segments[i].b, segments[j].a, segments[j].b)) {
+//                 expected.insert(std::make_pair(int(i), int(j)));
+//             }
+//         }
+//     }
+
+//     // 扫描线结果
+//     std::set<std::pair<int, int>> actual;
+//     for (const auto& r : findAllIntersections(segments)) {
+//         actual.insert(std::make_pair(r.first, r.second));
+//     }
+
+//     std::cout << "Brute force pairs: " << expected.size() << "\n";
+//     std::cout << "Sweep line pairs: " << actual.size() << "\n";
+//     std::cout << (expected == actual ? "PASSED" : "FAILED") << std::endl;
+
+//     return expected == actual ? 0 : 1;
+// }
+
 //点与多边形位置关系判断程序
 
 // #include <iostream>
@@ -262,6 +360,14 @@ int main() {
 //         std::cout << "Error: " << e.what() << std::endl;
 //     }
 
+//     // 批量求交，不抛出异常：第二对平行，第三对重合
+//     double A1[] = {1, 1, 1}, B1[] = {-1, -1, 1}, C1[] = {0, 0, 1};
+//     double A2[] = {1, 1, 2}, B2[] = {1, -1, 2}, C2[] = {-4, 1, 2};
+//     double x[3], y[3];
+//     uint8_t status[3];
+//     findIntersections(A1, B1, C1, A2, B2, C2, 3, x, y, status);
+//     for (int i = 0; i < 3; i++) std::cout << int(status[i]) << " (" << x[i] << ", " << y[i] << ")\n";
+
 //     return 0;
 // }
 
@@ -287,6 +393,14 @@ int main() {
 //         // 输出结果
 //         std::cout << "The area of the polygon is: " << area << std::endl;
 
+//         // 批量计算：两个多边形的顶点按列存放，offsets 标出各自的范围，逆时针的面积为正
+//         double xs[] = {0, 4, 4, 0, 0, 0, 3};
+//         double ys[] = {0, 0, 4, 4, 0, 3, 0};
+//         size_t offsets[] = {0, 4, 7};
+//         double areas[2];
+//         polygonAreas(xs, ys, offsets, 2, areas);
+//         std::cout << areas[0] << " " << areas[1] << std::endl;  // 16 -4.5
+
 //     return 0;
 // }
 
@@ -302,8 +416,281 @@ int main() {
 //         {4, 5, 7, 8},
 //     };
 
-//     int area = calculateArea(rectangles);
+//     unsigned long long area = calculateArea(rectangles);
 //     std::cout << "Total area covered by rectangles: " << area << std::endl;
 
 //     return 0;
-// }
\ No newline at end of file
+// }
+
+
+
+//共用点集的多阶段流水线：凸包 -> 三角剖分 -> 面积 -> 点分类，全程不转换点的类型
+
+// #include <iostream>
+// #include <random>
+// #include "convex_hull.h"
+// #include "delaunay.h"
+// #include "polygonArea.h"
+// #include "PointInPolygon.h"
+// int main() {
+//     std::mt19937 rng(7);
+//     std::uniform_real_distribution<double> coord(0.0, 100.0);
+
+//     // 点按列存储在一个缓冲区中，各算法通过视图读取
+//     PointSet points;
+//     for (int i = 0; i < 1000; i++) points.push_back(Point(coord(rng), coord(rng)));
+//     PointView view = points.view();
+
+//     std::vector<int> hull = ConvexHull::hullIndices(view);
+
+//     Delaunay dt;
+//     dt.init(view);
+
+//     double area = polygonArea(view, hull);
+
+//     std::vector<Point> boundary;
+//     for (int i : hull) boundary.push_back(view[i]);
+//     std::vector<uint8_t> location(view.size());
+//     PointInPolygon::classifyPoints(view, boundary, location.data());
+
+//     std::cout << "hull vertices: " << hull.size() << "\n"
+//               << "delaunay edges: " << dt.getEdge().size() << "\n"
+//               << "hull area: " << area << "\n";
+//     return 0;
+// }
+
+
+
+// R 树空间索引测试：先用包围盒筛选候选，再做精确判断
+
+// #include <iostream>
+// #include "RTree.h"
+// #include "PointInPolygon.h"
+// #include "LineSegmentIntersection.h"
+// int main() {
+//     // 哪个区域包含该点
+//     std::vector<std::vector<Point>> zones = {
+//         {{0, 0}, {4, 0}, {4, 4}, {0, 4}},
+//         {{4, 0}, {8, 0}, {6, 4}},
+//     };
+//     RTree zoneIndex = RTree::fromPolygons(zones);
+//     std::vector<int> candidates;
+//     zoneIndex.queryPoint(5, 1, candidates);
+//     for (int id : candidates) {
+//         if (PointInPolygon::isPointInPolygonRayCasting(Point(5, 1), zones[id])) std::cout << "zone " << id << "\n";
+//     }
+
+//     // 哪些线段与给定线段相交
+//     using LineSegmentIntersection::Segment;
+//     std::vector<Segment> segments = {{{0, 0}, {4, 4}}, {{0, 4}, {4, 0}}, {{5, 5}, {6, 6}}};
+//     RTree segmentIndex = RTree::fromSegments(segments);
+//     Segment query = {{0, 2}, {4, 2}};
+//     RTree::Box window = {0, 2, 4, 2};
+//     candidates.clear();
+//     segmentIndex.queryWindow(window, candidates);
+//     for (int id : candidates) {
+//         if (LineSegmentIntersection::segmentsIntersect(query.a, query.b, segments[id].a, segments[id].b)) {
+//             std::cout << "segment " << id << "\n";
+//         }
+//     }
+//     return 0;
+// }
+
+
+
+// 二进制点云文件测试：写入后映射回来直接求凸包，不复制点
+
+// #include <iostream>
+// #include "PointCloud.h"
+// #include "convex_hull.h"
+// int main() {
+//     PointSet points;
+//     for (int i = 0; i < 1000; i++) points.push_back(Point(i % 37, i / 37));
+//     PointCloud::write("points.bin", points);
+
+//     PointCloud::MappedFile file("points.bin");
+//     std::vector<int> hull = ConvexHull::hullIndices(file.view());
+//     std::cout << "hull size: " << hull.size() << "\n";
+
+//     // 分块顺序遍历，处理完的块释放掉
+//     double sumX = 0;
+//     file.forEachChunk(256, [&](const PointView& chunk, size_t) {
+//         for (size_t i = 0; i < chunk.size(); i++) sumX += chunk.x(i);
+//     }, true);
+//     std::cout << "sum of x: " << sumX << "\n";
+//     return 0;
+// }
+
+
+
+// 运行统计测试：需要以 -DGEOM_ENABLE_STATS=ON 配置，否则计数全为 0
+
+// #include <iostream>
+// #include "stats.h"
+// #include "delaunay.h"
+// int main() {
+//     std::vector<Point> points;
+//     for (int i = 0; i < 1000; i++) points.push_back(Point(i % 40, (i * 7) % 23));
+//     stats::Stats before = stats::collect();
+//     Delaunay delaunay;
+//     delaunay.init(points);
+//     std::cout << (stats::collect() - before).toJson() << "\n";
+//     return 0;
+// }
+
+
+
+// Delaunay 最近点查询与 Voronoi 图测试
+
+// #include <iostream>
+// #include "delaunay.h"
+// int main() {
+//     std::vector<Point> depots = {{0, 0, 0}, {10, 0, 1}, {5, 8, 2}, {12, 9, 3}, {3, 4, 4}};
+//     Delaunay delaunay;
+//     delaunay.init(depots);
+
+//     PointSet orders;
+//     orders.push_back(Point(1, 1));
+//     orders.push_back(Point(11, 8));
+//     orders.push_back(Point(6, 6));
+//     std::vector<int> nearest(orders.size());
+//     delaunay.nearest(orders, nearest.data());
+//     for (size_t i = 0; i < nearest.size(); i++) std::cout << "order " << i << " -> depot " << nearest[i] << "\n";
+
+//     Delaunay::Voronoi voronoi;
+//     delaunay.getVoronoi(voronoi, -5, -5, 20, 15);
+//     for (size_t c = 0; c < voronoi.site.size(); c++) {
+//         std::cout << "cell of " << voronoi.site[c] << ":";
+//         for (size_t k = voronoi.offsets[c]; k < voronoi.offsets[c + 1]; k++) {
+//             std::cout << " (" << voronoi.x[k] << ", " << voronoi.y[k] << ")";
+//         }
+//         std::cout << "\n";
+//     }
+//     return 0;
+// }
+
+
+
+// 动态凸包与滑动窗口凸包测试
+
+// #include <iostream>
+// #include "DynamicHull.h"
+// int main() {
+//     DynamicHull hull;
+//     int samples[][2] = {{0, 0}, {4, 0}, {2, 1}, {4, 4}, {0, 4}, {2, 6}};
+//     for (int i = 0; i < 6; i++) {
+//         bool changed = hull.insert(Point(samples[i][0], samples[i][1], i));
+//         std::cout << "insert " << i << (changed ? " changed" : " inside") << ", size " << hull.size() << "\n";
+//     }
+//     Point top = hull.extreme(0, 1);
+//     std::cout << "top vertex " << top.id << ", contains (1, 1): " << hull.contains(Point(1, 1)) << "\n";
+
+//     SlidingWindowHull window(3);
+//     for (int i = 0; i < 6; i++) {
+//         window.push(Point(samples[i][0], samples[i][1], i));
+//         std::vector<Point> vertices = window.vertices();
+//         std::cout << "window hull:";
+//         for (size_t k = 0; k < vertices.size(); k++) std::cout << " " << vertices[k].id;
+//         std::cout << "\n";
+//     }
+//     return 0;
+// }
+
+
+
+// 旋转卡壳测试
+
+// #include <iostream>
+// #include "convex_hull.h"
+// int main() {
+//     std::vector<Point> points = {{0, 0}, {4, 1}, {5, 4}, {1, 3}, {2, 2}, {3, 1}};
+//     std::vector<Point> hull = ConvexHull::compute(points);
+//     ConvexHull::Calipers calipers = ConvexHull::rotatingCalipers(hull);
+//     std::cout << "diameter " << calipers.diameter.distance << " between (" << calipers.diameter.a.x << ", "
+//               << calipers.diameter.a.y << ") and (" << calipers.diameter.b.x << ", " << calipers.diameter.b.y << ")\n";
+//     std::cout << "width " << calipers.width.width << "\n";
+//     std::cout << "min area rectangle " << calipers.minArea.area << ":";
+//     for (int k = 0; k < 4; k++) std::cout << " (" << calipers.minArea.corners[k].x << ", " << calipers.minArea.corners[k].y << ")";
+//     std::cout << "\nmin perimeter rectangle " << calipers.minPerimeter.perimeter << "\n";
+//     return 0;
+// }
+
+
+
+// 凸多边形快速点定位测试
+
+// #include <iostream>
+// #include "PointInPolygon.h"
+// #include "convex_hull.h"
+// int main() {
+//     std::vector<Point> points = {{0, 0}, {6, 0}, {7, 4}, {3, 7}, {-1, 4}, {3, 3}};
+//     PointInPolygon::ConvexPolygon polygon(ConvexHull::compute(points));
+//     Point queries[] = {{3, 3}, {6, 0}, {3, 0}, {8, 8}};
+//     for (int i = 0; i < 4; i++) {
+//         std::cout << "(" << queries[i].x << ", " << queries[i].y << "): " << polygon.locate(queries[i]) << "\n";
+//     }
+//     return 0;
+// }
+
+
+
+// 平面细分点定位测试
+
+// #include <iostream>
+// #include "PointLocator.h"
+// int main() {
+//     std::vector<std::vector<Point>> zones = {
+//         {{0, 0}, {4, 0}, {4, 3}, {0, 3}},
+//         {{4, 0}, {8, 0}, {6, 3}, {4, 3}},
+//         {{0, 3}, {6, 3}, {3, 6}},
+//     };
+//     PointLocator locator(zones);
+//     locator.save("zones.bin");
+//     PointLocator loaded = PointLocator::load("zones.bin");
+//     Point queries[] = {{1, 1}, {5, 1}, {3, 4}, {9, 9}, {4, 1}};
+//     for (int i = 0; i < 5; i++) {
+//         std::cout << "(" << queries[i].x << ", " << queries[i].y << ") -> " << loaded.locate(queries[i]) << "\n";
+//     }
+//     return 0;
+// }
+
+
+
+
+// 共用线程池批量查询测试
+
+// #include <iostream>
+// #include "ThreadPool.h"
+// #include "LineSegmentIntersection.h"
+// #include "PointInPolygon.h"
+// int main() {
+//     setGlobalThreads(4);
+//     std::vector<Point> square = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+//     std::vector<Point> queries = {{1, 1}, {4, 2}, {5, 5}, {2, 3}};
+//     uint8_t inside[4];
+//     PointInPolygon::isPointInPolygonRayCasting(queries, square, inside, 0);
+//     LineSegmentIntersection::Segment first[] = {{{0, 0}, {2, 2}}, {{0, 0}, {1, 0}}};
+//     LineSegmentIntersection::Segment second[] = {{{0, 2}, {2, 0}}, {{2, 0}, {3, 0}}};
+//     uint8_t crossed[2];
+//     LineSegmentIntersection::segmentsIntersect(first, second, 2, crossed, 0);
+//     for (int i = 0; i < 4; i++) std::cout << int(inside[i]) << " ";
+//     std::cout << "| " << int(crossed[0]) << " " << int(crossed[1]) << " | threads: " << globalThreads() << "\n";
+//     return 0;
+// }
+
+
+
+
+// 矩形覆盖面积、周长与覆盖深度测试
+
+// #include <iostream>
+// #include "ScaningLineAlgorythm.h"
+// int main() {
+//     std::vector<Rectangle> rectangles = {{0, 0, 4, 4}, {2, 2, 6, 6}, {3, 0, 5, 3}};
+//     CoverageResult result = calculateCoverage(rectangles, CoverageOptions(CoverArea | CoverPerimeter | CoverDepth, 3));
+//     std::cout << "area: " << result.area << ", perimeter: " << result.perimeter << "\n";
+//     for (size_t k = 0; k < result.depthArea.size(); k++) {
+//         std::cout << "covered at least " << k + 1 << " times: " << result.depthArea[k] << "\n";
+//     }
+//     return 0;
+// }
@@ -1,12 +1,15 @@
 // point_line.cpp
 
 #include "point_line.h"
+#include "predicates.h"
+#include "simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
 
 // 函数用于计算 PQ 向量与 v 向量的叉积
+// 由自适应精度谓词计算，符号总是正确的，在直线上的点结果恰好为 0
 double crossProduct(const Point& P, const Point& Q, const Vector& v) {
-    double pq_x = Q.x - P.x;
-    double pq_y = Q.y - P.y;
-    return pq_x * v.y - pq_y * v.x;
+    return predicates::orient2dDirection(P.x, P.y, v.x, v.y, Q.x, Q.y);
 }
 
 // 函数用于判断点 Q 相对于过点 P 的直线的位置关系
@@ -20,3 +23,139 @@ std::string determinePosition(const Point& P, const Point& Q, const Vector& v) {
         return "Pointis on the line";
     }
 }
+
+// 批量接口每次处理 64 个点，内核输出这些点的正负位掩码
+static const size_t BLOCK = 64;
+
+typedef void (*SignKernel)(const double* xs, const double* ys, size_t count, const Point& P, const Vector& v,
+                           double tolerance, uint64_t& above, uint64_t& below);
+
+// 标量内核，直接调用 crossProduct
+static void signsScalar(const double* xs, const double* ys, size_t count, const Point& P, const Vector& v,
+                        double tolerance, uint64_t& above, uint64_t& below) {
+    above = below = 0;
+    for (size_t k = 0; k < count; ++k) {
+        double cross = crossProduct(P, Point(xs[k], ys[k]), v);
+        if (cross > tolerance) above |= uint64_t(1) << k;
+        if (cross < -tolerance) below |= uint64_t(1) << k;
+    }
+}
+
+#ifdef SIMD_X86
+// 向量内核与 orient2dDirection 的快速路径做同样的运算：|叉积| 不小于误差界的通道直接使用
+// 其余通道（mask 中置位，结果的符号可能不可靠）由 crossProduct 重新计算，这种情况很少出现
+static void recheckLanes(const double* xs, const double* ys, size_t first, int mask, const Point& P, const Vector& v,
+                         double tolerance, uint64_t& above, uint64_t& below) {
+    for (; mask != 0; mask &= mask - 1) {
+        size_t k = first + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        double cross = crossProduct(P, Point(xs[k], ys[k]), v);
+        uint64_t bit = uint64_t(1) << k;
+        above = cross > tolerance ? above | bit : above & ~bit;
+        below = cross < -tolerance ? below | bit : below & ~bit;
+    }
+}
+
+// SSE2 内核，每次处理 2 个点，不足的尾部交给标量内核
+__attribute__((target("sse2")))
+static void signsSSE2(const double* xs, const double* ys, size_t count, const Point& P, const Vector& v,
+                      double tolerance, uint64_t& above, uint64_t& below) {
+    const __m128d px = _mm_set1_pd(P.x), py = _mm_set1_pd(P.y);
+    const __m128d vx = _mm_set1_pd(v.x), vy = _mm_set1_pd(v.y);
+    const __m128d hi = _mm_set1_pd(tolerance), lo = _mm_set1_pd(-tolerance);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d errorBound = _mm_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    uint64_t a = 0, b = 0;
+    size_t k = 0;
+    for (; k + 2 <= count; k += 2) {
+        __m128d left = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(xs + k), px), vy);
+        __m128d right = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(ys + k), py), vx);
+        __m128d cross = _mm_sub_pd(left, right);
+        __m128d bound = _mm_mul_pd(errorBound, _mm_add_pd(_mm_and_pd(left, absMask), _mm_and_pd(right, absMask)));
+        a |= static_cast<uint64_t>(_mm_movemask_pd(_mm_cmpgt_pd(cross, hi))) << k;
+        b |= static_cast<uint64_t>(_mm_movemask_pd(_mm_cmplt_pd(cross, lo))) << k;
+        int uncertain = _mm_movemask_pd(_mm_cmplt_pd(_mm_and_pd(cross, absMask), bound));
+        if (uncertain != 0) recheckLanes(xs, ys, k, uncertain, P, v, tolerance, a, b);
+    }
+    if (k < count) {
+        uint64_t tailAbove, tailBelow;
+        signsScalar(xs + k, ys + k, count - k, P, v, tolerance, tailAbove, tailBelow);
+        a |= tailAbove << k;
+        b |= tailBelow << k;
+    }
+    above = a;
+    below = b;
+}
+
+// AVX2 内核，每次处理 4 个点
+__attribute__((target("avx2")))
+static void signsAVX2(const double* xs, const double* ys, size_t count, const Point& P, const Vector& v,
+                      double tolerance, uint64_t& above, uint64_t& below) {
+    const __m256d px = _mm256_set1_pd(P.x), py = _mm256_set1_pd(P.y);
+    const __m256d vx = _mm256_set1_pd(v.x), vy = _mm256_set1_pd(v.y);
+    const __m256d hi = _mm256_set1_pd(tolerance), lo = _mm256_set1_pd(-tolerance);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d errorBound = _mm256_set1_pd(predicates::ORIENT2D_ERROR_BOUND);
+    uint64_t a = 0, b = 0;
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256d left = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(xs + k), px), vy);
+        __m256d right = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(ys + k), py), vx);
+        __m256d cross = _mm256_sub_pd(left, right);
+        __m256d bound = _mm256_mul_pd(errorBound,
+                                      _mm256_add_pd(_mm256_and_pd(left, absMask), _mm256_and_pd(right, absMask)));
+        a |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(cross, hi, _CMP_GT_OQ))) << k;
+        b |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(cross, lo, _CMP_LT_OQ))) << k;
+        int uncertain = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_and_pd(cross, absMask), bound, _CMP_LT_OQ));
+        if (uncertain != 0) recheckLanes(xs, ys, k, uncertain, P, v, tolerance, a, b);
+    }
+    if (k < count) {
+        uint64_t tailAbove, tailBelow;
+        signsScalar(xs + k, ys + k, count - k, P, v, tolerance, tailAbove, tailBelow);
+        a |= tailAbove << k;
+        b |= tailBelow << k;
+    }
+    above = a;
+    below = b;
+}
+#endif
+
+static SignKernel selectKernel() {
+#ifdef SIMD_X86
+    simd::Level level = simd::activeLevel();
+    if (level == simd::AVX2) return signsAVX2;
+    if (level == simd::SSE2) return signsSSE2;
+#endif
+    return signsScalar;
+}
+
+// 并行时按 BLOCK 个点的整块划分，每块的掩码只由一个线程写入
+static const size_t BLOCKS_PER_TASK = 256;
+
+void classifyPositions(const double* xs, const double* ys, size_t n, const Point& P, const Vector& v,
+                       int8_t* out, double tolerance, int threads) {
+    SignKernel kernel = selectKernel();
+    parallelFor((n + BLOCK - 1) / BLOCK, BLOCKS_PER_TASK, [=](size_t beginBlock, size_t endBlock) {
+        for (size_t first = beginBlock * BLOCK; first < std::min(n, endBlock * BLOCK); first += BLOCK) {
+            size_t count = std::min(BLOCK, n - first);
+            uint64_t above, below;
+            kernel(xs + first, ys + first, count, P, v, tolerance, above, below);
+            for (size_t k = 0; k < count; ++k) {
+                out[first + k] = static_cast<int8_t>(static_cast<int>((above >> k) & 1) - static_cast<int>((below >> k) & 1));
+            }
+        }
+    }, threads);
+}
+
+void classifyPositionsMask(const double* xs, const double* ys, size_t n, const Point& P, const Vector& v,
+                           uint64_t* above, uint64_t* below, double tolerance, int threads) {
+    SignKernel kernel = selectKernel();
+    parallelFor((n + BLOCK - 1) / BLOCK, BLOCKS_PER_TASK, [=](size_t beginBlock, size_t endBlock) {
+        for (size_t first = beginBlock * BLOCK; first < std::min(n, endBlock * BLOCK); first += BLOCK) {
+            size_t count = std::min(BLOCK, n - first);
+            uint64_t a, b;
+            kernel(xs + first, ys + first, count, P, v, tolerance, a, b);
+            if (above != nullptr) above[first / BLOCK] = a;
+            if (below != nullptr) below[first / BLOCK] = b;
+        }
+    }, threads);
+}
@@ -1,18 +1,176 @@
 #include "polygonArea.h"
+#include "ThreadPool.h"
+#include "simd.h"
+#include <algorithm>
 
+// Neumaier 补偿求和：额外记录每次加法的舍入误差，最后一并加回
+struct CompensatedSum {
+    double sum, compensation;
+
+    CompensatedSum() : sum(0), compensation(0) {}
+
+    void add(double value) {
+        double t = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) compensation += (sum - t) + value;
+        else compensation += (value - t) + sum;
+        sum = t;
+    }
+
+    double result() const { return sum + compensation; }
+};
+
+// 以第一个顶点为原点的鞋带公式，与第一个顶点相邻的两条边贡献为 0，不需要首尾相接
+// 平移后坐标的量级与多边形大小相当，大坐标下不会因为两个大数相减而丢失精度
 double polygonArea(const std::vector<_Point>& vertices) {
-    int n = vertices.size();
+    return polygonArea(PointView(vertices));
+}
+
+double polygonArea(const PointView& vertices) {
+    size_t n = vertices.size();
     if (n < 3) {
         return 0; // 不形成多边形
     }
 
-    double area = 0.0;
+    double x0 = vertices.x(0), y0 = vertices.y(0);
+    CompensatedSum area;
+    for (size_t i = 1; i + 1 < n; ++i) {
+        area.add((vertices.x(i) - x0) * (vertices.y(i + 1) - y0) - (vertices.y(i) - y0) * (vertices.x(i + 1) - x0));
+    }
+    return std::fabs(area.result()) / 2.0;
+}
+
+double polygonArea(const PointView& points, const std::vector<int>& order) {
+    size_t n = order.size();
+    if (n < 3) {
+        return 0; // 不形成多边形
+    }
+
+    double x0 = points.x(order[0]), y0 = points.y(order[0]);
+    CompensatedSum area;
+    for (size_t i = 1; i + 1 < n; ++i) {
+        int a = order[i], b = order[i + 1];
+        area.add((points.x(a) - x0) * (points.y(b) - y0) - (points.y(a) - y0) * (points.x(b) - x0));
+    }
+    return std::fabs(area.result()) / 2.0;
+}
+
+// 顶点 [first, last) 构成的多边形的有向面积，从 begin 开始累加到 area 中
+static void shoelaceTail(const double* xs, const double* ys, size_t first, size_t begin, size_t last,
+                         CompensatedSum& area) {
+    double x0 = xs[first], y0 = ys[first];
+    for (size_t i = begin; i + 1 < last; ++i) {
+        area.add((xs[i] - x0) * (ys[i + 1] - y0) - (ys[i] - y0) * (xs[i + 1] - x0));
+    }
+}
+
+static double shoelaceScalar(const double* xs, const double* ys, size_t first, size_t last) {
+    if (last - first < 3) return 0;
+    CompensatedSum area;
+    shoelaceTail(xs, ys, first, first + 1, last, area);
+    return area.result() / 2.0;
+}
+
+#ifdef SIMD_X86
+// 顶点数少于该值的多边形向量化得不偿失，直接用标量内核
+static const size_t SHORT_POLYGON = 16;
+
+// SSE2 内核：每个通道各自做补偿求和，最后把各通道的和与误差合并
+__attribute__((target("sse2")))
+static double shoelaceSSE2(const double* xs, const double* ys, size_t first, size_t last) {
+    if (last - first < SHORT_POLYGON) return shoelaceScalar(xs, ys, first, last);
+    const __m128d x0 = _mm_set1_pd(xs[first]), y0 = _mm_set1_pd(ys[first]);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d sum = _mm_setzero_pd(), compensation = _mm_setzero_pd();
+    size_t i = first + 1;
+    for (; i + 2 < last; i += 2) {
+        __m128d xa = _mm_sub_pd(_mm_loadu_pd(xs + i), x0), ya = _mm_sub_pd(_mm_loadu_pd(ys + i), y0);
+        __m128d xb = _mm_sub_pd(_mm_loadu_pd(xs + i + 1), x0), yb = _mm_sub_pd(_mm_loadu_pd(ys + i + 1), y0);
+        __m128d term = _mm_sub_pd(_mm_mul_pd(xa, yb), _mm_mul_pd(ya, xb));
+        __m128d t = _mm_add_pd(sum, term);
+        __m128d sumLarger = _mm_cmpge_pd(_mm_and_pd(sum, absMask), _mm_and_pd(term, absMask));
+        __m128d errSum = _mm_add_pd(_mm_sub_pd(sum, t), term);
+        __m128d errTerm = _mm_add_pd(_mm_sub_pd(term, t), sum);
+        compensation = _mm_add_pd(compensation, _mm_or_pd(_mm_and_pd(sumLarger, errSum), _mm_andnot_pd(sumLarger, errTerm)));
+        sum = t;
+    }
+    double sums[2], compensations[2];
+    _mm_storeu_pd(sums, sum);
+    _mm_storeu_pd(compensations, compensation);
+    CompensatedSum area;
+    for (int k = 0; k < 2; ++k) area.add(sums[k]);
+    for (int k = 0; k < 2; ++k) area.add(compensations[k]);
+    shoelaceTail(xs, ys, first, i, last, area);
+    return area.result() / 2.0;
+}
+
+// AVX2 内核，每次处理 4 条边
+__attribute__((target("avx2")))
+static double shoelaceAVX2(const double* xs, const double* ys, size_t first, size_t last) {
+    if (last - first < SHORT_POLYGON) return shoelaceScalar(xs, ys, first, last);
+    const __m256d x0 = _mm256_set1_pd(xs[first]), y0 = _mm256_set1_pd(ys[first]);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d sum = _mm256_setzero_pd(), compensation = _mm256_setzero_pd();
+    size_t i = first + 1;
+    for (; i + 4 < last; i += 4) {
+        __m256d xa = _mm256_sub_pd(_mm256_loadu_pd(xs + i), x0), ya = _mm256_sub_pd(_mm256_loadu_pd(ys + i), y0);
+        __m256d xb = _mm256_sub_pd(_mm256_loadu_pd(xs + i + 1), x0), yb = _mm256_sub_pd(_mm256_loadu_pd(ys + i + 1), y0);
+        __m256d term = _mm256_sub_pd(_mm256_mul_pd(xa, yb), _mm256_mul_pd(ya, xb));
+        __m256d t = _mm256_add_pd(sum, term);
+        __m256d sumLarger = _mm256_cmp_pd(_mm256_and_pd(sum, absMask), _mm256_and_pd(term, absMask), _CMP_GE_OQ);
+        __m256d errSum = _mm256_add_pd(_mm256_sub_pd(sum, t), term);
+        __m256d errTerm = _mm256_add_pd(_mm256_sub_pd(term, t), sum);
+        compensation = _mm256_add_pd(compensation, _mm256_blendv_pd(errTerm, errSum, sumLarger));
+        sum = t;
+    }
+    double sums[4], compensations[4];
+    _mm256_storeu_pd(sums, sum);
+    _mm256_storeu_pd(compensations, compensation);
+    // shoelaceTail 按 SSE 编码，GCC 在这次调用前没有插入 vzeroupper（-O2 下的反汇编中没有），
+    // 每个多边形都要付出一次 AVX 到 SSE 的状态切换，16 到 64 个顶点的多边形慢 2 到 4 倍
+    _mm256_zeroupper();
+    CompensatedSum area;
+    for (int k = 0; k < 4; ++k) area.add(sums[k]);
+    for (int k = 0; k < 4; ++k) area.add(compensations[k]);
+    shoelaceTail(xs, ys, first, i, last, area);
+    return area.result() / 2.0;
+}
+#endif
+
+typedef double (*ShoelaceKernel)(const double* xs, const double* ys, size_t first, size_t last);
+
+static void areasInRange(ShoelaceKernel kernel, const double* xs, const double* ys, const size_t* offsets,
+                         size_t begin, size_t end, double* areas) {
+    for (size_t k = begin; k < end; ++k) areas[k] = kernel(xs, ys, offsets[k], offsets[k + 1]);
+}
+
+void polygonAreas(const double* xs, const double* ys, const size_t* offsets, size_t count,
+                  double* areas, int threads) {
+    ShoelaceKernel kernel = shoelaceScalar;
+#ifdef SIMD_X86
+    simd::Level level = simd::activeLevel();
+    if (level == simd::AVX2) kernel = shoelaceAVX2;
+    else if (level == simd::SSE2) kernel = shoelaceSSE2;
+#endif
+
+    // 按顶点数均分为线程数 4 倍的块，块太小时不值得并行
+    if (threads <= 0) threads = globalThreads();
+    const size_t minChunkVertices = 1 << 16;
+    size_t vertices = count > 0 ? offsets[count] - offsets[0] : 0;
+    size_t chunks = std::min(static_cast<size_t>(threads) * 4, vertices / minChunkVertices);
+    if (threads == 1 || chunks <= 1) {
+        areasInRange(kernel, xs, ys, offsets, 0, count, areas);
+        return;
+    }
 
-    for (int i = 0; i < n; ++i) {
-        int j = (i + 1) % n; // 下一个顶点
-        area += vertices[i].x * vertices[j].y - vertices[i].y * vertices[j].x;
+    // 第 c 块从顶点数达到 c / chunks 的第一个多边形开始
+    std::vector<size_t> start(chunks + 1, count);
+    start[0] = 0;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t target = offsets[0] + vertices / chunks * c;
+        start[c] = std::lower_bound(offsets, offsets + count, target) - offsets;
     }
 
-    std::cout << "Computed raw area: " << area << std::endl;
-    return std::fabs(area) / 2.0;
-}
\ No newline at end of file
+    parallelFor(chunks, 1, [kernel, xs, ys, offsets, areas, &start](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) areasInRange(kernel, xs, ys, offsets, start[c], start[c + 1], areas);
+    }, threads);
+}
@@ -0,0 +1,202 @@
+#include "predicates.h"
+#include <algorithm>
+
+// 浮点展开式：若干个互不重叠的 double 之和，按绝对值从小到大排列，值为 0 的分量被去掉
+// 参考 J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+// 本文件需要关闭浮点乘加融合（-ffp-contract=off），否则误差项的计算不再精确
+
+namespace predicates {
+
+static const double SPLITTER = 134217729.0;  // 2^27 + 1
+
+// x + y = a + b，x 为 a + b 的舍入结果
+static inline void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double bVirtual = x - a;
+    double aVirtual = x - bVirtual;
+    y = (a - aVirtual) + (b - bVirtual);
+}
+
+// 要求 |a| >= |b|
+static inline void fastTwoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    y = b - (x - a);
+}
+
+static inline void twoDiff(double a, double b, double& x, double& y) {
+    x = a - b;
+    double bVirtual = a - x;
+    double aVirtual = x + bVirtual;
+    y = (a - aVirtual) + (bVirtual - b);
+}
+
+// 把 a 拆成高低两半，各自不超过 26 位有效数字
+static inline void split(double a, double& hi, double& lo) {
+    double c = SPLITTER * a;
+    double big = c - a;
+    hi = c - big;
+    lo = a - hi;
+}
+
+// x + y = a * b
+static inline void twoProduct(double a, double b, double& x, double& y) {
+    x = a * b;
+    double aHi, aLo, bHi, bLo;
+    split(a, aHi, aLo);
+    split(b, bHi, bLo);
+    double err1 = x - aHi * bHi;
+    double err2 = err1 - aLo * bHi;
+    double err3 = err2 - aHi * bLo;
+    y = aLo * bLo - err3;
+}
+
+// 展开式存放在调用者提供的定长数组中，函数返回分量个数，0 个分量表示值为 0
+// 精确计算中最长的展开式为 incircle 的 1536 个分量，全部放在栈上，不分配堆内存
+
+// a - b 的精确值，h 至少 2 个分量
+static int difference(double a, double b, double* h) {
+    double x, y;
+    twoDiff(a, b, x, y);
+    int n = 0;
+    if (y != 0) h[n++] = y;
+    if (x != 0) h[n++] = x;
+    return n;
+}
+
+// e + f：按绝对值归并两个展开式，依次累加，h 至少 elen + flen 个分量
+static int add(int elen, const double* e, int flen, const double* f, double* h) {
+    int i = 0, j = 0, n = 0;
+    double q = 0.0;
+    while (i < elen || j < flen) {
+        double next;
+        if (j >= flen || (i < elen && std::fabs(e[i]) < std::fabs(f[j]))) next = e[i++];
+        else next = f[j++];
+        double sum, err;
+        twoSum(q, next, sum, err);
+        q = sum;
+        if (err != 0) h[n++] = err;
+    }
+    if (q != 0) h[n++] = q;
+    return n;
+}
+
+static void negate(int elen, double* e) {
+    for (int i = 0; i < elen; i++) e[i] = -e[i];
+}
+
+// e * b，h 至少 2 * elen 个分量
+static int scale(int elen, const double* e, double b, double* h) {
+    if (elen == 0 || b == 0) return 0;
+    int n = 0;
+    double q, err;
+    twoProduct(e[0], b, q, err);
+    if (err != 0) h[n++] = err;
+    for (int i = 1; i < elen; i++) {
+        double product1, product0, sum;
+        twoProduct(e[i], b, product1, product0);
+        twoSum(q, product0, sum, err);
+        if (err != 0) h[n++] = err;
+        fastTwoSum(product1, sum, q, err);
+        if (err != 0) h[n++] = err;
+    }
+    if (q != 0) h[n++] = q;
+    return n;
+}
+
+static const int MAX_FACTOR = 16;  // multiply 的左操作数最多 16 个分量
+
+// e * f：逐个分量缩放后累加，h 和 buffer 至少 2 * elen * flen 个分量
+static int multiply(int elen, const double* e, int flen, const double* f, double* h, double* buffer) {
+    double scaled[2 * MAX_FACTOR];
+    double* cur = h;
+    double* other = buffer;
+    int n = 0;
+    for (int i = 0; i < flen; i++) {
+        int m = scale(elen, e, f[i], scaled);
+        n = add(n, cur, m, scaled, other);
+        std::swap(cur, other);
+    }
+    if (cur != h) std::copy(cur, cur + n, h);
+    return n;
+}
+
+// 展开式的值由绝对值最大的分量决定符号，返回该分量作为近似值
+static double estimate(int elen, const double* e) {
+    return elen == 0 ? 0.0 : e[elen - 1];
+}
+
+// x1 * y1 - x2 * y2，四个因子都是 difference 的结果，h 至少 16 个分量
+static int crossTerm(int x1len, const double* x1, int y1len, const double* y1,
+                     int x2len, const double* x2, int y2len, const double* y2, double* h) {
+    double left[8], right[8], buffer[8];
+    int l = multiply(x1len, x1, y1len, y1, left, buffer);
+    int r = multiply(x2len, x2, y2len, y2, right, buffer);
+    negate(r, right);
+    return add(l, left, r, right, h);
+}
+
+double orient2dExact(double ax, double ay, double bx, double by, double cx, double cy) {
+    double acx[2], acy[2], bcx[2], bcy[2];
+    int acxlen = difference(ax, cx, acx), acylen = difference(ay, cy, acy);
+    int bcxlen = difference(bx, cx, bcx), bcylen = difference(by, cy, bcy);
+
+    double det[16];
+    int detlen = crossTerm(acxlen, acx, bcylen, bcy, acylen, acy, bcxlen, bcx, det);
+    return estimate(detlen, det);
+}
+
+double crossDirectionsExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double abx[2], aby[2], cdx[2], cdy[2];
+    int abxlen = difference(bx, ax, abx), abylen = difference(by, ay, aby);
+    int cdxlen = difference(dx, cx, cdx), cdylen = difference(dy, cy, cdy);
+
+    double det[16];
+    int detlen = crossTerm(abxlen, abx, cdylen, cdy, abylen, aby, cdxlen, cdx, det);
+    return estimate(detlen, det);
+}
+
+double orient2dDirectionExact(double px, double py, double vx, double vy, double qx, double qy) {
+    double qpx[2], qpy[2];
+    int qpxlen = difference(qx, px, qpx), qpylen = difference(qy, py, qpy);
+
+    double det[16];
+    int detlen = crossTerm(qpxlen, qpx, vy != 0 ? 1 : 0, &vy, qpylen, qpy, vx != 0 ? 1 : 0, &vx, det);
+    return estimate(detlen, det);
+}
+
+// x 的平方加 y 的平方，h 至少 16 个分量
+static int lift(int xlen, const double* x, int ylen, const double* y, double* h) {
+    double xx[8], yy[8], buffer[8];
+    int xxlen = multiply(xlen, x, xlen, x, xx, buffer);
+    int yylen = multiply(ylen, y, ylen, y, yy, buffer);
+    return add(xxlen, xx, yylen, yy, h);
+}
+
+double incircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+    int adxlen = difference(ax, dx, adx), adylen = difference(ay, dy, ady);
+    int bdxlen = difference(bx, dx, bdx), bdylen = difference(by, dy, bdy);
+    int cdxlen = difference(cx, dx, cdx), cdylen = difference(cy, dy, cdy);
+
+    double alift[16], blift[16], clift[16];
+    int aliftlen = lift(adxlen, adx, adylen, ady, alift);
+    int bliftlen = lift(bdxlen, bdx, bdylen, bdy, blift);
+    int cliftlen = lift(cdxlen, cdx, cdylen, cdy, clift);
+
+    double bc[16], ca[16], ab[16];
+    int bclen = crossTerm(bdxlen, bdx, cdylen, cdy, cdxlen, cdx, bdylen, bdy, bc);
+    int calen = crossTerm(cdxlen, cdx, adylen, ady, adxlen, adx, cdylen, cdy, ca);
+    int ablen = crossTerm(adxlen, adx, bdylen, bdy, bdxlen, bdx, adylen, ady, ab);
+
+    double aterm[512], bterm[512], cterm[512], buffer[512];
+    int atermlen = multiply(aliftlen, alift, bclen, bc, aterm, buffer);
+    int btermlen = multiply(bliftlen, blift, calen, ca, bterm, buffer);
+    int ctermlen = multiply(cliftlen, clift, ablen, ab, cterm, buffer);
+
+    double abterm[1024], det[1536];
+    int abtermlen = add(atermlen, aterm, btermlen, bterm, abterm);
+    int detlen = add(abtermlen, abterm, ctermlen, cterm, det);
+    return estimate(detlen, det);
+}
+
+} // namespace predicates
@@ -0,0 +1,26 @@
+#include "simd.h"
+
+namespace simd {
+
+static Level maxLevel = AVX2;
+
+// 检测 CPU 支持的最高指令集
+static Level detectLevel() {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return AVX2;
+    if (__builtin_cpu_supports("sse2")) return SSE2;
+#endif
+    return Scalar;
+}
+
+Level activeLevel() {
+    static const Level detected = detectLevel();
+    return detected < maxLevel ? detected : maxLevel;
+}
+
+void setMaxLevel(Level level) {
+    maxLevel = level;
+}
+
+} // namespace simd
@@ -0,0 +1,184 @@
+#include "stats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace stats {
+
+static const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+    "Delaunay::inCircle",
+    "Delaunay::intersection",
+    "Delaunay::hullWalkSteps",
+    "Delaunay::mergeSteps",
+    "Delaunay::edgeRemovals",
+    "SegmentTree::updates",
+    "SegmentTree::nodeVisits",
+    "PointInPolygon::queries",
+    "PointInPolygon::edgesTested",
+    "PointInPolygon::boundaryHits",
+};
+
+static const char* const TIMER_NAMES[TIMER_COUNT] = {
+    "Delaunay::build",
+    "calculateArea",
+    "calculateAreaStreaming",
+    "PointInPolygon::classifyPoints",
+    "calculateCoverage",
+};
+
+const char* counterName(Counter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+const char* timerName(Timer timer) {
+    return TIMER_NAMES[timer];
+}
+
+Stats::Stats() {
+    clear();
+}
+
+void Stats::clear() {
+    std::fill(counters, counters + COUNTER_COUNT, 0);
+    std::fill(timerCalls, timerCalls + TIMER_COUNT, 0);
+    std::fill(timerNanoseconds, timerNanoseconds + TIMER_COUNT, 0);
+}
+
+Stats& Stats::operator+=(const Stats& other) {
+    for (int i = 0; i < COUNTER_COUNT; i++) counters[i] += other.counters[i];
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        timerCalls[i] += other.timerCalls[i];
+        timerNanoseconds[i] += other.timerNanoseconds[i];
+    }
+    return *this;
+}
+
+Stats Stats::operator-(const Stats& before) const {
+    Stats delta;
+    for (int i = 0; i < COUNTER_COUNT; i++) delta.counters[i] = counters[i] - before.counters[i];
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        delta.timerCalls[i] = timerCalls[i] - before.timerCalls[i];
+        delta.timerNanoseconds[i] = timerNanoseconds[i] - before.timerNanoseconds[i];
+    }
+    return delta;
+}
+
+std::string Stats::toJson() const {
+    std::ostringstream out;
+    out << "{\"enabled\": " << (enabled() ? "true" : "false") << ", \"counters\": {";
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        out << (i ? ", " : "") << "\"" << COUNTER_NAMES[i] << "\": " << counters[i];
+    }
+    out << "}, \"timers\": {";
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        out << (i ? ", " : "") << "\"" << TIMER_NAMES[i] << "\": {\"calls\": " << timerCalls[i]
+            << ", \"seconds\": " << timerNanoseconds[i] * 1e-9 << "}";
+    }
+    out << "}}";
+    return out.str();
+}
+
+bool enabled() {
+#ifdef GEOM_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// 每个线程的计数器只由本线程写入，用 relaxed 的读和写代替原子加，collect 在其他线程读取时不构成数据竞争
+struct ThreadCounters {
+    std::atomic<uint64_t> values[COUNTER_COUNT + 2 * TIMER_COUNT];
+
+    ThreadCounters();
+    ~ThreadCounters();
+
+    void add(int index, uint64_t n) {
+        values[index].store(values[index].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void addTo(Stats& stats) const {
+        for (int i = 0; i < COUNTER_COUNT; i++) stats.counters[i] += values[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            stats.timerCalls[i] += values[COUNTER_COUNT + i].load(std::memory_order_relaxed);
+            stats.timerNanoseconds[i] += values[COUNTER_COUNT + TIMER_COUNT + i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// 所有存活线程的计数器，以及已退出线程留下的累计值
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> live;
+    Stats retired;
+};
+
+// 不析构，线程在静态对象销毁之后退出时仍可访问
+static Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+ThreadCounters::ThreadCounters() {
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) values[i].store(0, std::memory_order_relaxed);
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    addTo(r.retired);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+}
+
+static ThreadCounters& local() {
+    static thread_local ThreadCounters counters;
+    return counters;
+}
+
+Stats collect() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Stats total = r.retired;
+    for (size_t i = 0; i < r.live.size(); i++) r.live[i]->addTo(total);
+    return total;
+}
+
+void reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.clear();
+    for (size_t i = 0; i < r.live.size(); i++) {
+        for (size_t k = 0; k < sizeof(r.live[i]->values) / sizeof(r.live[i]->values[0]); k++) {
+            r.live[i]->values[k].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void add(Counter counter, uint64_t n) {
+    local().add(counter, n);
+}
+
+void addTime(Timer timer, uint64_t nanoseconds) {
+    ThreadCounters& counters = local();
+    counters.add(COUNTER_COUNT + timer, 1);
+    counters.add(COUNTER_COUNT + TIMER_COUNT + timer, nanoseconds);
+}
+
+static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ScopedTimer::ScopedTimer(Timer timer) : timer(timer), start(now()) {}
+
+ScopedTimer::~ScopedTimer() {
+    addTime(timer, static_cast<uint64_t>(now() - start));
+}
+
+} // namespace stats
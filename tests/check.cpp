@@ -0,0 +1,94 @@
+#include "check.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+namespace check {
+
+uint64_t Rng::next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double Rng::uniform(double lo, double hi) {
+    return lo + (hi - lo) * (static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+int Rng::below(int bound) {
+    return static_cast<int>(next() % static_cast<uint64_t>(bound));
+}
+
+bool Context::enabled(const std::string& name) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return false;
+    current = name;
+    printf("check %s\n", name.c_str());
+    fflush(stdout);
+    return true;
+}
+
+bool Context::expect(bool condition, const std::string& detail) {
+    if (condition) return true;
+    failures++;
+    if (reported++ < 20) printf("  FAIL %s: %s\n", current.c_str(), detail.c_str());
+    return false;
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::vector<char> bytes;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) return bytes;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) bytes.insert(bytes.end(), buffer, buffer + count);
+    fclose(file);
+    return bytes;
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) return;
+    if (!bytes.empty()) fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+} // namespace check
+
+static void usage(const char* program) {
+    printf("usage: %s [--filter NAME]\n", program);
+    printf("  运行所有正确性检查，有失败时返回非 0\n");
+}
+
+int main(int argc, char* argv[]) {
+    // 全局线程池至少有 4 个线程，单核机器上也能覆盖并行路径
+    setGlobalThreads(std::max(4, static_cast<int>(std::thread::hardware_concurrency())));
+    check::Context context;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            context.filter = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    check::checkSegments(context);
+    check::checkLines(context);
+    check::checkDelaunay(context);
+    check::checkConvexHull(context);
+    check::checkDynamicHull(context);
+    check::checkPointInPolygon(context);
+    check::checkPointLocator(context);
+    check::checkScanLine(context);
+    check::checkRTree(context);
+    check::checkPointCloud(context);
+    check::checkPolygonAreas(context);
+    check::checkStats(context);
+
+    printf("%d failure(s)\n", context.failures);
+    return context.failures == 0 ? 0 : 1;
+}
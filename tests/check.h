@@ -0,0 +1,62 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 正确性检查：把各接口的结果与暴力算法或逐个调用的结果比较，由 ctest 运行
+// 数据由固定种子生成，失败时输出检查名和出错的输入，便于复现
+namespace check {
+
+// splitmix64 随机数生成器，同一种子在所有平台上生成相同的数据
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state(seed) {}
+
+    uint64_t next();
+    double uniform(double lo, double hi);  // [lo, hi)
+    int below(int bound);                  // [0, bound)
+
+private:
+    uint64_t state;
+};
+
+class Context {
+public:
+    Context() : failures(0), reported(0) {}
+
+    std::string filter;  // 只运行名字包含 filter 的检查
+
+    // 检查是否需要运行，需要时输出检查名，之后的失败都记在这个名字下
+    bool enabled(const std::string& name);
+    // condition 不成立时记录一次失败，前 20 次失败输出 detail
+    bool expect(bool condition, const std::string& detail);
+
+    int failures;
+
+private:
+    std::string current;
+    int reported;
+};
+
+// 整个文件的字节，文件不存在时为空；检查损坏文件时修改其中的字节后写回
+std::vector<char> readFile(const std::string& path);
+void writeFile(const std::string& path, const std::vector<char>& bytes);
+
+void checkSegments(Context& context);
+void checkLines(Context& context);
+void checkDelaunay(Context& context);
+void checkConvexHull(Context& context);
+void checkDynamicHull(Context& context);
+void checkPointInPolygon(Context& context);
+void checkPointLocator(Context& context);
+void checkScanLine(Context& context);
+void checkRTree(Context& context);
+void checkPointCloud(Context& context);
+void checkPolygonAreas(Context& context);
+void checkStats(Context& context);
+
+} // namespace check
+
+#endif // CHECK_H
@@ -0,0 +1,155 @@
+#include "check.h"
+#include "convex_hull.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace check {
+
+// 把凸包的部分边从中点拆开并重复部分顶点，旋转卡壳必须容忍共线点和重复点
+static std::vector<Point> addCollinear(Rng& rng, const std::vector<Point>& hull) {
+    if (hull.size() < 2) return hull;
+    std::vector<Point> result;
+    for (size_t i = 0; i < hull.size(); i++) {
+        const Point& a = hull[i];
+        const Point& b = hull[(i + 1) % hull.size()];
+        result.push_back(a);
+        if (rng.below(2) == 0) result.push_back(Point((a.x + b.x) / 2, (a.y + b.y) / 2));
+        if (rng.below(3) == 0) result.push_back(b);
+    }
+    return result;
+}
+
+// 暴力求出直径、最小宽度和以每条边为底的外接矩形，与旋转卡壳的结果比较
+static void checkCalipers(Context& context, const std::vector<Point>& hull, int trial) {
+    ConvexHull::Calipers calipers = ConvexHull::rotatingCalipers(hull);
+    size_t h = hull.size();
+    double diameter = 0;
+    for (size_t i = 0; i < h; i++) {
+        for (size_t j = 0; j < h; j++) {
+            diameter = std::max(diameter, std::hypot(hull[i].x - hull[j].x, hull[i].y - hull[j].y));
+        }
+    }
+    double width = HUGE_VAL, area = HUGE_VAL, perimeter = HUGE_VAL;
+    bool anyEdge = false;
+    for (size_t i = 0; i < h; i++) {
+        const Point& a = hull[i];
+        const Point& b = hull[(i + 1) % h];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        if (length == 0) continue;
+        anyEdge = true;
+        double ux = (b.x - a.x) / length, uy = (b.y - a.y) / length;
+        double lo = HUGE_VAL, hi = -HUGE_VAL, height = 0;
+        for (size_t k = 0; k < h; k++) {
+            double t = (hull[k].x - a.x) * ux + (hull[k].y - a.y) * uy;
+            lo = std::min(lo, t);
+            hi = std::max(hi, t);
+            height = std::max(height, ux * (hull[k].y - a.y) - uy * (hull[k].x - a.x));
+        }
+        width = std::min(width, height);
+        area = std::min(area, (hi - lo) * height);
+        perimeter = std::min(perimeter, 2 * (hi - lo + height));
+    }
+    if (!anyEdge) width = area = perimeter = 0;
+
+    double tolerance = 1e-9 * (1 + diameter * diameter);
+    std::string where = "trial " + std::to_string(trial);
+    context.expect(std::fabs(calipers.diameter.distance - diameter) <= tolerance, where + ": diameter");
+    context.expect(std::fabs(calipers.width.width - width) <= tolerance, where + ": width");
+    context.expect(std::fabs(calipers.minArea.area - area) <= tolerance, where + ": min-area rectangle");
+    context.expect(std::fabs(calipers.minPerimeter.perimeter - perimeter) <= tolerance, where + ": min-perimeter rectangle");
+
+    // 两种矩形都要包含所有顶点
+    const ConvexHull::EnclosingRectangle* rectangles[] = {&calipers.minArea, &calipers.minPerimeter};
+    for (int r = 0; r < 2; r++) {
+        bool inside = true;
+        for (size_t k = 0; k < h; k++) {
+            for (int c = 0; c < 4; c++) {
+                const Point& a = rectangles[r]->corners[c];
+                const Point& b = rectangles[r]->corners[(c + 1) % 4];
+                double cross = (b.x - a.x) * (hull[k].y - a.y) - (b.y - a.y) * (hull[k].x - a.x);
+                if (cross < -1e-6 * (1 + diameter)) inside = false;
+            }
+        }
+        context.expect(inside, where + ": rectangle does not contain the hull");
+    }
+}
+
+// n 个点中凸包恰好有 h 个顶点（正多边形），其余点在内部
+static std::vector<Point> polygonWithInterior(Rng& rng, size_t n, size_t h) {
+    std::vector<Point> points;
+    for (size_t i = 0; i < h; i++) {
+        double angle = 2 * M_PI * i / h;
+        points.push_back(Point(1000 * std::cos(angle), 1000 * std::sin(angle)));
+    }
+    while (points.size() < n) points.push_back(Point(rng.uniform(-300, 300), rng.uniform(-300, 300)));
+    for (size_t i = points.size(); i > 1; i--) std::swap(points[i - 1], points[rng.below(static_cast<int>(i))]);
+    return points;
+}
+
+static bool sameHull(const std::vector<Point>& a, const std::vector<Point>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y) return false;
+    }
+    return true;
+}
+
+// 输出敏感模式与默认模式结果相同，凸包顶点数在 ceil(log2 n) 附近时也一样
+// 常量输入的重载结果相同，preserveInput 为 false 时也不修改输入
+static void checkOutputSensitive(Context& context, Rng& rng) {
+    const size_t sizes[] = {4, 16, 17, 64, 1000, 5000};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        size_t budget = 1;
+        while ((static_cast<size_t>(1) << budget) < n) ++budget;
+        for (size_t h = std::max<size_t>(3, budget - 1); h <= std::min(n, budget + 1); h++) {
+            std::vector<Point> points = polygonWithInterior(rng, n, h);
+            ConvexHull::Options options;
+            std::vector<Point> expected = ConvexHull::compute(points, options);
+            options.outputSensitive = true;
+            std::vector<Point> hull = ConvexHull::compute(points, options);
+            std::string where = "n = " + std::to_string(n) + ", h = " + std::to_string(h);
+            context.expect(hull.size() == h && sameHull(hull, expected), where);
+
+            const std::vector<Point> input(points);
+            for (int mode = 0; mode < 4; mode++) {
+                options.outputSensitive = mode % 2 == 1;
+                options.preserveInput = mode < 2;
+                context.expect(sameHull(ConvexHull::compute(input, options), expected) && sameHull(input, points),
+                               where + ", const input, mode " + std::to_string(mode));
+            }
+            context.expect(sameHull(ConvexHull::compute(std::vector<Point>(points)), expected), where + ", temporary input");
+        }
+    }
+}
+
+void checkConvexHull(Context& context) {
+    Rng rng(5);
+    if (context.enabled("ConvexHull::compute output-sensitive")) checkOutputSensitive(context, rng);
+    if (context.enabled("ConvexHull::rotatingCalipers")) {
+        for (int trial = 0; trial < 1500; trial++) {
+            int mode = trial % 3;
+            int n = 1 + rng.below(40);
+            std::vector<Point> points;
+            for (int i = 0; i < n; i++) {
+                if (mode == 0) points.push_back(Point(rng.uniform(-100, 100), rng.uniform(-100, 100), i));
+                else if (mode == 1) points.push_back(Point(rng.below(4), rng.below(4), i));
+                else points.push_back(Point(rng.below(50), rng.below(50), i));
+            }
+            std::vector<Point> hull = ConvexHull::compute(points);
+            if (trial % 2 == 1) hull = addCollinear(rng, hull);
+            checkCalipers(context, hull, trial);
+        }
+        bool threw = false;
+        try {
+            ConvexHull::diameter(std::vector<Point>());
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        context.expect(threw, "empty hull did not throw");
+    }
+}
+
+} // namespace check
@@ -0,0 +1,208 @@
+#include "check.h"
+#include "delaunay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace check {
+
+typedef std::set<std::pair<int, int>> EdgeSet;
+
+static EdgeSet normalize(const std::vector<std::pair<int, int>>& edges) {
+    EdgeSet result;
+    for (size_t i = 0; i < edges.size(); i++) {
+        result.insert(std::make_pair(std::min(edges[i].first, edges[i].second),
+                                     std::max(edges[i].first, edges[i].second)));
+    }
+    return result;
+}
+
+// 一次性构建的剖分，points 中没有重合的点
+static EdgeSet rebuild(const std::vector<Point>& points) {
+    std::vector<Point> copy(points);
+    Delaunay delaunay;
+    delaunay.init(static_cast<int>(copy.size()), copy.data());
+    return normalize(delaunay.getEdge());
+}
+
+// 增量插入、删除后的剖分与对剩余点重新构建的结果相同
+// 网格上的点有大量共圆的四点组，重新构建与增量更新只有在选择一致时才相同，因此只用一般位置的点
+static void checkIncremental(Context& context, Rng& rng, int n) {
+    std::vector<Point> points;
+    for (int i = 0; i < n; i++) points.push_back(Point(rng.uniform(0, 1000), rng.uniform(0, 1000), i));
+
+    Delaunay delaunay;
+    std::vector<Point> seed(points.begin(), points.begin() + 3);
+    delaunay.init(3, seed.data());
+    for (int i = 3; i < n; i++) delaunay.insert(points[i]);
+    context.expect(normalize(delaunay.getEdge()) == rebuild(points), "insert " + std::to_string(n) + " points");
+
+    std::vector<Point> order(points);
+    for (size_t i = order.size(); i > 1; i--) std::swap(order[i - 1], order[rng.below(static_cast<int>(i))]);
+    size_t removed = order.size() / 2;
+    bool removedAll = true;
+    for (size_t i = 0; i < removed; i++) removedAll = delaunay.remove(order[i].id) && removedAll;
+    context.expect(removedAll, "remove reported a missing id");
+    context.expect(!delaunay.remove(order[0].id), "removing a point twice succeeded");
+    std::vector<Point> left(order.begin() + removed, order.end());
+    context.expect(normalize(delaunay.getEdge()) == rebuild(left),
+                   "remove " + std::to_string(removed) + " of " + std::to_string(n) + " points");
+
+    for (size_t i = 0; i < removed; i++) delaunay.insert(order[i]);
+    context.expect(normalize(delaunay.getEdge()) == rebuild(points), "reinsert " + std::to_string(removed) + " points");
+}
+
+// 多线程分治的结果与单线程完全相同，threads 只限制同时运行的子问题数
+static void checkParallel(Context& context, Rng& rng) {
+    std::vector<Point> points;
+    for (int i = 0; i < 5000; i++) points.push_back(Point(rng.below(300), rng.uniform(0, 300), i));
+    Delaunay serial;
+    serial.init(points, 1);
+    std::vector<std::array<int, 3>> expected = serial.getTriangle();
+    const int threads[] = {2, 3, 0};
+    for (int k = 0; k < 3; k++) {
+        Delaunay parallel;
+        parallel.init(points, threads[k], 64);
+        context.expect(parallel.getTriangle() == expected, "threads = " + std::to_string(threads[k]));
+    }
+}
+
+// mode 0 为一般位置的点，mode 1 为有重合点和大量共圆四点组的网格，mode 2 为共线的点
+static std::vector<Point> randomSites(Rng& rng, int mode, int n) {
+    std::vector<Point> points;
+    for (int i = 0; i < n; i++) {
+        if (mode == 0) points.push_back(Point(rng.uniform(0, 1000), rng.uniform(0, 1000), i));
+        if (mode == 1) points.push_back(Point(rng.below(40) * 25, rng.below(40) * 25, i));
+        if (mode == 2) {
+            double t = rng.below(1000);
+            points.push_back(Point(t, 0.5 * t + 100, i));
+        }
+    }
+    return points;
+}
+
+static double nearestDistance2(const std::vector<Point>& points, const Point& q) {
+    double best = HUGE_VAL;
+    for (size_t i = 0; i < points.size(); i++) best = std::min(best, points[i].dist2(q));
+    return best;
+}
+
+// 单个与批量最近点查询返回的点与线性扫描得到的最近距离相同，查询点有一半落在凸包以外
+static void checkNearest(Context& context, Rng& rng, int mode, int n) {
+    std::vector<Point> points = randomSites(rng, mode, n);
+    Delaunay delaunay;
+    delaunay.init(points);
+    std::vector<Point> queries;
+    for (int i = 0; i < 3000; i++) {
+        double range = i % 2 == 0 ? 1 : 3;
+        queries.push_back(Point(rng.uniform(500 - 500 * range, 500 + 500 * range),
+                                rng.uniform(500 - 500 * range, 500 + 500 * range)));
+    }
+    std::string where = "mode " + std::to_string(mode) + " n " + std::to_string(n);
+
+    const int threads[] = {1, 3, 0};
+    for (int k = 0; k < 3; k++) {
+        std::vector<int> ids(queries.size(), -2);
+        delaunay.nearest(PointView(queries), ids.data(), threads[k]);
+        size_t wrong = 0;
+        for (size_t i = 0; i < queries.size(); i++) {
+            if (ids[i] < 0 || ids[i] >= n || points[ids[i]].dist2(queries[i]) != nearestDistance2(points, queries[i])) {
+                wrong++;
+            }
+        }
+        context.expect(wrong == 0, where + " threads " + std::to_string(threads[k]) + ": " + std::to_string(wrong) +
+                                       " wrong batch nearest results");
+    }
+
+    size_t wrong = 0;
+    int hint = -1;
+    for (size_t i = 0; i < 300; i++) {
+        int id = delaunay.nearest(queries[i], hint);
+        if (id < 0 || id >= n || points[id].dist2(queries[i]) != nearestDistance2(points, queries[i])) wrong++;
+        hint = i % 5 == 0 ? rng.below(n) : id;
+    }
+    context.expect(wrong == 0, where + ": " + std::to_string(wrong) + " wrong single nearest results");
+}
+
+// 裁剪后的 Voronoi 单元面积之和等于矩形面积，单元内部的点离 site[i] 最近
+static void checkVoronoi(Context& context, Rng& rng, int mode, int n) {
+    std::vector<Point> points = randomSites(rng, mode, n);
+    Delaunay delaunay;
+    delaunay.init(points);
+    // 包含所有点的矩形，以及从中间截断点集的矩形
+    const double rects[2][4] = {{-200, -150, 1300, 1100}, {210, 330, 770, 640}};
+    for (int r = 0; r < 2; r++) {
+        const double* rect = rects[r];
+        std::string where = "mode " + std::to_string(mode) + " n " + std::to_string(n) + " rectangle " + std::to_string(r);
+        Delaunay::Voronoi voronoi;
+        delaunay.getVoronoi(voronoi, rect[0], rect[1], rect[2], rect[3]);
+        context.expect(voronoi.site.size() == static_cast<size_t>(n) && voronoi.offsets.size() == voronoi.site.size() + 1,
+                       where + ": " + std::to_string(voronoi.site.size()) + " cells");
+        if (voronoi.offsets.size() != voronoi.site.size() + 1) continue;
+
+        double total = 0;
+        size_t negative = 0, misplaced = 0;
+        for (size_t i = 0; i < voronoi.site.size(); i++) {
+            size_t begin = voronoi.offsets[i], end = voronoi.offsets[i + 1];
+            double area = 0, cx = 0, cy = 0;
+            for (size_t j = begin; j < end; j++) {
+                size_t k = j + 1 < end ? j + 1 : begin;
+                area += voronoi.x[j] * voronoi.y[k] - voronoi.x[k] * voronoi.y[j];
+                cx += voronoi.x[j];
+                cy += voronoi.y[j];
+            }
+            area /= 2;
+            total += area;
+            if (area < 0) negative++;
+            if (end - begin < 3 || area < 1e-6) continue;
+
+            // 顶点的平均值及其与随机顶点的凸组合都在单元内部
+            cx /= end - begin;
+            cy /= end - begin;
+            const Point& site = points[voronoi.site[i]];
+            for (int k = 0; k < 4; k++) {
+                Point q(cx, cy);
+                if (k > 0) {
+                    size_t j = begin + rng.below(static_cast<int>(end - begin));
+                    double t = rng.uniform(0, 0.9);
+                    q = Point(cx + t * (voronoi.x[j] - cx), cy + t * (voronoi.y[j] - cy));
+                }
+                if (site.dist2(q) > nearestDistance2(points, q) * (1 + 1e-9) + 1e-9) misplaced++;
+            }
+        }
+        double expected = (rect[2] - rect[0]) * (rect[3] - rect[1]);
+        context.expect(std::fabs(total - expected) <= 1e-9 * expected,
+                       where + ": cell areas sum to " + std::to_string(total) + ", expected " + std::to_string(expected));
+        context.expect(negative == 0, where + ": " + std::to_string(negative) + " clockwise cells");
+        context.expect(misplaced == 0, where + ": " + std::to_string(misplaced) + " samples closer to another site");
+    }
+}
+
+void checkDelaunay(Context& context) {
+    Rng rng(7);
+    if (context.enabled("Delaunay insert/remove")) {
+        for (int n = 4; n <= 64; n *= 2) {
+            for (int trial = 0; trial < 10; trial++) checkIncremental(context, rng, n);
+        }
+        checkIncremental(context, rng, 3000);
+    }
+    if (context.enabled("Delaunay parallel init")) checkParallel(context, rng);
+    if (context.enabled("Delaunay nearest")) {
+        for (int mode = 0; mode < 3; mode++) {
+            checkNearest(context, rng, mode, 1);
+            checkNearest(context, rng, mode, 30);
+            checkNearest(context, rng, mode, 2000);
+        }
+    }
+    if (context.enabled("Delaunay Voronoi")) {
+        for (int mode = 0; mode < 3; mode++) {
+            checkVoronoi(context, rng, mode, 1);
+            checkVoronoi(context, rng, mode, 40);
+            checkVoronoi(context, rng, mode, 1500);
+        }
+    }
+}
+
+} // namespace check
@@ -0,0 +1,144 @@
+#include "check.h"
+#include "DynamicHull.h"
+#include "convex_hull.h"
+#include "predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
+namespace check {
+
+// 小整数网格上的点，重复点、同一 x 上的点和共线点都很多
+// mode 1 的点在斜率为 1/3 的几条直线附近，y 经过舍入，相邻边舍入后的斜率常与 1/3 相同或顺序颠倒，
+// Chain::extreme 按斜率索引找到的顶点需要局部检查纠正
+static Point randomHullPoint(Rng& rng, int mode, int grid) {
+    if (mode == 0) return Point(rng.below(grid), rng.below(grid));
+    double x = rng.below(1 << 26);
+    return Point(x, rng.below(3) + x / 3.0);
+}
+
+// 凸包内或边界上，hull 为 ConvexHull::compute 的结果
+static bool hullContains(const std::vector<Point>& hull, const Point& q) {
+    if (hull.empty()) return false;
+    if (hull.size() == 1) return hull[0].x == q.x && hull[0].y == q.y;
+    if (hull.size() == 2) {
+        const Point& a = hull[0];
+        const Point& b = hull[1];
+        return predicates::orient2d(a, b, q) == 0 && std::min(a.x, b.x) <= q.x && q.x <= std::max(a.x, b.x) &&
+               std::min(a.y, b.y) <= q.y && q.y <= std::max(a.y, b.y);
+    }
+    for (size_t i = 0; i < hull.size(); i++) {
+        if (predicates::orient2d(hull[i], hull[(i + 1) % hull.size()], q) < 0) return false;
+    }
+    return true;
+}
+
+static bool sameVertices(const std::vector<Point>& a, const std::vector<Point>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y) return false;
+    }
+    return true;
+}
+
+// 把 vertices、contains、extreme 与 ConvexHull::compute 的结果比较，Hull 为 DynamicHull 或 SlidingWindowHull
+template <typename Hull>
+static void compareHull(Context& context, const Hull& hull, std::vector<Point> points, Rng& rng, int mode, int grid,
+                        const std::string& where) {
+    std::vector<Point> expected = ConvexHull::compute(points);
+    context.expect(sameVertices(hull.vertices(), expected),
+                   where + ": " + std::to_string(hull.vertices().size()) + " vertices, expected " +
+                       std::to_string(expected.size()));
+
+    for (int k = 0; k < 8; k++) {
+        Point q = mode == 0 ? Point(rng.below(grid + 2) - 1, rng.below(grid + 2) - 1) : randomHullPoint(rng, mode, grid);
+        if (!points.empty() && k == 0) q = points[rng.below(static_cast<int>(points.size()))];
+        context.expect(hull.contains(q) == hullContains(expected, q),
+                       where + ": contains(" + std::to_string(q.x) + ", " + std::to_string(q.y) + ")");
+    }
+
+    for (int k = 0; k < 6; k++) {
+        // 整数方向与凸包边的斜率常常相同，另取与 mode 1 直线垂直的方向和一个一般方向
+        double dx = rng.below(7) - 3, dy = rng.below(7) - 3;
+        if (k == 4) {
+            dx = rng.below(2) == 0 ? -1 : 1;
+            dy = -3 * dx;
+        } else if (k == 5) {
+            dx = rng.uniform(-1, 1);
+            dy = rng.uniform(-1, 1);
+        }
+        if (dx == 0 && dy == 0) continue;
+        if (points.empty()) {
+            bool threw = false;
+            try {
+                hull.extreme(dx, dy);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            context.expect(threw, where + ": extreme on an empty hull does not throw");
+            continue;
+        }
+        double best = -HUGE_VAL;
+        for (size_t i = 0; i < points.size(); i++) best = std::max(best, dx * points[i].x + dy * points[i].y);
+        Point e = hull.extreme(dx, dy);
+        context.expect(dx * e.x + dy * e.y == best && hullContains(expected, e),
+                       where + ": extreme(" + std::to_string(dx) + ", " + std::to_string(dy) + ")");
+    }
+}
+
+void checkDynamicHull(Context& context) {
+    Rng rng(20);
+    if (context.enabled("DynamicHull")) {
+        const int grids[] = {2, 4, 12};
+        for (int trial = 0; trial < 120; trial++) {
+            int mode = trial % 4 == 3 ? 1 : 0;
+            int grid = grids[trial % 3];
+            DynamicHull hull;
+            std::vector<Point> points;
+            int n = 1 + rng.below(60);
+            for (int i = 0; i < n; i++) {
+                Point p = randomHullPoint(rng, mode, grid);
+                p.id = i;
+                hull.insert(p);
+                points.push_back(p);
+                compareHull(context, hull, points, rng, mode, grid,
+                            "trial " + std::to_string(trial) + " insert " + std::to_string(i));
+            }
+            context.expect(hull.size() == ConvexHull::compute(points).size(), "trial " + std::to_string(trial) + ": size");
+        }
+    }
+
+    // 窗口删除点时撤销 front 的插入记录，删到空再重新填满，反复经过两个栈之间的搬移
+    if (context.enabled("SlidingWindowHull")) {
+        const int grids[] = {3, 5, 12};
+        for (int trial = 0; trial < 90; trial++) {
+            int mode = trial % 5 == 4 ? 1 : 0;
+            int grid = grids[trial % 3];
+            size_t capacity = trial % 2 == 0 ? 0 : 1 + rng.below(12);
+            SlidingWindowHull hull(capacity);
+            std::deque<Point> window;
+            for (int step = 0; step < 120; step++) {
+                std::string where = "trial " + std::to_string(trial) + " step " + std::to_string(step);
+                if (capacity == 0 && rng.below(10) < 4) {
+                    hull.popOldest();
+                    if (!window.empty()) window.pop_front();
+                } else {
+                    Point p = randomHullPoint(rng, mode, grid);
+                    p.id = step;
+                    hull.push(p);
+                    window.push_back(p);
+                    if (capacity > 0 && window.size() > capacity) window.pop_front();
+                }
+                context.expect(hull.windowSize() == window.size(), where + ": window size");
+                if (!window.empty()) {
+                    context.expect(hull.oldest().id == window.front().id, where + ": oldest point");
+                }
+                compareHull(context, hull, std::vector<Point>(window.begin(), window.end()), rng, mode, grid, where);
+            }
+        }
+    }
+}
+
+} // namespace check
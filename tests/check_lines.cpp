@@ -0,0 +1,134 @@
+#include "check.h"
+#include "findIntersection.h"
+#include "point_line.h"
+
+#include <cmath>
+#include <vector>
+
+namespace check {
+
+// 扩展欧几里得：u * a + w * b = gcd(a, b)
+static int64_t extendedGcd(int64_t a, int64_t b, int64_t& u, int64_t& w) {
+    if (b == 0) {
+        u = 1;
+        w = 0;
+        return a;
+    }
+    int64_t u1, w1;
+    int64_t g = extendedGcd(b, a % b, u1, w1);
+    u = w1;
+    w = u1 - (a / b) * w1;
+    return g;
+}
+
+// 互质的 (x, y) 与 (a, b)，a * y - b * x = 1；分量约为 2^40，乘积远超 double 的精度
+static void unimodularPair(Rng& rng, int64_t& x, int64_t& y, int64_t& a, int64_t& b) {
+    int64_t u, w;
+    do {
+        x = static_cast<int64_t>(rng.next() >> 24) + 1;
+        y = static_cast<int64_t>(rng.next() >> 24) + 1;
+    } while (extendedGcd(y, x, u, w) != 1);
+    a = u;
+    b = -w;
+}
+
+// 点到直线的叉积恰好为 -1、0 或 1，浮点运算的误差远大于叉积本身，只有精确谓词能给出正确的符号
+static void checkPointLine(Context& context, Rng& rng) {
+    for (int trial = 0; trial < 20; trial++) {
+        int64_t vx, vy, a, b;
+        unimodularPair(rng, vx, vy, a, b);
+        int64_t px = static_cast<int64_t>(rng.next() >> 16), py = static_cast<int64_t>(rng.next() >> 16);
+        Point P(static_cast<double>(px), static_cast<double>(py));
+        Vector v = {static_cast<double>(vx), static_cast<double>(vy)};
+
+        const size_t n = 1000;
+        std::vector<double> xs(n), ys(n);
+        std::vector<int> expected(n);
+        for (size_t i = 0; i < n; i++) {
+            int64_t t = rng.below(9) - 4, s = rng.below(3) - 1;
+            xs[i] = static_cast<double>(px + t * vx + s * a);
+            ys[i] = static_cast<double>(py + t * vy + s * b);
+            expected[i] = static_cast<int>(s);
+        }
+        std::vector<int8_t> signs(n), parallelSigns(n);
+        classifyPositions(xs.data(), ys.data(), n, P, v, signs.data());
+        classifyPositions(xs.data(), ys.data(), n, P, v, parallelSigns.data(), 0, 0);
+        std::vector<uint64_t> above((n + 63) / 64), below((n + 63) / 64);
+        classifyPositionsMask(xs.data(), ys.data(), n, P, v, above.data(), below.data());
+        for (size_t i = 0; i < n; i++) {
+            double cross = crossProduct(P, Point(xs[i], ys[i]), v);
+            int sign = (cross > 0) - (cross < 0);
+            int masked = static_cast<int>((above[i / 64] >> (i % 64)) & 1) - static_cast<int>((below[i / 64] >> (i % 64)) & 1);
+            context.expect(sign == expected[i] && signs[i] == expected[i] && parallelSigns[i] == expected[i] &&
+                               masked == expected[i],
+                           "trial " + std::to_string(trial) + ", point " + std::to_string(i) + ": expected " +
+                               std::to_string(expected[i]) + ", crossProduct " + std::to_string(sign) +
+                               ", batch " + std::to_string(signs[i]));
+        }
+
+        // 带阈值时批量接口与逐个比较 crossProduct 的结果相同
+        double tolerance = std::fabs(v.x) * 0.5;
+        for (size_t i = 0; i < n; i++) {
+            xs[i] = P.x + rng.uniform(-4, 4) * v.x;
+            ys[i] = P.y + rng.uniform(-4, 4) * v.y;
+        }
+        classifyPositions(xs.data(), ys.data(), n, P, v, signs.data(), tolerance);
+        for (size_t i = 0; i < n; i++) {
+            double cross = crossProduct(P, Point(xs[i], ys[i]), v);
+            int sign = (cross > tolerance) - (cross < -tolerance);
+            context.expect(signs[i] == sign, "tolerance, trial " + std::to_string(trial) + ", point " + std::to_string(i));
+        }
+    }
+}
+
+// 直线对的行列式恰好为 0 或 ±1，平行、重合与相交的判断不受系数量级影响
+static void checkLineIntersection(Context& context, Rng& rng) {
+    const size_t n = 1001;
+    std::vector<double> A1(n), B1(n), C1(n), A2(n), B2(n), C2(n);
+    std::vector<int> expected(n);
+    for (size_t i = 0; i < n; i++) {
+        int64_t x, y, a, b;
+        unimodularPair(rng, x, y, a, b);
+        double scale = i % 2 == 0 ? 1.0 : 1.0 / 1099511627776.0;  // 2^-40，缩放不改变行列式是否为 0
+        A1[i] = static_cast<double>(x) * scale;
+        B1[i] = static_cast<double>(y) * scale;
+        C1[i] = static_cast<double>(rng.below(1000)) * scale;
+        int kind = rng.below(3);
+        if (kind == 0) {
+            A2[i] = static_cast<double>(a) * scale;
+            B2[i] = static_cast<double>(b) * scale;
+            C2[i] = static_cast<double>(rng.below(1000)) * scale;
+            expected[i] = UniqueIntersection;
+        } else {
+            A2[i] = 3 * A1[i];
+            B2[i] = 3 * B1[i];
+            C2[i] = kind == 1 ? 3 * C1[i] : 3 * C1[i] + scale;
+            expected[i] = kind == 1 ? CoincidentLines : ParallelLines;
+        }
+    }
+    std::vector<double> x(n), y(n);
+    std::vector<uint8_t> status(n), parallelStatus(n);
+    findIntersections(A1.data(), B1.data(), C1.data(), A2.data(), B2.data(), C2.data(), n, x.data(), y.data(),
+                      status.data());
+    std::vector<double> px(n), py(n);
+    findIntersections(A1.data(), B1.data(), C1.data(), A2.data(), B2.data(), C2.data(), n, px.data(), py.data(),
+                      parallelStatus.data(), 0);
+    for (size_t i = 0; i < n; i++) {
+        Point p;
+        int relation = intersectLines(A1[i], B1[i], C1[i], A2[i], B2[i], C2[i], p);
+        bool same = status[i] == relation && parallelStatus[i] == relation &&
+                    (relation != UniqueIntersection || (x[i] == p.x && y[i] == p.y && px[i] == p.x && py[i] == p.y));
+        context.expect(relation == expected[i] && same, "line pair " + std::to_string(i) + ": expected " +
+                                                             std::to_string(expected[i]) + ", got " +
+                                                             std::to_string(relation) + ", batch " +
+                                                             std::to_string(status[i]));
+    }
+}
+
+void checkLines(Context& context) {
+    Rng rng(17);
+    if (context.enabled("classifyPositions")) checkPointLine(context, rng);
+    if (context.enabled("findIntersections")) checkLineIntersection(context, rng);
+}
+
+} // namespace check
@@ -0,0 +1,172 @@
+#include "check.h"
+#include "PointCloud.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace check {
+
+// 视图中的坐标和 id 与 points 逐个相同
+static bool sameView(const PointView& view, const std::vector<Point>& points, size_t first, bool withIds) {
+    for (size_t i = 0; i < view.size(); i++) {
+        const Point& p = points[first + i];
+        int id = withIds ? p.id : static_cast<int>(first + i);
+        if (view.x(i) != p.x || view.y(i) != p.y || view.id(i) != id) return false;
+    }
+    return true;
+}
+
+// 写入后映射回来，坐标、id、包围盒与原始点相同；分块访问按顺序覆盖所有点，释放处理过的块后数据仍然可读
+static void checkRoundTrip(Context& context, Rng& rng, const std::string& path, size_t n, bool withIds) {
+    std::string where = "n " + std::to_string(n) + (withIds ? " with ids" : " without ids");
+    std::vector<Point> points(n);
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for (size_t i = 0; i < n; i++) {
+        points[i] = Point(rng.uniform(-1e6, 1e6), rng.uniform(5e6, 6e6), rng.below(1 << 30) - (1 << 29));
+        minX = std::min(minX, points[i].x);
+        maxX = std::max(maxX, points[i].x);
+        minY = std::min(minY, points[i].y);
+        maxY = std::max(maxY, points[i].y);
+    }
+    PointCloud::write(path, PointView(points), withIds);
+
+    PointCloud::MappedFile file(path);
+    const PointCloud::Header& header = file.header();
+    context.expect(file.size() == n && file.hasIds() == withIds, where + ": size or id column");
+    context.expect(header.minX == minX && header.minY == minY && header.maxX == maxX && header.maxY == maxY,
+                   where + ": bounding box");
+    context.expect(header.xOffset % 4096 == 0 && header.yOffset % 4096 == 0 && header.idOffset % 4096 == 0,
+                   where + ": column alignment");
+    context.expect(file.view().size() == n && sameView(file.view(), points, 0, withIds), where + ": view");
+    size_t first = n / 3;
+    context.expect(file.view(first, n).size() == n - first && sameView(file.view(first, n), points, first, withIds),
+                   where + ": view(" + std::to_string(first) + ", n)");
+
+    const size_t chunkSizes[] = {1, 7, 512, 4096, n + 3};
+    for (int c = 0; c < 5; c++) {
+        for (int release = 0; release < 2; release++) {
+            size_t chunk = chunkSizes[c];
+            if (chunk == 1 && n > 2000) continue;
+            size_t next = 0;
+            bool ok = true;
+            file.forEachChunk(chunk, [&](const PointView& view, size_t start) {
+                ok = ok && start == next && view.size() > 0 && view.size() <= chunk &&
+                     sameView(view, points, start, withIds);
+                next = start + view.size();
+            }, release == 1);
+            context.expect(ok && next == n, where + ": forEachChunk(" + std::to_string(chunk) + ", " +
+                                                (release == 1 ? "release" : "keep") + ")");
+        }
+    }
+    // 释放的页从页缓存重新映射，内容不变
+    context.expect(sameView(file.view(), points, 0, withIds), where + ": view after releasing chunks");
+
+    bool threw = false;
+    try {
+        file.forEachChunk(0, [](const PointView&, size_t) {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    context.expect(threw, where + ": chunk size 0 does not throw");
+
+    PointCloud::MappedFile moved(std::move(file));
+    context.expect(!file.isOpen() && moved.isOpen() && moved.size() == n, where + ": move");
+}
+
+template <typename T>
+static void patch(std::vector<char>& bytes, size_t offset, T value) {
+    memcpy(&bytes[offset], &value, sizeof(value));
+}
+
+// 损坏的文件必须抛出 std::runtime_error，不能越界读取列
+static void checkHostileFiles(Context& context, const std::string& path) {
+    std::vector<Point> points;
+    for (int i = 0; i < 1000; i++) points.push_back(Point(i, -i, i));
+    PointCloud::write(path, PointView(points), true);
+    const std::vector<char> original = readFile(path);
+    PointCloud::Header header;
+    memcpy(&header, original.data(), sizeof(header));
+
+    std::vector<std::pair<std::string, std::vector<char>>> cases;
+    std::vector<char> bytes = original;
+    bytes[0] = 'X';
+    cases.push_back(std::make_pair("bad magic", bytes));
+    bytes = original;
+    patch<uint32_t>(bytes, offsetof(PointCloud::Header, version), PointCloud::FORMAT_VERSION + 1);
+    cases.push_back(std::make_pair("newer version", bytes));
+    bytes = original;
+    patch<uint32_t>(bytes, offsetof(PointCloud::Header, version), 0);
+    cases.push_back(std::make_pair("version 0", bytes));
+    bytes = original;
+    bytes.resize(sizeof(PointCloud::Header) - 1);
+    cases.push_back(std::make_pair("short header", bytes));
+    bytes = original;
+    bytes.pop_back();
+    cases.push_back(std::make_pair("truncated id column", bytes));
+    bytes = original;
+    bytes.resize(header.yOffset + 8 * 500);
+    cases.push_back(std::make_pair("truncated y column", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, count), 1001);
+    cases.push_back(std::make_pair("count beyond the columns", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, count), 1ull << 40);
+    cases.push_back(std::make_pair("huge count", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, xOffset), original.size() + 4096);
+    cases.push_back(std::make_pair("x column past the end", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, yOffset), ~0ull - 7);
+    cases.push_back(std::make_pair("overflowing y offset", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, xOffset), header.xOffset + 4);
+    cases.push_back(std::make_pair("misaligned x column", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, xOffset), 64);
+    cases.push_back(std::make_pair("x column inside the header", bytes));
+    bytes = original;
+    patch<uint64_t>(bytes, offsetof(PointCloud::Header, idOffset), 0);
+    cases.push_back(std::make_pair("id flag without an id column", bytes));
+
+    for (size_t i = 0; i < cases.size(); i++) {
+        writeFile(path, cases[i].second);
+        bool rejected = false;
+        try {
+            PointCloud::MappedFile file(path);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        context.expect(rejected, "hostile file accepted: " + cases[i].first);
+    }
+
+    bool rejected = false;
+    try {
+        PointCloud::MappedFile file(path + ".missing");
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    context.expect(rejected, "missing file accepted");
+
+    writeFile(path, original);
+    PointCloud::MappedFile file(path);
+    context.expect(file.size() == points.size() && sameView(file.view(), points, 0, true), "unmodified file rejected");
+}
+
+void checkPointCloud(Context& context) {
+    if (!context.enabled("PointCloud")) return;
+    Rng rng(17);
+    const std::string path = "check_point_cloud.bin";
+    const size_t sizes[] = {0, 1, 511, 513, 20000};
+    for (int s = 0; s < 5; s++) {
+        checkRoundTrip(context, rng, path, sizes[s], true);
+        checkRoundTrip(context, rng, path, sizes[s], false);
+    }
+    checkHostileFiles(context, path);
+    remove(path.c_str());
+}
+
+} // namespace check
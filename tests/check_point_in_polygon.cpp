@@ -0,0 +1,148 @@
+#include "check.h"
+#include "PointInPolygon.h"
+#include "convex_hull.h"
+#include "predicates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace check {
+
+using PointInPolygon::ConvexPolygon;
+using PointInPolygon::PointLocation;
+
+static bool onSegment(const Point& p, const Point& a, const Point& b) {
+    return predicates::orient2d(a, b, p) == 0 && std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+           std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+static bool onBoundary(const Point& p, const std::vector<Point>& polygon) {
+    for (size_t i = 0; i < polygon.size(); i++) {
+        if (onSegment(p, polygon[i], polygon[(i + 1) % polygon.size()])) return true;
+    }
+    return false;
+}
+
+// 凸包加上边的中点和重复顶点，随机旋转起点和反转方向
+static std::vector<Point> convexPolygon(Rng& rng, int trial) {
+    int range = trial % 3 == 0 ? 4 : 12;
+    int n = 3 + rng.below(20);
+    std::vector<Point> points;
+    for (int i = 0; i < n; i++) points.push_back(Point(rng.below(range + 1), rng.below(range + 1)));
+    std::vector<Point> hull = ConvexHull::compute(points);
+    std::vector<Point> polygon;
+    for (size_t i = 0; i < hull.size(); i++) {
+        const Point& a = hull[i];
+        const Point& b = hull[(i + 1) % hull.size()];
+        polygon.push_back(a);
+        if (hull.size() >= 2 && rng.below(2) == 0) polygon.push_back(Point((a.x + b.x) / 2, (a.y + b.y) / 2));
+        if (hull.size() >= 2 && rng.below(4) == 0) polygon.push_back(b);
+    }
+    if (trial % 4 == 3) std::reverse(polygon.begin(), polygon.end());
+    if (!polygon.empty()) std::rotate(polygon.begin(), polygon.begin() + rng.below(static_cast<int>(polygon.size())), polygon.end());
+    return polygon;
+}
+
+static void checkConvexPolygon(Context& context, Rng& rng) {
+    for (int trial = 0; trial < 2000; trial++) {
+        std::vector<Point> polygon = convexPolygon(rng, trial);
+        if (!context.expect(ConvexPolygon::isConvex(polygon), "trial " + std::to_string(trial) + ": rejected a convex polygon")) {
+            continue;
+        }
+        ConvexPolygon convex(polygon);
+        // 面积为 0 时（所有顶点共线）只有线段上的点算在边界上
+        bool degenerate = convex.size() < 3;
+        for (int q = 0; q < 50; q++) {
+            Point p(rng.below(15) - 1 + (q % 3 == 0 ? 0.5 : 0), rng.below(15) - 1);
+            PointLocation expected = PointInPolygon::Outside;
+            if (onBoundary(p, polygon)) expected = PointInPolygon::OnBoundary;
+            else if (!degenerate && PointInPolygon::isPointInPolygonRayCasting(p, polygon)) expected = PointInPolygon::Inside;
+            context.expect(convex.locate(p) == expected, "trial " + std::to_string(trial) + ": query (" +
+                                                             std::to_string(p.x) + ", " + std::to_string(p.y) + ")");
+        }
+    }
+
+    // 非凸、自交和来回折返的多边形都应被拒绝
+    std::vector<Point> star;
+    for (int k = 0; k < 5; k++) {
+        double angle = 2 * M_PI * (2 * k) / 5;
+        star.push_back(Point(std::cos(angle), std::sin(angle)));
+    }
+    context.expect(!ConvexPolygon::isConvex(star), "accepted a pentagram");
+    std::vector<Point> spike = {{0, 0}, {2, 0}, {1, 0}, {1, 1}};
+    context.expect(!ConvexPolygon::isConvex(spike), "accepted a collinear reversal");
+    std::vector<Point> dent = {{0, 0}, {4, 0}, {4, 4}, {2, 1}, {0, 4}};
+    context.expect(!ConvexPolygon::isConvex(dent), "accepted a concave polygon");
+}
+
+// 梳子形多边形：底边 [0, 2 * teeth - 1] x [0, 1] 上有 teeth 个高为 height 的齿，共 4 * teeth 个顶点
+// 每个齿的竖边跨越几乎整个 y 范围，按边数分桶时每条长边都要复制到所有桶中
+static std::vector<Point> comb(int teeth, double height) {
+    std::vector<Point> polygon = {Point(0, 0), Point(2 * teeth - 1, 0)};
+    for (int k = teeth - 1; k >= 0; k--) {
+        polygon.push_back(Point(2 * k + 1, height));
+        polygon.push_back(Point(2 * k, height));
+        if (k > 0) {
+            polygon.push_back(Point(2 * k, 1));
+            polygon.push_back(Point(2 * k - 1, 1));
+        }
+    }
+    return polygon;
+}
+
+// 预处理后的查询与逐边检查的结果相同
+static void comparePrepared(Context& context, Rng& rng, const std::vector<Point>& polygon, const std::string& name,
+                            double maxX, double maxY, int queries) {
+    PointInPolygon::PreparedPolygon prepared(polygon);
+    PointSet points;
+    for (int q = 0; q < queries; q++) {
+        // 一半的查询在整数坐标上，落在顶点和边上
+        if (q % 2 == 0) points.push_back(Point(rng.below(static_cast<int>(maxX) + 3) - 1, rng.below(static_cast<int>(maxY) + 3) - 1));
+        else points.push_back(Point(rng.uniform(-1, maxX + 1), rng.uniform(-1, maxY + 1)));
+    }
+    std::vector<uint8_t> batch(points.size());
+    PointInPolygon::isPointInPolygonWindingNumber(points.view(), polygon, batch.data(), 0);
+    // 批量光线投射分别从按列存放的视图和 Point 数组读取点
+    std::vector<Point> array(points.size());
+    for (size_t q = 0; q < points.size(); q++) array[q] = points.view()[q];
+    std::vector<uint8_t> columns(points.size()), rows(points.size());
+    PointInPolygon::classifyPoints(points.view(), polygon, columns.data(), 0);
+    PointInPolygon::classifyPoints(array.data(), array.size(), polygon, rows.data());
+    size_t wrong = 0;
+    for (size_t q = 0; q < points.size(); q++) {
+        Point p = points.view()[q];
+        bool ray = PointInPolygon::isPointInPolygonRayCasting(p, polygon);
+        bool winding = PointInPolygon::isPointInPolygonWindingNumber(p, polygon);
+        if (prepared.containsRayCasting(p) != ray || prepared.containsWindingNumber(p) != winding || batch[q] != winding) wrong++;
+        else if ((columns[q] != PointInPolygon::Outside) != ray || rows[q] != columns[q]) wrong++;
+    }
+    context.expect(wrong == 0, name + ": " + std::to_string(wrong) + " queries differ from the unprepared functions");
+}
+
+static void checkPreparedPolygon(Context& context, Rng& rng) {
+    // 随机星形多边形，顶点在整数坐标上
+    for (int trial = 0; trial < 300; trial++) {
+        int n = 3 + rng.below(30);
+        std::vector<Point> polygon;
+        for (int i = 0; i < n; i++) {
+            double angle = 2 * M_PI * i / n;
+            double radius = 2 + rng.below(9);
+            polygon.push_back(Point(std::round(10 + radius * std::cos(angle)), std::round(10 + radius * std::sin(angle))));
+        }
+        comparePrepared(context, rng, polygon, "star " + std::to_string(trial), 20, 20, 100);
+    }
+
+    // 4 万个顶点的梳子形，以前按边数分桶需要 O(n^2) 内存
+    std::vector<Point> teeth = comb(10000, 1000);
+    comparePrepared(context, rng, teeth, "comb", 20000, 1000, 200);
+    // 查询很少时批量版本不预处理多边形
+    comparePrepared(context, rng, teeth, "comb, few queries", 20000, 1000, 10);
+}
+
+void checkPointInPolygon(Context& context) {
+    Rng rng(11);
+    if (context.enabled("PreparedPolygon")) checkPreparedPolygon(context, rng);
+    if (context.enabled("ConvexPolygon")) checkConvexPolygon(context, rng);
+}
+
+} // namespace check
@@ -0,0 +1,132 @@
+#include "check.h"
+#include "PointInPolygon.h"
+#include "PointLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace check {
+
+// G x G 网格上随机放置单位正方形、两个三角形、1 x 2 的长方形或空洞，多边形方向随机
+static std::vector<std::vector<Point>> randomTiling(Rng& rng, int G) {
+    std::vector<std::vector<Point>> polygons;
+    std::vector<std::vector<bool>> used(G, std::vector<bool>(G, false));
+    for (int y = 0; y < G; y++) {
+        for (int x = 0; x < G; x++) {
+            if (used[y][x]) continue;
+            used[y][x] = true;
+            int kind = rng.below(10);
+            if (kind < 2 && x + 1 < G && !used[y][x + 1]) {
+                used[y][x + 1] = true;
+                polygons.push_back({Point(x, y), Point(x + 2, y), Point(x + 2, y + 1), Point(x, y + 1)});
+            } else if (kind < 4) {
+                polygons.push_back({Point(x, y), Point(x + 1, y), Point(x + 1, y + 1)});
+                polygons.push_back({Point(x, y), Point(x + 1, y + 1), Point(x, y + 1)});
+            } else if (kind >= 5) {
+                polygons.push_back({Point(x, y), Point(x + 1, y), Point(x + 1, y + 1), Point(x, y + 1)});
+            }
+        }
+    }
+    for (size_t i = 0; i < polygons.size(); i++) {
+        if (rng.below(2) == 0) std::reverse(polygons[i].begin(), polygons[i].end());
+    }
+    return polygons;
+}
+
+// 损坏的文件必须抛出 std::runtime_error，不能越界、死循环或按伪造的数量分配内存
+static void checkHostileFiles(Context& context, const std::string& path) {
+    std::vector<std::vector<Point>> polygons = {{Point(0, 0), Point(2, 0), Point(1, 2)},
+                                                {Point(2, 0), Point(4, 1), Point(1, 2)}};
+    PointLocator(polygons).save(path);
+    const std::vector<char> original = readFile(path);
+    // 文件头：magic[8]、version、reserved，之后依次为 polygons、slabs、roots、edges、nodes 五个 uint64
+    const size_t nodesField = 16 + 4 * 8, nodeSize = 3 * sizeof(int32_t);
+
+    std::vector<std::pair<std::string, std::vector<char>>> cases;
+    std::vector<char> bytes = original;
+    bytes.pop_back();
+    cases.push_back(std::make_pair("truncated", bytes));
+    bytes = original;
+    bytes.push_back(0);
+    cases.push_back(std::make_pair("trailing byte", bytes));
+    bytes = original;
+    uint64_t huge = INT32_MAX;
+    memcpy(&bytes[nodesField], &huge, sizeof(huge));
+    cases.push_back(std::make_pair("huge node count", bytes));
+    bytes = original;
+    huge = 1ull << 40;
+    memcpy(&bytes[16 + 8], &huge, sizeof(huge));
+    cases.push_back(std::make_pair("huge slab count", bytes));
+    // 最后一个节点的左子节点指向自己，第一个节点的右子节点指向最后一个节点
+    uint64_t nodeCount;
+    memcpy(&nodeCount, &original[nodesField], sizeof(nodeCount));
+    int32_t last = static_cast<int32_t>(nodeCount - 1);
+    bytes = original;
+    memcpy(&bytes[bytes.size() - nodeSize + sizeof(int32_t)], &last, sizeof(last));
+    cases.push_back(std::make_pair("self loop", bytes));
+    bytes = original;
+    memcpy(&bytes[bytes.size() - nodeCount * nodeSize + 2 * sizeof(int32_t)], &last, sizeof(last));
+    cases.push_back(std::make_pair("forward child", bytes));
+
+    for (size_t i = 0; i < cases.size(); i++) {
+        writeFile(path, cases[i].second);
+        bool rejected = false;
+        try {
+            PointLocator::load(path);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        context.expect(rejected, "hostile file accepted: " + cases[i].first);
+    }
+    writeFile(path, original);
+    context.expect(PointLocator::load(path).locate(1, 0.5) == 0, "unmodified file rejected");
+}
+
+void checkPointLocator(Context& context) {
+    if (!context.enabled("PointLocator")) return;
+    Rng rng(13);
+    const std::string path = "check_point_locator.bin";
+    for (int trial = 0; trial < 150; trial++) {
+        int G = 1 + rng.below(10);
+        std::vector<std::vector<Point>> polygons = randomTiling(rng, G);
+        PointLocator locator(polygons);
+        if (trial % 10 == 0) {
+            locator.save(path);
+            locator = PointLocator::load(path);
+        }
+
+        PointSet queries;
+        for (int q = 0; q < 300; q++) {
+            double x = rng.uniform(-1, G + 1), y = rng.uniform(-1, G + 1);
+            // 三分之一的查询落在网格线或顶点上
+            if (q % 3 == 0) {
+                x = std::floor(x * 2) / 2;
+                y = std::floor(y * 2) / 2;
+            }
+            queries.push_back(Point(x, y));
+        }
+        std::vector<int> batch(queries.size());
+        locator.locate(queries.view(), batch.data(), trial % 2 == 0 ? 1 : 0);
+
+        // 边界上的点可以属于任何一个以它为边界的多边形
+        for (size_t q = 0; q < queries.size(); q++) {
+            Point p = queries.view()[q];
+            std::vector<int> containing;
+            for (size_t k = 0; k < polygons.size(); k++) {
+                if (PointInPolygon::isPointInPolygonRayCasting(p, polygons[k])) containing.push_back(static_cast<int>(k));
+            }
+            int found = locator.locate(p);
+            bool ok = containing.empty() ? found == PointLocator::NONE
+                                         : std::find(containing.begin(), containing.end(), found) != containing.end();
+            context.expect(ok && batch[q] == found, "trial " + std::to_string(trial) + ": query (" + std::to_string(p.x) +
+                                                        ", " + std::to_string(p.y) + ") -> " + std::to_string(found));
+        }
+    }
+    checkHostileFiles(context, path);
+    remove(path.c_str());
+}
+
+} // namespace check
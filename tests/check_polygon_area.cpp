@@ -0,0 +1,75 @@
+#include "check.h"
+#include "polygonArea.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace check {
+
+// 以 UTM 量级的 (cx, cy) 为中心的星形多边形，逆时针排列，ccw 为 false 时反转
+// 相邻顶点的角度差小于 pi，中心在多边形内，方向由顶点顺序决定
+static std::vector<Point> randomPolygon(Rng& rng, size_t n, double cx, double cy, bool ccw) {
+    std::vector<Point> polygon(n);
+    for (size_t i = 0; i < n; i++) {
+        double angle = 2 * M_PI * (i + rng.uniform(0, 0.4)) / n;
+        double r = rng.uniform(200, 1000);
+        polygon[i] = Point(cx + r * std::cos(angle), cy + r * std::sin(angle));
+    }
+    if (!ccw) std::reverse(polygon.begin(), polygon.end());
+    return polygon;
+}
+
+// polygonAreas 的各个内核（标量、SSE2、AVX2）和按顶点数分块的并行路径与标量的 polygonArea 一致，符号由方向决定
+// 坐标在 UTM 量级（数十万到数百万米），多边形只有几百米大小，平移到第一个顶点前直接相乘会丢失大部分有效数字
+void checkPolygonAreas(Context& context) {
+    if (!context.enabled("polygonAreas")) return;
+    Rng rng(15);
+
+    // 顶点数跨过 SHORT_POLYGON（16）和向量宽度的边界，另有两个超过 65536 个顶点的多边形，总顶点数足以分成多块
+    std::vector<size_t> sizes = {0, 1, 2, 3, 4, 5, 15, 16, 17, 18, 19, 20, 21, 63, 64, 65, 1000, 70000, 4097, 100000};
+    for (int i = 0; i < 3000; i++) sizes.push_back(3 + rng.below(60));
+    std::vector<double> xs, ys;
+    std::vector<size_t> offsets(1, 0);
+    std::vector<double> expected;
+    std::vector<int> orientation;
+    for (size_t k = 0; k < sizes.size(); k++) {
+        bool ccw = rng.below(2) == 0;
+        std::vector<Point> polygon = randomPolygon(rng, sizes[k], rng.uniform(3e5, 8e5), rng.uniform(1e6, 9e6), ccw);
+        for (size_t i = 0; i < polygon.size(); i++) {
+            xs.push_back(polygon[i].x);
+            ys.push_back(polygon[i].y);
+        }
+        offsets.push_back(xs.size());
+        expected.push_back(polygonArea(polygon));
+        orientation.push_back(polygon.size() < 3 ? 0 : ccw ? 1 : -1);
+    }
+    size_t count = sizes.size();
+
+    const simd::Level levels[] = {simd::Scalar, simd::SSE2, simd::AVX2};
+    const char* levelNames[] = {"scalar", "SSE2", "AVX2"};
+    const int threads[] = {1, 3, 0};
+    std::vector<double> serial;
+    for (int l = 0; l < 3; l++) {
+        simd::setMaxLevel(levels[l]);
+        for (int t = 0; t < 3; t++) {
+            std::string where = std::string(levelNames[l]) + " threads " + std::to_string(threads[t]);
+            std::vector<double> areas(count, NAN);
+            polygonAreas(xs.data(), ys.data(), offsets.data(), count, areas.data(), threads[t]);
+            size_t wrong = 0, wrongSign = 0;
+            for (size_t k = 0; k < count; k++) {
+                if (!(std::fabs(std::fabs(areas[k]) - expected[k]) <= 1e-12 * expected[k])) wrong++;
+                int sign = areas[k] > 0 ? 1 : areas[k] < 0 ? -1 : 0;
+                if (sign != orientation[k]) wrongSign++;
+            }
+            context.expect(wrong == 0, where + ": " + std::to_string(wrong) + " areas differ from polygonArea");
+            context.expect(wrongSign == 0, where + ": " + std::to_string(wrongSign) + " areas with the wrong sign");
+            // 同一内核下并行与单线程的结果逐位相同
+            if (t == 0) serial = areas;
+            context.expect(areas == serial, where + ": differs from threads 1");
+        }
+    }
+    simd::setMaxLevel(simd::AVX2);
+}
+
+} // namespace check
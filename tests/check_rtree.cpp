@@ -0,0 +1,188 @@
+#include "check.h"
+#include "RTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace check {
+
+typedef RTree::Box Box;
+
+// 大多为小矩形，夹杂退化为点或线段的盒、重复的盒、空盒（min > max）和含 NaN 的盒
+static Box randomBox(Rng& rng) {
+    double x = rng.uniform(0, 100), y = rng.uniform(0, 100);
+    Box b = {x, y, x + rng.uniform(0, 6), y + rng.uniform(0, 6)};
+    int kind = rng.below(20);
+    if (kind == 0) b.maxX = b.minX;
+    if (kind == 1) b.maxY = b.minY = std::floor(y);
+    if (kind == 2) std::swap(b.minX, b.maxX);
+    if (kind == 3) b.minY = std::numeric_limits<double>::quiet_NaN();
+    if (kind == 4) b = Box{20, 20, 30, 30};
+    return b;
+}
+
+static bool validBox(const Box& b) {
+    return b.minX <= b.maxX && b.minY <= b.maxY;
+}
+
+static bool boxesIntersect(const Box& a, const Box& b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+// 与 RTree 内部相同的点到包围盒距离平方
+static double boxDistance2(const Box& b, double x, double y) {
+    double dx = std::max(std::max(b.minX - x, x - b.maxX), 0.0);
+    double dy = std::max(std::max(b.minY - y, y - b.maxY), 0.0);
+    return dx * dx + dy * dy;
+}
+
+static std::vector<int> sorted(std::vector<int> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// 批量结果的第 i 段
+static std::vector<int> slice(const std::vector<size_t>& offsets, const std::vector<int>& items, size_t i) {
+    return std::vector<int>(items.begin() + offsets[i], items.begin() + offsets[i + 1]);
+}
+
+// 最近 k 个结果：只含有效的盒，编号不重复，距离序列与线性扫描排序后的前 k 个相同（因而不减）
+static bool sameNearest(const std::vector<int>& result, const std::vector<Box>& boxes,
+                        const std::vector<double>& distances, size_t k) {
+    std::vector<double> expected;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (validBox(boxes[i])) expected.push_back(distances[i]);
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(std::min(k, expected.size()));
+    if (result.size() != expected.size()) return false;
+    std::vector<int> unique = sorted(result);
+    if (std::adjacent_find(unique.begin(), unique.end()) != unique.end()) return false;
+    for (size_t i = 0; i < result.size(); i++) {
+        if (result[i] < 0 || static_cast<size_t>(result[i]) >= boxes.size() || !validBox(boxes[result[i]])) return false;
+        if (distances[result[i]] != expected[i]) return false;
+    }
+    return true;
+}
+
+void checkRTree(Context& context) {
+    Rng rng(16);
+    const int capacities[] = {2, 3, 16, 64};
+    const size_t sizes[] = {0, 1, 7, 300, 3000};
+
+    if (context.enabled("RTree queries")) {
+        for (int c = 0; c < 4; c++) {
+            for (int s = 0; s < 5; s++) {
+                int capacity = capacities[c];
+                size_t n = sizes[s];
+                std::string where = "capacity " + std::to_string(capacity) + " n " + std::to_string(n);
+                std::vector<Box> boxes(n);
+                for (size_t i = 0; i < n; i++) boxes[i] = randomBox(rng);
+                RTree tree(boxes, capacity);
+                context.expect(tree.size() == n, where + ": size");
+
+                // 查询窗口与点，数量足以在批量查询中分成多块
+                const size_t queries = 1200;
+                std::vector<Box> windows(queries);
+                std::vector<Point> points(queries);
+                for (size_t q = 0; q < queries; q++) {
+                    windows[q] = randomBox(rng);
+                    points[q] = q % 3 == 0 && n > 0 ? Point(boxes[q % n].minX, boxes[q % n].maxY)
+                                                    : Point(rng.uniform(-5, 110), rng.uniform(-5, 110));
+                }
+
+                const int threadCounts[] = {1, 3, 0};
+                for (int t = 0; t < 3; t++) {
+                    int threads = threadCounts[t];
+                    std::string run = where + " threads " + std::to_string(threads);
+                    std::vector<size_t> windowOffsets, pointOffsets;
+                    std::vector<int> windowItems, pointItems, nearestItems;
+                    tree.queryWindows(windows, windowOffsets, windowItems, threads);
+                    tree.queryPoints(PointView(points), pointOffsets, pointItems, threads);
+                    tree.nearestPoints(PointView(points), nearestItems, threads);
+
+                    size_t wrongWindows = 0, wrongPoints = 0, wrongNearest = 0;
+                    for (size_t q = 0; q < queries; q++) {
+                        std::vector<int> inWindow, atPoint;
+                        double best = HUGE_VAL;
+                        for (size_t i = 0; i < n; i++) {
+                            if (!validBox(boxes[i])) continue;
+                            if (boxesIntersect(windows[q], boxes[i])) inWindow.push_back(static_cast<int>(i));
+                            Box point = {points[q].x, points[q].y, points[q].x, points[q].y};
+                            if (boxesIntersect(point, boxes[i])) atPoint.push_back(static_cast<int>(i));
+                            best = std::min(best, boxDistance2(boxes[i], points[q].x, points[q].y));
+                        }
+                        if (sorted(slice(windowOffsets, windowItems, q)) != inWindow) wrongWindows++;
+                        if (sorted(slice(pointOffsets, pointItems, q)) != atPoint) wrongPoints++;
+                        int id = nearestItems[q];
+                        bool nearestOk = best == HUGE_VAL ? id == -1
+                                                          : id >= 0 && boxDistance2(boxes[id], points[q].x, points[q].y) == best;
+                        if (!nearestOk) wrongNearest++;
+                    }
+                    context.expect(windowOffsets.size() == queries + 1 && wrongWindows == 0,
+                                   run + ": " + std::to_string(wrongWindows) + " wrong queryWindows results");
+                    context.expect(pointOffsets.size() == queries + 1 && wrongPoints == 0,
+                                   run + ": " + std::to_string(wrongPoints) + " wrong queryPoints results");
+                    context.expect(nearestItems.size() == queries && wrongNearest == 0,
+                                   run + ": " + std::to_string(wrongNearest) + " wrong nearestPoints results");
+                }
+
+                // 单个查询与批量查询一致
+                size_t mismatched = 0;
+                std::vector<size_t> offsets;
+                std::vector<int> items;
+                tree.queryWindows(windows, offsets, items, 1);
+                for (size_t q = 0; q < 50; q++) {
+                    std::vector<int> single;
+                    tree.queryWindow(windows[q], single);
+                    if (single != slice(offsets, items, q)) mismatched++;
+                    single.clear();
+                    tree.queryPoint(points[q].x, points[q].y, single);
+                    std::vector<int> inBox;
+                    for (size_t i = 0; i < n; i++) {
+                        Box point = {points[q].x, points[q].y, points[q].x, points[q].y};
+                        if (validBox(boxes[i]) && boxesIntersect(point, boxes[i])) inBox.push_back(static_cast<int>(i));
+                    }
+                    if (sorted(single) != inBox) mismatched++;
+                }
+                context.expect(mismatched == 0, where + ": single queries differ from the batch or the scan");
+
+                // 最近 k 个：包围盒距离，以及到盒中心的元素距离（不小于包围盒距离）
+                size_t wrongK = 0;
+                for (size_t q = 0; q < 40; q++) {
+                    double x = points[q].x, y = points[q].y;
+                    size_t k = 1 + rng.below(12);
+                    std::vector<double> boxDistances(n), centerDistances(n);
+                    for (size_t i = 0; i < n; i++) {
+                        const Box& b = boxes[i];
+                        double cx = (b.minX + b.maxX) / 2 - x, cy = (b.minY + b.maxY) / 2 - y;
+                        boxDistances[i] = boxDistance2(b, x, y);
+                        centerDistances[i] = cx * cx + cy * cy;
+                    }
+                    std::vector<int> result;
+                    tree.nearest(x, y, k, result);
+                    if (!sameNearest(result, boxes, boxDistances, k)) wrongK++;
+                    result.clear();
+                    tree.nearest(x, y, k, result, [&centerDistances](int id) { return centerDistances[id]; });
+                    if (!sameNearest(result, boxes, centerDistances, k)) wrongK++;
+                }
+                context.expect(wrongK == 0, where + ": " + std::to_string(wrongK) + " wrong nearest(k) results");
+            }
+        }
+
+        const int badCapacities[] = {1, 65};
+        for (int b = 0; b < 2; b++) {
+            bool threw = false;
+            try {
+                RTree tree(std::vector<Box>(3, Box{0, 0, 1, 1}), badCapacities[b]);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            context.expect(threw, "capacity " + std::to_string(badCapacities[b]) + " does not throw");
+        }
+    }
+}
+
+} // namespace check
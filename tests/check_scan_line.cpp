@@ -0,0 +1,142 @@
+#include "check.h"
+#include "ScaningLineAlgorythm.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace check {
+
+static std::vector<Rectangle> randomRectangles(Rng& rng, size_t n) {
+    std::vector<Rectangle> rectangles(n);
+    for (size_t i = 0; i < n; i++) {
+        int x = rng.below(2000) - 1000, y = rng.below(2000) - 1000;
+        rectangles[i] = {x, y, x + rng.below(300), y + rng.below(300)};
+    }
+    return rectangles;
+}
+
+// 流式计算与内存中的计算结果相同；块很小时段数超过归并的路数，需要多轮归并
+static void checkStreaming(Context& context, Rng& rng) {
+    std::vector<Rectangle> rectangles = randomRectangles(rng, 5000);
+    unsigned long long expected = calculateArea(rectangles);
+    const size_t chunks[] = {1, 7, 100, 5000, 1 << 20};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        unsigned long long area = calculateAreaStreaming(rectangles.begin(), rectangles.end(), chunks[c]);
+        context.expect(area == expected, "chunk " + std::to_string(chunks[c]) + ": " + std::to_string(area) +
+                                             ", expected " + std::to_string(expected));
+    }
+}
+
+// 完整的文件与内存中的计算结果相同，末尾多出不足一条记录的字节时抛出异常
+static void checkFile(Context& context, Rng& rng) {
+    const std::string path = "check_scan_line.bin";
+    std::vector<Rectangle> rectangles = randomRectangles(rng, 1000);
+    for (int extra = 0; extra < 4; extra++) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            context.expect(false, "cannot create " + path);
+            return;
+        }
+        fwrite(rectangles.data(), sizeof(Rectangle), rectangles.size(), file);
+        for (int i = 0; i < extra * 4; i++) fputc(0, file);  // 0、4、8、12 个多余的字节
+        fclose(file);
+
+        bool threw = false;
+        unsigned long long area = 0;
+        try {
+            area = calculateAreaFromFile(path, 64);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (extra == 0) {
+            context.expect(!threw && area == calculateArea(rectangles), "complete file");
+        } else {
+            context.expect(threw, "truncated record with " + std::to_string(extra * 4) + " bytes accepted");
+        }
+    }
+    remove(path.c_str());
+}
+
+// 在单位网格上暴力统计面积、周长和各覆盖深度的面积；maxDepth 大于矩形个数时多出的深度为 0
+static void checkCoverage(Context& context, Rng& rng) {
+    const int G = 40;
+    for (int trial = 0; trial < 30; trial++) {
+        size_t n = 1 + static_cast<size_t>(rng.below(40));
+        std::vector<Rectangle> rectangles(n);
+        std::vector<std::vector<int>> cover(G, std::vector<int>(G, 0));
+        for (size_t i = 0; i < n; i++) {
+            int x = rng.below(G), y = rng.below(G);
+            Rectangle rect = {x, y, x + rng.below(G - x + 1), y + rng.below(G - y + 1)};
+            rectangles[i] = rect;
+            for (int cx = rect.x1; cx < rect.x2; cx++) {
+                for (int cy = rect.y1; cy < rect.y2; cy++) cover[cx][cy]++;
+            }
+        }
+        int maxDepth = 1 + rng.below(static_cast<int>(n) * 2);
+        unsigned long long area = 0, perimeter = 0;
+        std::vector<unsigned long long> depthArea(maxDepth, 0);
+        for (int cx = 0; cx < G; cx++) {
+            for (int cy = 0; cy < G; cy++) {
+                for (int k = 1; k <= maxDepth && k <= cover[cx][cy]; k++) depthArea[k - 1]++;
+                if (cover[cx][cy] == 0) continue;
+                area++;
+                perimeter += (cx == 0 || cover[cx - 1][cy] == 0) + (cx == G - 1 || cover[cx + 1][cy] == 0) +
+                             (cy == 0 || cover[cx][cy - 1] == 0) + (cy == G - 1 || cover[cx][cy + 1] == 0);
+            }
+        }
+
+        CoverageOptions options(CoverArea | CoverPerimeter | CoverDepth, maxDepth);
+        for (int threads = 1; threads >= 0; threads--) {
+            CoverageResult result = calculateCoverage(rectangles, options, threads);
+            context.expect(result.area == area && result.perimeter == perimeter && result.depthArea == depthArea,
+                           "trial " + std::to_string(trial) + ", threads " + std::to_string(threads) + ": area " +
+                               std::to_string(result.area) + "/" + std::to_string(area) + ", perimeter " +
+                               std::to_string(result.perimeter) + "/" + std::to_string(perimeter));
+        }
+    }
+}
+
+// 超过 65536 个矩形时多线程按 x 切成竖条分别扫描，结果与单线程的整体扫描相同
+// 坐标取在粗网格上，大量竖边恰好落在切分线上；少数很宽的矩形跨过多个竖条，另有面积为 0 的矩形
+static void checkSlabs(Context& context, Rng& rng) {
+    const size_t sizes[] = {70000, 132000};
+    for (int s = 0; s < 2; s++) {
+        std::vector<Rectangle> rectangles(sizes[s]);
+        for (size_t i = 0; i < rectangles.size(); i++) {
+            int x = rng.below(4000) * 10 - 20000, y = rng.below(4000) * 10 - 20000;
+            int w = rng.below(100) == 0 ? rng.below(40000) : rng.below(30) * 10;
+            rectangles[i] = {x, y, x + w, y + rng.below(30) * 10};
+        }
+        std::string where = std::to_string(rectangles.size()) + " rectangles";
+        unsigned long long area = calculateArea(rectangles, 1);
+        CoverageOptions options(CoverArea | CoverPerimeter | CoverDepth, 6);
+        CoverageResult expected = calculateCoverage(rectangles, options, 1);
+        context.expect(expected.area == area, where + ": calculateCoverage area " + std::to_string(expected.area) +
+                                                  ", calculateArea " + std::to_string(area));
+
+        const int threads[] = {3, 0};
+        for (int t = 0; t < 2; t++) {
+            std::string run = where + ", threads " + std::to_string(threads[t]);
+            unsigned long long parallelArea = calculateArea(rectangles, threads[t]);
+            context.expect(parallelArea == area, run + ": area " + std::to_string(parallelArea) + ", expected " +
+                                                     std::to_string(area));
+            CoverageResult result = calculateCoverage(rectangles, options, threads[t]);
+            context.expect(result.area == expected.area && result.perimeter == expected.perimeter &&
+                               result.depthArea == expected.depthArea,
+                           run + ": coverage area " + std::to_string(result.area) + "/" + std::to_string(expected.area) +
+                               ", perimeter " + std::to_string(result.perimeter) + "/" +
+                               std::to_string(expected.perimeter));
+        }
+    }
+}
+
+void checkScanLine(Context& context) {
+    Rng rng(19);
+    if (context.enabled("calculateCoverage")) checkCoverage(context, rng);
+    if (context.enabled("calculateArea slabs")) checkSlabs(context, rng);
+    if (context.enabled("calculateAreaStreaming")) checkStreaming(context, rng);
+    if (context.enabled("calculateAreaFromFile")) checkFile(context, rng);
+}
+
+} // namespace check
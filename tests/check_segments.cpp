@@ -0,0 +1,134 @@
+#include "check.h"
+#include "LineSegmentIntersection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace check {
+
+using LineSegmentIntersection::Segment;
+
+// 小整数坐标上大量共线、重合、端点相接和竖直的线段
+static Segment randomSegment(Rng& rng, int mode) {
+    Segment s;
+    if (mode == 0) {
+        s.a = Point(rng.below(6), rng.below(6));
+        s.b = Point(rng.below(6), rng.below(6));
+    } else if (mode == 1) {
+        s.a = Point(rng.uniform(0, 1), rng.uniform(0, 1));
+        s.b = Point(rng.uniform(0, 1), rng.uniform(0, 1));
+    } else {
+        int x = rng.below(5), y = rng.below(5);
+        int kind = rng.below(3);
+        s.a = Point(x, y);
+        if (kind == 0) s.b = Point(x, rng.below(5));
+        else if (kind == 1) s.b = Point(rng.below(5), y);
+        else s.b = Point(x + rng.below(3), y + rng.below(3));
+    }
+    return s;
+}
+
+// 两两判断得到的相交线段对
+static std::set<std::pair<int, int>> intersectingPairs(const std::vector<Segment>& segments) {
+    std::set<std::pair<int, int>> pairs;
+    for (size_t i = 0; i < segments.size(); i++) {
+        for (size_t j = i + 1; j < segments.size(); j++) {
+            const Segment& s = segments[i];
+            const Segment& t = segments[j];
+            if (LineSegmentIntersection::segmentsIntersect(s.a, s.b, t.a, t.b)) pairs.insert(std::make_pair(int(i), int(j)));
+        }
+    }
+    return pairs;
+}
+
+// 点到线段的距离
+static double distanceToSegment(const Point& p, const Segment& s) {
+    double dx = s.b.x - s.a.x, dy = s.b.y - s.a.y;
+    double length = dx * dx + dy * dy;
+    double t = length > 0 ? ((p.x - s.a.x) * dx + (p.y - s.a.y) * dy) / length : 0;
+    t = std::min(1.0, std::max(0.0, t));
+    return std::hypot(p.x - (s.a.x + t * dx), p.y - (s.a.y + t * dy));
+}
+
+void checkSegments(Context& context) {
+    Rng rng(3);
+    if (context.enabled("findAllIntersections")) {
+        for (int trial = 0; trial < 1500; trial++) {
+            int n = 1 + rng.below(30);
+            std::vector<Segment> segments;
+            for (int i = 0; i < n; i++) segments.push_back(randomSegment(rng, trial % 3));
+
+            std::set<std::pair<int, int>> expected = intersectingPairs(segments), found;
+            std::vector<LineSegmentIntersection::IntersectionPair> pairs =
+                LineSegmentIntersection::findAllIntersections(segments);
+            for (size_t k = 0; k < pairs.size(); k++) {
+                int i = std::min(pairs[k].first, pairs[k].second), j = std::max(pairs[k].first, pairs[k].second);
+                found.insert(std::make_pair(i, j));
+            }
+            context.expect(found == expected && found.size() == pairs.size(),
+                           "trial " + std::to_string(trial) + ": " + std::to_string(pairs.size()) + " pairs, expected " +
+                               std::to_string(expected.size()));
+        }
+    }
+
+    // 远离原点时交点舍入后不在线段上，扫描线的顺序与交换必须仍然正确；报告的交点须在两条线段上
+    if (context.enabled("findAllIntersections offset")) {
+        const double offsets[] = {1e6, 3e7};
+        for (int trial = 0; trial < 16; trial++) {
+            double offset = offsets[trial % 2];
+            int n = 200 + rng.below(201);
+            std::vector<Segment> segments(n);
+            for (int i = 0; i < n; i++) {
+                if (trial % 4 < 2) {
+                    segments[i].a = Point(offset + rng.uniform(0, 10), offset + rng.uniform(0, 10));
+                    segments[i].b = Point(offset + rng.uniform(0, 10), offset + rng.uniform(0, 10));
+                } else {
+                    Segment s = randomSegment(rng, 0);
+                    segments[i].a = Point(offset + s.a.x, offset + s.a.y);
+                    segments[i].b = Point(offset + s.b.x, offset + s.b.y);
+                }
+            }
+
+            std::set<std::pair<int, int>> expected = intersectingPairs(segments), found;
+            std::vector<LineSegmentIntersection::IntersectionPair> pairs =
+                LineSegmentIntersection::findAllIntersections(segments);
+            double tolerance = 1e-12 * offset;
+            int offSegment = 0;
+            for (size_t k = 0; k < pairs.size(); k++) {
+                found.insert(std::make_pair(pairs[k].first, pairs[k].second));
+                const Point& q = pairs[k].point;
+                if (distanceToSegment(q, segments[pairs[k].first]) > tolerance ||
+                    distanceToSegment(q, segments[pairs[k].second]) > tolerance) {
+                    offSegment++;
+                }
+            }
+            context.expect(found == expected && found.size() == pairs.size(),
+                           "offset trial " + std::to_string(trial) + ": " + std::to_string(pairs.size()) +
+                               " pairs, expected " + std::to_string(expected.size()));
+            context.expect(offSegment == 0, "offset trial " + std::to_string(trial) + ": " + std::to_string(offSegment) +
+                                                " points not on both segments");
+        }
+    }
+
+    if (context.enabled("segmentsIntersect batch")) {
+        const size_t n = 20000;
+        std::vector<Segment> first(n), second(n);
+        for (size_t i = 0; i < n; i++) {
+            first[i] = randomSegment(rng, i % 3);
+            second[i] = randomSegment(rng, i % 3);
+        }
+        std::vector<uint8_t> serial(n), parallel(n);
+        LineSegmentIntersection::segmentsIntersect(first.data(), second.data(), n, serial.data(), 1);
+        LineSegmentIntersection::segmentsIntersect(first.data(), second.data(), n, parallel.data(), 0);
+        size_t wrong = 0;
+        for (size_t i = 0; i < n; i++) {
+            bool single = LineSegmentIntersection::segmentsIntersect(first[i].a, first[i].b, second[i].a, second[i].b);
+            if (serial[i] != single || parallel[i] != single) wrong++;
+        }
+        context.expect(wrong == 0, std::to_string(wrong) + " results differ from the single-pair function");
+    }
+}
+
+} // namespace check
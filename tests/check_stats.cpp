@@ -0,0 +1,61 @@
+#include "check.h"
+#include "ScaningLineAlgorythm.h"
+#include "delaunay.h"
+#include "stats.h"
+
+namespace check {
+
+static bool allZero(const stats::Stats& s) {
+    for (int i = 0; i < stats::COUNTER_COUNT; i++) {
+        if (s.counters[i] != 0) return false;
+    }
+    for (int i = 0; i < stats::TIMER_COUNT; i++) {
+        if (s.timerCalls[i] != 0 || s.timerNanoseconds[i] != 0) return false;
+    }
+    return true;
+}
+
+// 开启统计时一次 Delaunay 剖分和 calculateArea 使相应的计数器和计时器增加，线程池中的任务也计入；
+// 关闭时打点为空操作，所有统计始终为 0
+// ctest 中的 check_stats 以 GEOM_ENABLE_STATS 编译库和检查程序，只运行这一项
+void checkStats(Context& context) {
+    if (!context.enabled("stats")) return;
+    Rng rng(18);
+    std::vector<Point> points;
+    for (int i = 0; i < 3000; i++) points.push_back(Point(rng.uniform(0, 1000), rng.uniform(0, 1000), i));
+    std::vector<Rectangle> rectangles(70000);
+    for (size_t i = 0; i < rectangles.size(); i++) {
+        int x = rng.below(10000), y = rng.below(10000);
+        rectangles[i] = {x, y, x + 1 + rng.below(100), y + 1 + rng.below(100)};
+    }
+
+    const int threads[] = {1, 3};
+    for (int t = 0; t < 2; t++) {
+        std::string where = "threads " + std::to_string(threads[t]);
+        stats::Stats before = stats::collect();
+        Delaunay delaunay;
+        delaunay.init(points, threads[t], 256);
+        calculateArea(rectangles, threads[t]);
+        stats::Stats delta = stats::collect() - before;
+
+        if (!stats::enabled()) {
+            context.expect(allZero(delta) && allZero(stats::collect()), where + ": statistics recorded while disabled: " +
+                                                                           delta.toJson());
+            continue;
+        }
+        context.expect(delta.counters[stats::DelaunayInCircle] > 0 && delta.counters[stats::DelaunayMergeSteps] > 0 &&
+                           delta.counters[stats::DelaunayHullWalkSteps] > 0,
+                       where + ": Delaunay counters did not move: " + delta.toJson());
+        context.expect(delta.counters[stats::SegmentTreeUpdates] >= 2 * rectangles.size() &&
+                           delta.counters[stats::SegmentTreeNodeVisits] >= delta.counters[stats::SegmentTreeUpdates],
+                       where + ": segment tree counters: " + delta.toJson());
+        context.expect(delta.timerCalls[stats::DelaunayBuild] == 1 && delta.timerCalls[stats::CalculateArea] == 1 &&
+                           delta.timerNanoseconds[stats::DelaunayBuild] > 0 &&
+                           delta.timerNanoseconds[stats::CalculateArea] > 0,
+                       where + ": timers: " + delta.toJson());
+        context.expect(delta.counters[stats::PointInPolygonQueries] == 0 && delta.timerCalls[stats::ClassifyPoints] == 0,
+                       where + ": unrelated statistics moved: " + delta.toJson());
+    }
+}
+
+} // namespace check